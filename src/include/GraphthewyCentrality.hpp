@@ -0,0 +1,394 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_CENTRALITY_HPP_
+#define _GRAPH_MODEL_CENTRALITY_HPP_
+
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyGenerator.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Centralities based on the shortest paths (betweenness, closeness,
+ * harmonic) of a snapshot, from a breadth-first search of each source.
+ * The sources are shared between the threads, each thread keeping its
+ * own search arrays and its own sums, added together at the end: the
+ * threads never write the same memory. Weights are not used, every link
+ * counting for 1; in a directed graph, the paths follow the arcs.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ * - R = the type of the scores, float or double (default)
+ */
+template<equality_comparable T, class W = void, class R = double>
+struct GraphCentrality {
+
+    /**
+     * Constructor
+     * 
+     * @param snapshot The snapshot of the graph
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    GraphCentrality(const GraphSnapshot<T, W>& snapshot, unsigned int threadCount = 0)
+    : snapshot_(snapshot), threadCount_(threadCount==0 ? defaultThreadCount() : threadCount), sampleCount_(0) { }
+
+    /**
+     * Betweenness centrality with Brandes' algorithm: the number of
+     * shortest paths between two other vertices going through each
+     * vertex, each pair counting for 1 split between its shortest
+     * paths. O(order * arcs) time.
+     * 
+     * @param normalized true to divide by the number of pairs of other vertices
+     */
+    void betweenness(bool normalized = false) {
+        GRAPHTHEWY_STATS_TIMER(timer, "betweenness");
+        const std::size_t n = snapshot_.order();
+        sampleCount_ = n;
+        accumulate(n, [](std::size_t i) { return static_cast<VertexId>(i); }, R(1));
+        scale(normalized);
+        GRAPHTHEWY_STATS_VISIT(timer, n * n, n * snapshot_.arcCount());
+    }
+
+    /**
+     * Approximate betweenness centrality, from sampleCount sources drawn
+     * uniformly (with replacement) instead of all of them, each weighing
+     * order() / sampleCount. See errorBound() for the accuracy; with
+     * sampleCount >= order(), the exact betweenness is computed.
+     * 
+     * @param sampleCount The number of sources, see sampleCountFor()
+     * @param seed The seed of the draws
+     * @param normalized true to divide by the number of pairs of other vertices
+     */
+    void approximateBetweenness(std::size_t sampleCount, std::uint64_t seed = 0, bool normalized = false) {
+        const std::size_t n = snapshot_.order();
+        if( sampleCount>=n ) {
+            betweenness(normalized);
+            return;
+        }
+        if( sampleCount==0 ) {
+            throw std::runtime_error("graphthewy: approximate betweenness needs at least one sample");
+        }
+        GRAPHTHEWY_STATS_TIMER(timer, "approximateBetweenness");
+        sampleCount_ = sampleCount;
+        accumulate(sampleCount, [&](std::size_t i) { return static_cast<VertexId>(counterBelow(seed, i, 0, n)); },
+                   static_cast<R>(n) / static_cast<R>(sampleCount));
+        scale(normalized);
+        GRAPHTHEWY_STATS_VISIT(timer, sampleCount * n, sampleCount * snapshot_.arcCount());
+    }
+
+    /**
+     * Accuracy of the last betweenness, from Hoeffding's inequality: the
+     * dependency of a vertex on a source is between 0 and order() - 2, so
+     * that with k sources the normalized betweenness of every vertex is
+     * off by at most order() / (order() - 1) * sqrt(ln(2 order() / (1 -
+     * confidence)) / 2k), all the vertices at once, with the probability
+     * confidence.
+     * 
+     * @param confidence The probability that the bound holds, below 1
+     * @return the bound on the error of the normalized betweenness, 0 if it is exact
+     */
+    double errorBound(double confidence = 0.95) const {
+        const std::size_t n = snapshot_.order();
+        if( sampleCount_>=n || n<3 ) {
+            return 0.0;
+        }
+        const double nd = static_cast<double>(n);
+        return nd / (nd - 1.0) * std::sqrt(std::log(2.0 * nd / (1.0 - confidence)) / (2.0 * static_cast<double>(sampleCount_)));
+    }
+
+    /**
+     * Number of sources for errorBound() to be at most epsilon.
+     * 
+     * @param epsilon The bound on the error of the normalized betweenness
+     * @param confidence The probability that the bound holds, below 1
+     * @return the number of samples to give to approximateBetweenness()
+     */
+    std::size_t sampleCountFor(double epsilon, double confidence = 0.95) const {
+        const double nd = static_cast<double>(snapshot_.order());
+        const double e = epsilon * (nd - 1.0) / nd;
+        return static_cast<std::size_t>(std::ceil(std::log(2.0 * nd / (1.0 - confidence)) / (2.0 * e * e)));
+    }
+
+    /**
+     * Closeness centrality: the inverse of the average distance from a
+     * vertex to the vertices it reaches, times the fraction of the other
+     * vertices it reaches (Wasserman and Faust), so that the vertices of
+     * a small component do not score high. 0 for a vertex reaching none.
+     */
+    void closeness() {
+        GRAPHTHEWY_STATS_TIMER(timer, "closeness");
+        const std::size_t n = snapshot_.order();
+        distances([n](const Workspace& ws) {
+            const std::size_t reached = ws.orderVector_.size();
+            std::size_t total = 0;
+            for(const VertexId v : ws.orderVector_) {
+                total += ws.distanceVector_[v];
+            }
+            if( total==0 ) {
+                return R(0);
+            }
+            const R r = static_cast<R>(reached - 1);
+            return r / static_cast<R>(total) * r / static_cast<R>(n - 1);
+        });
+        GRAPHTHEWY_STATS_VISIT(timer, n * n, n * snapshot_.arcCount());
+    }
+
+    /**
+     * Harmonic centrality: the sum of the inverses of the distances from
+     * a vertex to the others, an unreachable vertex adding 0.
+     */
+    void harmonic() {
+        GRAPHTHEWY_STATS_TIMER(timer, "harmonic");
+        distances([](const Workspace& ws) {
+            R total = 0;
+            for(std::size_t i=1; i<ws.orderVector_.size(); i++) {
+                total += R(1) / static_cast<R>(ws.distanceVector_[ws.orderVector_[i]]);
+            }
+            return total;
+        });
+        GRAPHTHEWY_STATS_VISIT(timer, snapshot_.order() * snapshot_.order(), snapshot_.order() * snapshot_.arcCount());
+    }
+
+    /**
+     * Score of a vertex, after betweenness(), approximateBetweenness(),
+     * closeness() or harmonic().
+     * 
+     * @param label the vertex's label
+     * @return the score
+     */
+    R score(const T& label) const
+    { return scoreVector_[snapshot_.idOf(label)]; }
+
+    /**
+     * Scores, by vertex identifier.
+     * 
+     * @return the vector of scores
+     */
+    const std::vector<R>& scoreVector() const
+    { return scoreVector_; }
+
+
+protected:
+
+    /**
+     * Distance of the vertices not reached.
+     */
+    static constexpr std::uint32_t noDistance = std::numeric_limits<std::uint32_t>::max();
+
+    /**
+     * Arrays of the searches of a thread, allocated once.
+     */
+    struct Workspace {
+
+        /**
+         * Distance from the source, by vertex identifier.
+         */
+        std::vector<std::uint32_t>
+        distanceVector_;
+
+        /**
+         * Number of shortest paths from the source, by vertex identifier.
+         */
+        std::vector<double>
+        pathCountVector_;
+
+        /**
+         * Dependency of the source on each vertex.
+         */
+        std::vector<R>
+        dependencyVector_;
+
+        /**
+         * Vertices reached, by increasing distance.
+         */
+        std::vector<VertexId>
+        orderVector_;
+
+        /**
+         * Sum of the dependencies of the sources of the thread.
+         */
+        std::vector<R>
+        sumVector_;
+
+    };
+
+    /**
+     * Breadth-first search from a source, counting the shortest paths.
+     * Only the entries of the vertices reached by the previous search are
+     * reset.
+     * 
+     * @param s the source
+     * @param ws The arrays of the thread
+     */
+    void search(VertexId s, Workspace& ws) const {
+        for(const VertexId v : ws.orderVector_) {
+            ws.distanceVector_[v] = noDistance;
+            ws.pathCountVector_[v] = 0.0;
+        }
+        ws.orderVector_.clear();
+        ws.distanceVector_[s] = 0;
+        ws.pathCountVector_[s] = 1.0;
+        ws.orderVector_.push_back(s);
+        for(std::size_t head=0; head<ws.orderVector_.size(); head++) {
+            const VertexId u = ws.orderVector_[head];
+            const std::uint32_t next = ws.distanceVector_[u] + 1;
+            for(const VertexId v : snapshot_.neighbors(u)) {
+                if( ws.distanceVector_[v]==noDistance ) {
+                    ws.distanceVector_[v] = next;
+                    ws.orderVector_.push_back(v);
+                }
+                if( ws.distanceVector_[v]==next ) {
+                    ws.pathCountVector_[v] += ws.pathCountVector_[u];
+                }
+            }
+        }
+    }
+
+    /**
+     * @return one workspace per thread, sized for the snapshot
+     */
+    std::vector<Workspace> workspaces() const {
+        std::vector<Workspace> workspaceVector(threadCount_);
+        for(auto& ws : workspaceVector) {
+            ws.distanceVector_.assign(snapshot_.order(), noDistance);
+            ws.pathCountVector_.assign(snapshot_.order(), 0.0);
+        }
+        return workspaceVector;
+    }
+
+    /**
+     * Brandes' accumulation: after the search of a source, the vertices
+     * are taken by decreasing distance, each adding up the dependencies
+     * of its successors on the shortest paths (arcs to a vertex one step
+     * further), so that no list of predecessors is kept.
+     * 
+     * @param sourceCount The number of sources
+     * @param sourceOf The i-th source
+     * @param factor The weight of each source
+     */
+    template<class F>
+    void accumulate(std::size_t sourceCount, F&& sourceOf, R factor) {
+        const std::size_t n = snapshot_.order();
+        std::vector<Workspace> workspaceVector = workspaces();
+        for(auto& ws : workspaceVector) {
+            ws.dependencyVector_.assign(n, R(0));
+            ws.sumVector_.assign(n, R(0));
+        }
+        parallelDynamic(sourceCount, threadCount_, [&](unsigned int c, std::size_t i) {
+            Workspace& ws = workspaceVector[c];
+            const VertexId s = sourceOf(i);
+            search(s, ws);
+            for(std::size_t k=ws.orderVector_.size(); k-->0; ) {
+                const VertexId v = ws.orderVector_[k];
+                const std::uint32_t next = ws.distanceVector_[v] + 1;
+                R dependency = 0;
+                for(const VertexId w : snapshot_.neighbors(v)) {
+                    if( ws.distanceVector_[w]==next ) {
+                        dependency += static_cast<R>(ws.pathCountVector_[v] / ws.pathCountVector_[w]) * (R(1) + ws.dependencyVector_[w]);
+                    }
+                }
+                ws.dependencyVector_[v] = dependency;
+                if( v!=s ) {
+                    ws.sumVector_[v] += dependency;
+                }
+            }
+        }, 1);
+        scoreVector_.assign(n, R(0));
+        parallelChunks(n, threadCount_, [&](unsigned int, std::size_t begin, std::size_t end) {
+            for(std::size_t v=begin; v<end; v++) {
+                R total = 0;
+                for(const auto& ws : workspaceVector) {
+                    total += ws.sumVector_[v];
+                }
+                scoreVector_[v] = total * factor;
+            }
+        });
+    }
+
+    /**
+     * Betweenness from the sums of dependencies: halved in an undirected
+     * graph, where each pair is counted from both ends, and normalized on
+     * demand. Normalized, both cases come down to dividing the sums by
+     * the number of ordered pairs of other vertices.
+     * 
+     * @param normalized true to divide by the number of pairs of other vertices
+     */
+    void scale(bool normalized) {
+        const std::size_t n = snapshot_.order();
+        R factor = snapshot_.isDirected() ? R(1) : R(0.5);
+        if( normalized && n>2 ) {
+            factor = R(1) / (static_cast<R>(n - 1) * static_cast<R>(n - 2));
+        }
+        for(R& s : scoreVector_) {
+            s *= factor;
+        }
+    }
+
+    /**
+     * Score of each vertex from the distances of a search from it.
+     * 
+     * @param f The score of the source of a search
+     */
+    template<class F>
+    void distances(F&& f) {
+        const std::size_t n = snapshot_.order();
+        std::vector<Workspace> workspaceVector = workspaces();
+        scoreVector_.assign(n, R(0));
+        parallelDynamic(n, threadCount_, [&](unsigned int c, std::size_t s) {
+            search(static_cast<VertexId>(s), workspaceVector[c]);
+            scoreVector_[s] = f(workspaceVector[c]);
+        }, 1);
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * The number of threads.
+     */
+    unsigned int
+    threadCount_;
+
+    /**
+     * Number of sources of the last betweenness.
+     */
+    std::size_t
+    sampleCount_;
+
+    /**
+     * Scores, by vertex identifier.
+     */
+    std::vector<R>
+    scoreVector_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_CENTRALITY_HPP_
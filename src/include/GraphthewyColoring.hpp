@@ -0,0 +1,344 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_COLORING_HPP_
+#define _GRAPH_MODEL_COLORING_HPP_
+
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyCores.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Order in which the greedy coloring visits the vertices.
+ */
+enum class ColoringOrder {
+    /** By identifier. */
+    Natural,
+    /** By decreasing degree (Welsh–Powell). */
+    LargestFirst,
+    /** Reverse of the order of removal of a vertex of smallest degree (Matula–Beck). */
+    SmallestLast
+};
+
+/**
+ * Vertex coloring of an undirected snapshot, so that linked vertices
+ * get different colors, and bipartiteness check. Colors are numbered
+ * from 0; self-loops are ignored by the colorings.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct GraphColoring {
+
+    /**
+     * Constructor
+     * 
+     * @param snapshot The snapshot of an undirected graph
+     */
+    GraphColoring(const GraphSnapshot<T, W>& snapshot)
+    : snapshot_(snapshot), colorCount_(0), roundCount_(0) {
+        if( snapshot_.isDirected() ) {
+            throw std::runtime_error("graphthewy: coloring needs an undirected snapshot");
+        }
+    }
+
+    /**
+     * Sequential greedy coloring: each vertex, in the given order, takes
+     * the smallest color not used by its neighbors. At most the maximum
+     * degree plus one colors are used, and the smallest-last order never
+     * uses more than the degeneracy plus one.
+     * 
+     * @param order The order of the vertices
+     * @return the number of colors
+     */
+    std::size_t greedy(ColoringOrder order = ColoringOrder::SmallestLast) {
+        GRAPHTHEWY_STATS_TIMER(timer, "greedyColoring");
+        GRAPHTHEWY_STATS_VISIT(timer, snapshot_.order(), snapshot_.arcCount());
+        const std::size_t n = snapshot_.order();
+        std::vector<VertexId> orderVector;
+        if( order==ColoringOrder::SmallestLast ) {
+            orderVector = smallestLastOrder();
+        } else {
+            orderVector.resize(n);
+            std::iota(orderVector.begin(), orderVector.end(), VertexId(0));
+            if( order==ColoringOrder::LargestFirst ) {
+                std::stable_sort(orderVector.begin(), orderVector.end(), [&](VertexId a, VertexId b) {
+                    return snapshot_.degree(a)>snapshot_.degree(b);
+                });
+            }
+        }
+        colorVector_.assign(n, noColor);
+        std::vector<std::uint64_t> forbiddenVector(maxDegree() + 2, 0);
+        std::uint64_t stamp = 0;
+        for(const VertexId v : orderVector) {
+            colorVector_[v] = firstFit(v, forbiddenVector, ++stamp, [&](VertexId u) { return colorVector_[u]; });
+        }
+        return countColors();
+    }
+
+    /**
+     * Parallel speculative coloring (Gebremedhin–Manne): the vertices
+     * left to color are colored greedily at the same time, reading the
+     * colors of their neighbors as they are, then the vertices which
+     * took the color of a neighbor of lower identifier are colored again
+     * in the next round. Uses a few more colors than greedy() in
+     * exchange for the threads.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the number of colors
+     */
+    std::size_t speculative(unsigned int threadCount = 0) {
+        GRAPHTHEWY_STATS_TIMER(timer, "speculativeColoring");
+        const std::size_t n = snapshot_.order();
+        if( threadCount==0 ) {
+            threadCount = defaultThreadCount();
+        }
+        std::vector<std::atomic<std::uint32_t>> sharedVector(n);
+        for(auto& c : sharedVector) {
+            c.store(noColor, std::memory_order_relaxed);
+        }
+        std::vector<std::vector<std::uint64_t>> forbiddenVector(threadCount, std::vector<std::uint64_t>(maxDegree() + 2, 0));
+        std::vector<std::uint64_t> stampVector(threadCount, 0);
+        std::vector<std::vector<VertexId>> conflictVector(threadCount);
+        std::vector<VertexId> workVector(n);
+        std::iota(workVector.begin(), workVector.end(), VertexId(0));
+        const auto colorOf = [&](VertexId u) { return sharedVector[u].load(std::memory_order_relaxed); };
+        roundCount_ = 0;
+        while( !workVector.empty() ) {
+            roundCount_++;
+            parallelDynamic(workVector.size(), threadCount, [&](unsigned int c, std::size_t i) {
+                const VertexId v = workVector[i];
+                sharedVector[v].store(firstFit(v, forbiddenVector[c], ++stampVector[c], colorOf), std::memory_order_relaxed);
+            });
+            parallelDynamic(workVector.size(), threadCount, [&](unsigned int c, std::size_t i) {
+                const VertexId v = workVector[i];
+                const std::uint32_t color = colorOf(v);
+                for(const VertexId u : snapshot_.neighbors(v)) {
+                    if( u<v && colorOf(u)==color ) {
+                        conflictVector[c].push_back(v);
+                        break;
+                    }
+                }
+            });
+            GRAPHTHEWY_STATS_VISIT(timer, workVector.size(), 0);
+            workVector.clear();
+            for(auto& conflicts : conflictVector) {
+                workVector.insert(workVector.end(), conflicts.begin(), conflicts.end());
+                conflicts.clear();
+            }
+        }
+        colorVector_.resize(n);
+        for(std::size_t v=0; v<n; v++) {
+            colorVector_[v] = sharedVector[v].load(std::memory_order_relaxed);
+        }
+        return countColors();
+    }
+
+    /**
+     * Check whether the graph is bipartite by a breadth-first search of
+     * each component, giving its vertices alternate colors. A self-loop
+     * makes a graph not bipartite.
+     * 
+     * @return true if the graph is bipartite, the colors (0 or 1) then being its two sides
+     */
+    bool isBipartite() {
+        GRAPHTHEWY_STATS_TIMER(timer, "bipartite");
+        GRAPHTHEWY_STATS_VISIT(timer, snapshot_.order(), snapshot_.arcCount());
+        const std::size_t n = snapshot_.order();
+        colorVector_.assign(n, noColor);
+        std::vector<VertexId> queue;
+        queue.reserve(n);
+        for(VertexId root=0; root<n; root++) {
+            if( colorVector_[root]!=noColor ) {
+                continue;
+            }
+            colorVector_[root] = 0;
+            queue.clear();
+            queue.push_back(root);
+            for(std::size_t head=0; head<queue.size(); head++) {
+                const VertexId u = queue[head];
+                for(const VertexId v : snapshot_.neighbors(u)) {
+                    if( colorVector_[v]==noColor ) {
+                        colorVector_[v] = 1 - colorVector_[u];
+                        queue.push_back(v);
+                    } else if( colorVector_[v]==colorVector_[u] ) {
+                        colorVector_.clear();
+                        colorCount_ = 0;
+                        return false;
+                    }
+                }
+            }
+        }
+        colorCount_ = n==0 ? 0 : 1 + (snapshot_.arcCount()>0 ? 1 : 0);
+        return true;
+    }
+
+    /**
+     * Color of a vertex, after a coloring.
+     * 
+     * @param label the vertex's label
+     * @return the color
+     */
+    std::uint32_t color(const T& label) const
+    { return colorVector_[snapshot_.idOf(label)]; }
+
+    /**
+     * @return the number of colors of the last coloring
+     */
+    std::size_t colorCount() const
+    { return colorCount_; }
+
+    /**
+     * @return the number of rounds of the last speculative coloring
+     */
+    std::size_t roundCount() const
+    { return roundCount_; }
+
+    /**
+     * Check that no two linked vertices share a color.
+     * 
+     * @return true if the last coloring is proper
+     */
+    bool isProper() const {
+        if( colorVector_.size()!=snapshot_.order() ) {
+            return false;
+        }
+        for(VertexId u=0; u<snapshot_.order(); u++) {
+            for(const VertexId v : snapshot_.neighbors(u)) {
+                if( v!=u && colorVector_[v]==colorVector_[u] ) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Colors of the vertices, by vertex identifier.
+     * 
+     * @return the vector of colors
+     */
+    const std::vector<std::uint32_t>& colorVector() const
+    { return colorVector_; }
+
+    /**
+     * Color of the vertices not colored yet.
+     */
+    static constexpr std::uint32_t noColor = std::numeric_limits<std::uint32_t>::max();
+
+
+protected:
+
+    /**
+     * Smallest color not taken by a neighbor of a vertex. The colors
+     * taken are marked with a stamp, so that the marks need no reset.
+     * 
+     * @param v the vertex identifier
+     * @param forbiddenVector The stamp of each forbidden color, of size maxDegree() + 2
+     * @param stamp A stamp never given before with this vector
+     * @param colorOf The current color of a vertex
+     * @return the color
+     */
+    template<class F>
+    std::uint32_t firstFit(VertexId v, std::vector<std::uint64_t>& forbiddenVector, std::uint64_t stamp, F&& colorOf) const {
+        for(const VertexId u : snapshot_.neighbors(v)) {
+            const std::uint32_t c = colorOf(u);
+            if( u!=v && c<forbiddenVector.size() ) {
+                forbiddenVector[c] = stamp;
+            }
+        }
+        std::uint32_t c = 0;
+        while( forbiddenVector[c]==stamp ) {
+            c++;
+        }
+        return c;
+    }
+
+    /**
+     * @return the maximum degree of the snapshot
+     */
+    std::size_t maxDegree() const {
+        std::size_t d = 0;
+        for(VertexId v=0; v<snapshot_.order(); v++) {
+            d = std::max(d, snapshot_.degree(v));
+        }
+        return d;
+    }
+
+    /**
+     * Smallest-last order: the reverse of the degeneracy order of the
+     * core decomposition, linear in the size of the graph.
+     * 
+     * @return the vertices, the last one removed first
+     */
+    std::vector<VertexId> smallestLastOrder() const {
+        GraphCores<T, W> cores(snapshot_);
+        cores.decompose();
+        return std::vector<VertexId>(cores.orderVector().rbegin(), cores.orderVector().rend());
+    }
+
+    /**
+     * @return the number of colors of colorVector_
+     */
+    std::size_t countColors() {
+        colorCount_ = 0;
+        for(const std::uint32_t c : colorVector_) {
+            colorCount_ = std::max<std::size_t>(colorCount_, c + 1);
+        }
+        return colorCount_;
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * Color of each vertex, by vertex identifier.
+     */
+    std::vector<std::uint32_t>
+    colorVector_;
+
+    /**
+     * Number of colors of the last coloring.
+     */
+    std::size_t
+    colorCount_;
+
+    /**
+     * Number of rounds of the last speculative coloring.
+     */
+    std::size_t
+    roundCount_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_COLORING_HPP_
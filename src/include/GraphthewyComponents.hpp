@@ -0,0 +1,413 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_COMPONENTS_HPP_
+#define _GRAPH_MODEL_COMPONENTS_HPP_
+
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Union-find structure over vertex identifiers, with path halving
+ * and union by rank.
+ */
+class DisjointSet {
+
+public:
+
+    /**
+     * Constructor, each element being alone in its set.
+     * 
+     * @param size The number of elements
+     */
+    DisjointSet(std::size_t size)
+    : parentVector_(size), rankVector_(size, 0) {
+        for(std::size_t i=0; i<size; i++) {
+            parentVector_[i] = static_cast<VertexId>(i);
+        }
+    }
+
+    /**
+     * Representative of the set of an element.
+     * 
+     * @param v the element
+     * @return the representative
+     */
+    VertexId find(VertexId v) {
+        while( parentVector_[v]!=v ) {
+            parentVector_[v] = parentVector_[parentVector_[v]];
+            v = parentVector_[v];
+        }
+        return v;
+    }
+
+    /**
+     * Merge the sets of two elements.
+     * 
+     * @param u the first element
+     * @param v the second element
+     * @return false if they were already in the same set
+     */
+    bool unite(VertexId u, VertexId v) {
+        u = find(u);
+        v = find(v);
+        if( u==v ) {
+            return false;
+        }
+        if( rankVector_[u]<rankVector_[v] ) {
+            std::swap(u, v);
+        }
+        parentVector_[v] = u;
+        if( rankVector_[u]==rankVector_[v] ) {
+            rankVector_[u]++;
+        }
+        return true;
+    }
+
+    /**
+     * @return the number of elements
+     */
+    std::size_t size() const
+    { return parentVector_.size(); }
+
+
+protected:
+
+    /**
+     * Parent of each element, the representatives being their own parent.
+     */
+    std::vector<VertexId>
+    parentVector_;
+
+    /**
+     * Upper bound of the height of each tree.
+     */
+    std::vector<std::uint8_t>
+    rankVector_;
+
+};
+
+
+/**
+ * Cycle detection in an undirected adjacency, in O(E.α(V)): a link
+ * joining two vertices already in the same component closes a cycle.
+ * A self-loop or a repeated link is a cycle.
+ * 
+ * Template argument:
+ * - S = GraphSnapshot, or any adjacency with order() and neighbors(v),
+ *       each undirected link being stored as (u, v) and (v, u)
+ * 
+ * @param adjacency The adjacency of the graph
+ * @return true if cycle is detected, false otherwise.
+ */
+template<class S>
+bool hasUndirectedCycle(const S& adjacency) {
+    DisjointSet ds(adjacency.order());
+    for(VertexId u=0; u<adjacency.order(); u++) {
+        for(const VertexId v : adjacency.neighbors(u)) {
+            if( u==v || (u<v && !ds.unite(u, v)) ) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Connected components of a snapshot. The links of a directed snapshot
+ * are taken without their direction (weakly connected components).
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct GraphComponents {
+
+    /**
+     * Constructor
+     * 
+     * @param snapshot The snapshot of the graph
+     */
+    GraphComponents(const GraphSnapshot<T, W>& snapshot)
+    : snapshot_(snapshot) { }
+
+    /**
+     * Sequential labeling, with a union-find.
+     */
+    void unionFind() {
+        GRAPHTHEWY_STATS_TIMER(timer, "unionFind");
+        GRAPHTHEWY_STATS_VISIT(timer, snapshot_.order(), snapshot_.arcCount());
+        DisjointSet ds(snapshot_.order());
+        for(VertexId u=0; u<snapshot_.order(); u++) {
+            for(const VertexId v : snapshot_.neighbors(u)) {
+                ds.unite(u, v);
+            }
+        }
+        std::vector<VertexId> parentVector(snapshot_.order());
+        for(VertexId v=0; v<snapshot_.order(); v++) {
+            parentVector[v] = ds.find(v);
+        }
+        number(parentVector);
+    }
+
+    /**
+     * Parallel labeling, with the Afforest algorithm: lock-free
+     * Shiloach-Vishkin hooking on a sample of the links (the first two
+     * of each vertex), then on the remaining links of the vertices not
+     * already in the largest component.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    void afforest(unsigned int threadCount = 0) {
+        GRAPHTHEWY_STATS_TIMER(timer, "afforest");
+        GRAPHTHEWY_STATS_VISIT(timer, snapshot_.order(), snapshot_.arcCount());
+        const std::size_t n = snapshot_.order();
+        std::vector<std::atomic<VertexId>> parentVector(n);
+        for(std::size_t v=0; v<n; v++) {
+            parentVector[v].store(static_cast<VertexId>(v), std::memory_order_relaxed);
+        }
+        const std::size_t sampleCount = 2;
+        for(std::size_t r=0; r<sampleCount; r++) {
+            parallelChunks(n, threadCount, [&](unsigned int, std::size_t begin, std::size_t end) {
+                for(std::size_t u=begin; u<end; u++) {
+                    const std::size_t a = snapshot_.offsetVector_[u] + r;
+                    if( a<snapshot_.offsetVector_[u + 1] ) {
+                        hook(parentVector, static_cast<VertexId>(u), snapshot_.targetVector_[a]);
+                    }
+                }
+            });
+            compress(parentVector, threadCount);
+        }
+        const VertexId largest = sampleLargest(parentVector);
+        // Taken before the hooks below, which may move the root largest
+        // under another vertex
+        std::vector<char> inLargestVector(n);
+        for(std::size_t v=0; v<n; v++) {
+            inLargestVector[v] = parentVector[v].load(std::memory_order_relaxed)==largest;
+        }
+        parallelChunks(n, threadCount, [&](unsigned int, std::size_t begin, std::size_t end) {
+            for(std::size_t u=begin; u<end; u++) {
+                if( inLargestVector[u] ) {
+                    continue;
+                }
+                for(std::size_t a=snapshot_.offsetVector_[u] + sampleCount; a<snapshot_.offsetVector_[u + 1]; a++) {
+                    hook(parentVector, static_cast<VertexId>(u), snapshot_.targetVector_[a]);
+                }
+            }
+        });
+        if( snapshot_.isDirected() ) {
+            // The in-links of the largest component have not been followed
+            parallelChunks(n, threadCount, [&](unsigned int, std::size_t begin, std::size_t end) {
+                for(std::size_t u=begin; u<end; u++) {
+                    if( !inLargestVector[u] ) {
+                        continue;
+                    }
+                    for(std::size_t a=snapshot_.offsetVector_[u] + sampleCount; a<snapshot_.offsetVector_[u + 1]; a++) {
+                        hook(parentVector, static_cast<VertexId>(u), snapshot_.targetVector_[a]);
+                    }
+                }
+            });
+        }
+        compress(parentVector, threadCount);
+        std::vector<VertexId> rootVector(n);
+        for(std::size_t v=0; v<n; v++) {
+            rootVector[v] = parentVector[v].load(std::memory_order_relaxed);
+        }
+        number(rootVector);
+    }
+
+    /**
+     * Cycle detection in an undirected snapshot, see hasUndirectedCycle().
+     * 
+     * @return true if cycle is detected, false otherwise.
+     */
+    bool hasCycle() const
+    { return hasUndirectedCycle(snapshot_); }
+
+    /**
+     * Number of components, after unionFind() or afforest().
+     * 
+     * @return the number of components
+     */
+    std::size_t componentCount() const
+    { return componentSizeVector_.size(); }
+
+    /**
+     * Component of a vertex, after unionFind() or afforest().
+     * 
+     * @param label the vertex's label
+     * @return the component identifier, from 0 to componentCount() - 1
+     */
+    VertexId componentOf(const T& label) const
+    { return componentVector_[snapshot_.idOf(label)]; }
+
+    /**
+     * To check whether two vertices are in the same component.
+     * 
+     * @param e1 the vertex's label
+     * @param e2 the vertex's label
+     * @return true or false
+     */
+    bool isConnected(const T& e1, const T& e2) const
+    { return componentOf(e1)==componentOf(e2); }
+
+    /**
+     * Component of each vertex, by vertex identifier.
+     * 
+     * @return the vector of component identifiers
+     */
+    const std::vector<VertexId>& componentVector() const
+    { return componentVector_; }
+
+    /**
+     * Number of vertices of each component, by component identifier.
+     * 
+     * @return the vector of component sizes
+     */
+    const std::vector<std::size_t>& componentSizeVector() const
+    { return componentSizeVector_; }
+
+
+protected:
+
+    /**
+     * Lock-free union of the trees of u and v, the smaller root being
+     * hooked under the other.
+     * 
+     * @param parentVector The parent of each vertex
+     * @param u the first vertex
+     * @param v the second vertex
+     */
+    static void hook(std::vector<std::atomic<VertexId>>& parentVector, VertexId u, VertexId v) {
+        VertexId p1 = parentVector[u].load(std::memory_order_relaxed);
+        VertexId p2 = parentVector[v].load(std::memory_order_relaxed);
+        while( p1!=p2 ) {
+            const VertexId high = p1>p2 ? p1 : p2;
+            const VertexId low = p1>p2 ? p2 : p1;
+            VertexId pHigh = parentVector[high].load(std::memory_order_relaxed);
+            if( pHigh==low ) {
+                break;
+            }
+            if( pHigh==high && parentVector[high].compare_exchange_strong(pHigh, low, std::memory_order_relaxed) ) {
+                break;
+            }
+            p1 = parentVector[parentVector[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+            p2 = parentVector[low].load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Make each vertex point directly to its root.
+     * 
+     * @param parentVector The parent of each vertex
+     * @param threadCount The number of threads
+     */
+    static void compress(std::vector<std::atomic<VertexId>>& parentVector, unsigned int threadCount) {
+        parallelChunks(parentVector.size(), threadCount, [&](unsigned int, std::size_t begin, std::size_t end) {
+            for(std::size_t v=begin; v<end; v++) {
+                VertexId p = parentVector[v].load(std::memory_order_relaxed);
+                VertexId pp = parentVector[p].load(std::memory_order_relaxed);
+                while( p!=pp ) {
+                    p = pp;
+                    pp = parentVector[p].load(std::memory_order_relaxed);
+                }
+                parentVector[v].store(p, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    /**
+     * Most frequent root among a sample of the vertices.
+     * 
+     * @param parentVector The parent of each vertex, compressed
+     * @return the root of the (probably) largest component
+     */
+    static VertexId sampleLargest(const std::vector<std::atomic<VertexId>>& parentVector) {
+        if( parentVector.empty() ) {
+            return 0;
+        }
+        std::unordered_map<VertexId, std::size_t> countMap;
+        const std::size_t sampleSize = 1024;
+        const std::size_t step = std::max<std::size_t>(1, parentVector.size() / sampleSize);
+        VertexId largest = parentVector[0].load(std::memory_order_relaxed);
+        std::size_t largestCount = 0;
+        for(std::size_t v=0; v<parentVector.size(); v+=step) {
+            const VertexId root = parentVector[v].load(std::memory_order_relaxed);
+            const std::size_t count = ++countMap[root];
+            if( count>largestCount ) {
+                largestCount = count;
+                largest = root;
+            }
+        }
+        return largest;
+    }
+
+    /**
+     * Number the components from 0, in the order of their first vertex.
+     * 
+     * @param rootVector The root of each vertex
+     */
+    void number(const std::vector<VertexId>& rootVector) {
+        const VertexId none = std::numeric_limits<VertexId>::max();
+        std::vector<VertexId> idVector(rootVector.size(), none);
+        componentVector_.assign(rootVector.size(), 0);
+        componentSizeVector_.clear();
+        for(std::size_t v=0; v<rootVector.size(); v++) {
+            VertexId& id = idVector[rootVector[v]];
+            if( id==none ) {
+                id = static_cast<VertexId>(componentSizeVector_.size());
+                componentSizeVector_.push_back(0);
+            }
+            componentVector_[v] = id;
+            componentSizeVector_[id]++;
+        }
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * Component of each vertex, by vertex identifier.
+     */
+    std::vector<VertexId>
+    componentVector_;
+
+    /**
+     * Number of vertices of each component, by component identifier.
+     */
+    std::vector<std::size_t>
+    componentSizeVector_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_COMPONENTS_HPP_
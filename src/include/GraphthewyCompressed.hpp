@@ -0,0 +1,331 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_COMPRESSED_HPP_
+#define _GRAPH_MODEL_COMPRESSED_HPP_
+
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Append an unsigned integer in LEB128 varint encoding: 7 bits per
+ * byte, the high bit telling whether another byte follows.
+ * 
+ * @param value The integer
+ * @param byteVector The bytes to append to
+ */
+inline void writeVarint(std::uint64_t value, std::vector<std::uint8_t>& byteVector) {
+    while( value>=0x80 ) {
+        byteVector.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    byteVector.push_back(static_cast<std::uint8_t>(value));
+}
+
+/**
+ * Read an unsigned integer in LEB128 varint encoding.
+ * 
+ * @param p The current position, moved after the integer
+ * @return the integer
+ */
+inline std::uint64_t readVarint(const std::uint8_t*& p) {
+    std::uint64_t value = *p & 0x7f;
+    unsigned int shift = 7;
+    while( *p++ & 0x80 ) {
+        value |= static_cast<std::uint64_t>(*p & 0x7f) << shift;
+        shift += 7;
+    }
+    return value;
+}
+
+
+/**
+ * Iterator decoding a compressed neighbor list on the fly.
+ */
+class CompressedNeighborIterator {
+
+public:
+
+    using iterator_category = std::input_iterator_tag;
+    using value_type = VertexId;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const VertexId*;
+    using reference = VertexId;
+
+    /**
+     * Constructor
+     * 
+     * @param p The position of the first gap
+     * @param remaining The number of neighbors left, 0 for the end iterator
+     * @param first The first neighbor
+     */
+    CompressedNeighborIterator(const std::uint8_t* p, std::size_t remaining, VertexId first)
+    : p_(p), remaining_(remaining), current_(first) { }
+
+    VertexId operator*() const { return current_; }
+
+    CompressedNeighborIterator& operator++() {
+        if( --remaining_>0 ) {
+            current_ += static_cast<VertexId>(readVarint(p_));
+        }
+        return *this;
+    }
+
+    bool operator==(const CompressedNeighborIterator& o) const { return remaining_==o.remaining_; }
+
+    bool operator!=(const CompressedNeighborIterator& o) const { return remaining_!=o.remaining_; }
+
+
+protected:
+
+    /**
+     * The position of the next gap.
+     */
+    const std::uint8_t*
+    p_;
+
+    /**
+     * The number of neighbors left, current one included.
+     */
+    std::size_t
+    remaining_;
+
+    /**
+     * The current neighbor.
+     */
+    VertexId
+    current_;
+
+};
+
+/**
+ * Range of compressed neighbors.
+ */
+struct CompressedNeighborRange {
+
+    /**
+     * @return the iterator on the first neighbor
+     */
+    CompressedNeighborIterator begin() const { return begin_; }
+
+    /**
+     * @return the end iterator
+     */
+    CompressedNeighborIterator end() const { return CompressedNeighborIterator(nullptr, 0, 0); }
+
+    /**
+     * @return the number of neighbors
+     */
+    std::size_t size() const { return size_; }
+
+    /**
+     * @return true if there is no neighbor
+     */
+    bool empty() const { return size_==0; }
+
+    /**
+     * The iterator on the first neighbor.
+     */
+    CompressedNeighborIterator
+    begin_;
+
+    /**
+     * The number of neighbors.
+     */
+    std::size_t
+    size_;
+
+};
+
+
+/**
+ * Read-only snapshot with gap-encoded neighbor lists.
+ * 
+ * The sorted neighbors of each vertex are stored as varints: the
+ * degree, the first neighbor relatively to the vertex itself (zigzag
+ * encoded, as it may be lower), then the gaps between consecutive
+ * neighbors. Neighbors close to their vertex, as after a
+ * GraphReorder, take one or two bytes per arc. Weights are not kept.
+ * 
+ * Template argument:
+ * - T = the type of the vertex's label
+ */
+template<equality_comparable T>
+struct CompressedSnapshot : public VertexLabels<T> {
+
+    using VertexLabels<T>::labelVector_;
+    using VertexLabels<T>::labelIndexVector_;
+
+    /**
+     * Constructor
+     * 
+     * @param snapshot The snapshot to compress
+     * @param threadCount The number of threads encoding the lists, 0 for the hardware concurrency
+     */
+    template<class W>
+    explicit CompressedSnapshot(const GraphSnapshot<T, W>& snapshot, unsigned int threadCount = 1)
+    : directed_(snapshot.isDirected()), arcCount_(snapshot.arcCount()) {
+        labelVector_ = snapshot.labelVector_;
+        labelIndexVector_ = snapshot.labelIndexVector_;
+        const std::size_t n = snapshot.order();
+        offsetVector_.assign(n + 1, 0);
+        std::vector<std::vector<std::uint8_t>> partVector(threadCount==0 ? defaultThreadCount() : threadCount);
+        const unsigned int partCount = parallelChunks(n, threadCount, [&](unsigned int c, std::size_t begin, std::size_t end) {
+            auto& bytes = partVector[c];
+            for(std::size_t v=begin; v<end; v++) {
+                offsetVector_[v] = bytes.size();
+                const NeighborRange range = snapshot.neighbors(static_cast<VertexId>(v));
+                writeVarint(range.size(), bytes);
+                VertexId previous = static_cast<VertexId>(v);
+                bool first = true;
+                for(const VertexId u : range) {
+                    if( first ) {
+                        const std::int64_t delta = static_cast<std::int64_t>(u) - static_cast<std::int64_t>(v);
+                        writeVarint((static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63), bytes);
+                        first = false;
+                    } else {
+                        writeVarint(u - previous, bytes);
+                    }
+                    previous = u;
+                }
+            }
+        });
+        // Concatenate the parts, shifting their offsets
+        std::size_t total = 0;
+        std::vector<std::size_t> baseVector(partCount);
+        for(unsigned int c=0; c<partCount; c++) {
+            baseVector[c] = total;
+            total += partVector[c].size();
+        }
+        byteVector_.reserve(total);
+        for(unsigned int c=0; c<partCount; c++) {
+            byteVector_.insert(byteVector_.end(), partVector[c].begin(), partVector[c].end());
+        }
+        const std::size_t chunkSize = (n + partCount - 1) / (partCount==0 ? 1 : partCount);
+        for(std::size_t v=0; v<n; v++) {
+            offsetVector_[v] += baseVector[v / chunkSize];
+        }
+        offsetVector_[n] = total;
+    }
+
+    /**
+     * Order of the graph (number of vertices)
+     * 
+     * @return the order of the graph
+     */
+    std::size_t order() const
+    { return labelVector_.size(); }
+
+    /**
+     * Number of stored arcs (twice the number of edges for an undirected graph).
+     * 
+     * @return the number of arcs
+     */
+    std::size_t arcCount() const
+    { return arcCount_; }
+
+    /**
+     * Whether the snapshot has been taken from a directed graph.
+     * 
+     * @return true or false
+     */
+    bool isDirected() const
+    { return directed_; }
+
+    /**
+     * Out-degree of a vertex.
+     * 
+     * @param v the vertex identifier
+     * @return the number of arcs starting from v
+     */
+    std::size_t degree(VertexId v) const {
+        const std::uint8_t* p = byteVector_.data() + offsetVector_[v];
+        return static_cast<std::size_t>(readVarint(p));
+    }
+
+    /**
+     * Neighbors of a vertex, sorted by identifier and decoded on the fly.
+     * 
+     * @param v the vertex identifier
+     * @return the range of neighbor identifiers
+     */
+    CompressedNeighborRange neighbors(VertexId v) const {
+        const std::uint8_t* p = byteVector_.data() + offsetVector_[v];
+        const std::size_t size = static_cast<std::size_t>(readVarint(p));
+        if( size==0 ) {
+            return CompressedNeighborRange{CompressedNeighborIterator(nullptr, 0, 0), 0};
+        }
+        const std::uint64_t zigzag = readVarint(p);
+        const std::int64_t delta = static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+        const VertexId first = static_cast<VertexId>(static_cast<std::int64_t>(v) + delta);
+        return CompressedNeighborRange{CompressedNeighborIterator(p, size, first), size};
+    }
+
+    /**
+     * Size of the encoded lists, in bytes.
+     * 
+     * @return the number of bytes
+     */
+    std::size_t byteCount() const
+    { return byteVector_.size(); }
+
+    /**
+     * Average size of an arc, including the per-vertex degree and offset.
+     * 
+     * @return the number of bytes per arc
+     */
+    double bytesPerArc() const {
+        if( arcCount_==0 ) {
+            return 0;
+        }
+        return static_cast<double>(byteVector_.size() + offsetVector_.size() * sizeof(std::size_t)) / static_cast<double>(arcCount_);
+    }
+
+
+public:
+
+    /**
+     * Whether the snapshot has been taken from a directed graph.
+     */
+    bool
+    directed_;
+
+    /**
+     * Number of stored arcs.
+     */
+    std::size_t
+    arcCount_;
+
+    /**
+     * Index of the first byte of each vertex's list, plus the total size.
+     */
+    std::vector<std::size_t>
+    offsetVector_;
+
+    /**
+     * The encoded lists.
+     */
+    std::vector<std::uint8_t>
+    byteVector_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_COMPRESSED_HPP_
@@ -0,0 +1,458 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_CORES_HPP_
+#define _GRAPH_MODEL_CORES_HPP_
+
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Number of vertices of each degree.
+ */
+struct DegreeHistogram {
+
+    /**
+     * Number of vertices of a degree.
+     * 
+     * @param degree the degree
+     * @return the number of vertices
+     */
+    std::size_t count(std::size_t degree) const
+    { return degree<countVector_.size() ? countVector_[degree] : 0; }
+
+    /**
+     * @return the largest degree, 0 for an empty graph
+     */
+    std::size_t maxDegree() const
+    { return countVector_.empty() ? 0 : countVector_.size() - 1; }
+
+    /**
+     * @return the average degree, 0 for an empty graph
+     */
+    double averageDegree() const {
+        std::size_t vertexCount = 0;
+        std::size_t degreeSum = 0;
+        for(std::size_t d=0; d<countVector_.size(); d++) {
+            vertexCount += countVector_[d];
+            degreeSum += d * countVector_[d];
+        }
+        return vertexCount==0 ? 0 : static_cast<double>(degreeSum) / static_cast<double>(vertexCount);
+    }
+
+    /**
+     * Number of vertices of each degree, up to the largest one.
+     */
+    std::vector<std::size_t>
+    countVector_;
+
+};
+
+
+/**
+ * In and out degrees of the vertices of a snapshot, and their
+ * histograms, computed in a single pass over the arcs. For an
+ * undirected snapshot, both are the number of links of each vertex.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct GraphDegrees {
+
+    /**
+     * Constructor, computing the degrees. The threads each take a
+     * contiguous range of vertices, read its offsets and targets in
+     * order, and fill their own out-degree histogram; the in-degrees are
+     * counted with atomic increments.
+     * 
+     * @param snapshot The snapshot of the graph
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    GraphDegrees(const GraphSnapshot<T, W>& snapshot, unsigned int threadCount = 0)
+    : snapshot_(snapshot) {
+        GRAPHTHEWY_STATS_TIMER(timer, "degrees");
+        GRAPHTHEWY_STATS_VISIT(timer, snapshot_.order(), snapshot_.arcCount());
+        const std::size_t n = snapshot_.order();
+        std::vector<std::atomic<std::uint32_t>> inVector(snapshot_.isDirected() ? n : 0);
+        for(auto& d : inVector) {
+            d.store(0, std::memory_order_relaxed);
+        }
+        std::vector<std::vector<std::size_t>> outVector(threadCount==0 ? defaultThreadCount() : threadCount);
+        const unsigned int chunkCount = parallelChunks(n, threadCount, [&](unsigned int c, std::size_t begin, std::size_t end) {
+            std::vector<std::size_t>& histogram = outVector[c];
+            for(VertexId v=static_cast<VertexId>(begin); v<end; v++) {
+                const std::size_t d = snapshot_.degree(v);
+                if( d>=histogram.size() ) {
+                    histogram.resize(d + 1, 0);
+                }
+                histogram[d]++;
+                if( snapshot_.isDirected() ) {
+                    for(const VertexId u : snapshot_.neighbors(v)) {
+                        inVector[u].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        });
+        outHistogram_.countVector_ = merge(outVector, chunkCount);
+        if( !snapshot_.isDirected() ) {
+            inHistogram_ = outHistogram_;
+            return;
+        }
+        inDegreeVector_.resize(n);
+        parallelChunks(n, threadCount, [&](unsigned int c, std::size_t begin, std::size_t end) {
+            std::vector<std::size_t>& histogram = outVector[c];
+            histogram.clear();
+            for(std::size_t v=begin; v<end; v++) {
+                const std::uint32_t d = inVector[v].load(std::memory_order_relaxed);
+                inDegreeVector_[v] = d;
+                if( d>=histogram.size() ) {
+                    histogram.resize(d + 1, 0);
+                }
+                histogram[d]++;
+            }
+        });
+        inHistogram_.countVector_ = merge(outVector, chunkCount);
+    }
+
+    /**
+     * Out-degree of a vertex, its number of links if undirected.
+     * 
+     * @param label the vertex's label
+     * @return the number of arcs starting from the vertex
+     */
+    std::size_t outDegree(const T& label) const
+    { return snapshot_.degree(snapshot_.idOf(label)); }
+
+    /**
+     * In-degree of a vertex, its number of links if undirected.
+     * 
+     * @param label the vertex's label
+     * @return the number of arcs ending at the vertex
+     */
+    std::size_t inDegree(const T& label) const {
+        const VertexId v = snapshot_.idOf(label);
+        return snapshot_.isDirected() ? inDegreeVector_[v] : snapshot_.degree(v);
+    }
+
+    /**
+     * @return the histogram of the out-degrees
+     */
+    const DegreeHistogram& outHistogram() const
+    { return outHistogram_; }
+
+    /**
+     * @return the histogram of the in-degrees
+     */
+    const DegreeHistogram& inHistogram() const
+    { return inHistogram_; }
+
+
+protected:
+
+    /**
+     * Sum of the histograms of the chunks.
+     * 
+     * @param histogramVector The histogram of each chunk
+     * @param chunkCount The number of chunks used
+     * @return the total histogram
+     */
+    static std::vector<std::size_t> merge(const std::vector<std::vector<std::size_t>>& histogramVector, unsigned int chunkCount) {
+        std::vector<std::size_t> total;
+        for(unsigned int c=0; c<chunkCount; c++) {
+            const std::vector<std::size_t>& histogram = histogramVector[c];
+            if( histogram.size()>total.size() ) {
+                total.resize(histogram.size(), 0);
+            }
+            for(std::size_t d=0; d<histogram.size(); d++) {
+                total[d] += histogram[d];
+            }
+        }
+        return total;
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * In-degree of each vertex of a directed snapshot, by vertex identifier.
+     */
+    std::vector<std::uint32_t>
+    inDegreeVector_;
+
+    /**
+     * Histogram of the out-degrees.
+     */
+    DegreeHistogram
+    outHistogram_;
+
+    /**
+     * Histogram of the in-degrees.
+     */
+    DegreeHistogram
+    inHistogram_;
+
+};
+
+
+/**
+ * k-core decomposition of an undirected snapshot: the core number of a
+ * vertex is the largest k such that it belongs to a subgraph where all
+ * the vertices have at least k links. Self-loops are ignored, repeated
+ * links counted.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct GraphCores {
+
+    /**
+     * Constructor
+     * 
+     * @param snapshot The snapshot of an undirected graph
+     */
+    GraphCores(const GraphSnapshot<T, W>& snapshot)
+    : snapshot_(snapshot) {
+        if( snapshot_.isDirected() ) {
+            throw std::runtime_error("graphthewy: cores need an undirected snapshot");
+        }
+    }
+
+    /**
+     * Sequential decomposition of Batagelj and Zaversnik, in O(V + E):
+     * the vertices are kept sorted by remaining degree in an array of
+     * buckets, and removing the first one moves each neighbor of higher
+     * degree to the previous bucket with a single swap.
+     * 
+     * @return the degeneracy of the graph (largest core number)
+     */
+    std::size_t decompose() {
+        GRAPHTHEWY_STATS_TIMER(timer, "coreDecomposition");
+        GRAPHTHEWY_STATS_VISIT(timer, snapshot_.order(), snapshot_.arcCount());
+        const std::size_t n = snapshot_.order();
+        std::vector<std::uint32_t> degreeVector = loopFreeDegrees();
+        const std::size_t maxDegree = n==0 ? 0 : *std::max_element(degreeVector.begin(), degreeVector.end());
+        // binVector[d] is the position of the first vertex of degree d
+        std::vector<std::size_t> binVector(maxDegree + 2, 0);
+        for(const std::uint32_t d : degreeVector) {
+            binVector[d + 1]++;
+        }
+        std::partial_sum(binVector.begin(), binVector.end(), binVector.begin());
+        orderVector_.resize(n);
+        std::vector<std::size_t> positionVector(n);
+        for(VertexId v=0; v<n; v++) {
+            positionVector[v] = binVector[degreeVector[v]]++;
+            orderVector_[positionVector[v]] = v;
+        }
+        for(std::size_t d=binVector.size() - 1; d>0; d--) {
+            binVector[d] = binVector[d - 1];
+        }
+        binVector[0] = 0;
+        for(std::size_t i=0; i<n; i++) {
+            const VertexId v = orderVector_[i];
+            for(const VertexId u : snapshot_.neighbors(v)) {
+                if( degreeVector[u]<=degreeVector[v] ) {
+                    continue;
+                }
+                const std::uint32_t du = degreeVector[u];
+                const std::size_t pw = binVector[du];
+                const VertexId w = orderVector_[pw];
+                if( u!=w ) {
+                    std::swap(orderVector_[positionVector[u]], orderVector_[pw]);
+                    std::swap(positionVector[u], positionVector[w]);
+                }
+                binVector[du]++;
+                degreeVector[u]--;
+            }
+        }
+        coreVector_.swap(degreeVector);
+        return degeneracy();
+    }
+
+    /**
+     * Parallel decomposition by peeling, level after level: at level k,
+     * the remaining vertices of degree at most k get the core number k,
+     * and their removal lowers the degree of their neighbors with atomic
+     * decrements, a neighbor falling to k being peeled in the same level.
+     * The remaining vertices are compacted after each level.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the degeneracy of the graph (largest core number)
+     */
+    std::size_t decomposeParallel(unsigned int threadCount = 0) {
+        GRAPHTHEWY_STATS_TIMER(timer, "coreDecompositionParallel");
+        GRAPHTHEWY_STATS_VISIT(timer, snapshot_.order(), snapshot_.arcCount());
+        const std::size_t n = snapshot_.order();
+        if( threadCount==0 ) {
+            threadCount = defaultThreadCount();
+        }
+        const std::vector<std::uint32_t> initialVector = loopFreeDegrees();
+        std::vector<std::atomic<std::uint32_t>> degreeVector(n);
+        for(std::size_t v=0; v<n; v++) {
+            degreeVector[v].store(initialVector[v], std::memory_order_relaxed);
+        }
+        coreVector_.assign(n, 0);
+        orderVector_.clear();
+        std::vector<VertexId> remainingVector(n);
+        std::iota(remainingVector.begin(), remainingVector.end(), VertexId(0));
+        std::vector<VertexId> frontier;
+        std::vector<std::vector<VertexId>> nextVector(threadCount);
+        for(std::uint32_t k=0; !remainingVector.empty(); k++) {
+            frontier.clear();
+            for(const VertexId v : remainingVector) {
+                if( degreeVector[v].load(std::memory_order_relaxed)<=k ) {
+                    frontier.push_back(v);
+                }
+            }
+            while( !frontier.empty() ) {
+                parallelDynamic(frontier.size(), threadCount, [&](unsigned int c, std::size_t i) {
+                    const VertexId v = frontier[i];
+                    coreVector_[v] = k;
+                    for(const VertexId u : snapshot_.neighbors(v)) {
+                        if( u==v || degreeVector[u].load(std::memory_order_relaxed)<=k ) {
+                            continue;
+                        }
+                        const std::uint32_t d = degreeVector[u].fetch_sub(1, std::memory_order_relaxed);
+                        if( d==k + 1 ) {
+                            nextVector[c].push_back(u);
+                        } else if( d<=k ) {
+                            // Another thread has just lowered it to k
+                            degreeVector[u].fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                });
+                orderVector_.insert(orderVector_.end(), frontier.begin(), frontier.end());
+                frontier.clear();
+                for(auto& next : nextVector) {
+                    frontier.insert(frontier.end(), next.begin(), next.end());
+                    next.clear();
+                }
+            }
+            remainingVector.erase(std::remove_if(remainingVector.begin(), remainingVector.end(), [&](VertexId v) {
+                return degreeVector[v].load(std::memory_order_relaxed)<=k;
+            }), remainingVector.end());
+        }
+        return degeneracy();
+    }
+
+    /**
+     * Core number of a vertex, after a decomposition.
+     * 
+     * @param label the vertex's label
+     * @return the core number
+     */
+    std::size_t coreNumber(const T& label) const
+    { return coreVector_[snapshot_.idOf(label)]; }
+
+    /**
+     * @return the largest core number, after a decomposition
+     */
+    std::size_t degeneracy() const {
+        return coreVector_.empty() ? 0 : *std::max_element(coreVector_.begin(), coreVector_.end());
+    }
+
+    /**
+     * Vertices of the k-core, after a decomposition.
+     * 
+     * @param k the core number
+     * @return the labels of the vertices of core number at least k, sorted
+     */
+    std::vector<T> core(std::size_t k) const {
+        std::vector<T> labelVector;
+        for(VertexId v=0; v<coreVector_.size(); v++) {
+            if( coreVector_[v]>=k ) {
+                labelVector.push_back(snapshot_.label(v));
+            }
+        }
+        std::sort(labelVector.begin(), labelVector.end());
+        return labelVector;
+    }
+
+    /**
+     * Core number of each vertex, by vertex identifier.
+     * 
+     * @return the vector of core numbers
+     */
+    const std::vector<std::uint32_t>& coreVector() const
+    { return coreVector_; }
+
+    /**
+     * Order in which the vertices have been removed, by non-decreasing
+     * core number: each vertex has at most degeneracy() neighbors after
+     * it (a degeneracy order).
+     * 
+     * @return the vertex identifiers
+     */
+    const std::vector<VertexId>& orderVector() const
+    { return orderVector_; }
+
+
+protected:
+
+    /**
+     * @return the number of links of each vertex, self-loops excluded
+     */
+    std::vector<std::uint32_t> loopFreeDegrees() const {
+        std::vector<std::uint32_t> degreeVector(snapshot_.order(), 0);
+        for(VertexId v=0; v<snapshot_.order(); v++) {
+            for(const VertexId u : snapshot_.neighbors(v)) {
+                degreeVector[v] += u!=v ? 1 : 0;
+            }
+        }
+        return degreeVector;
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * Core number of each vertex, by vertex identifier.
+     */
+    std::vector<std::uint32_t>
+    coreVector_;
+
+    /**
+     * Order of removal of the vertices.
+     */
+    std::vector<VertexId>
+    orderVector_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_CORES_HPP_
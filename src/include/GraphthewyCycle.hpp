@@ -12,24 +12,98 @@
 #define _GRAPH_MODEL_CYCLE_HPP_
 
 #include "GraphthewyModel.hpp"
+#include "GraphthewyComponents.hpp"
 
 #include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
-#include <map>
 
 
 
 namespace graphthewy {
 
+/**
+ * Cycle detection on an adjacency indexed by vertex identifiers: a
+ * GraphSnapshot, a CompressedSnapshot, or any type with order(),
+ * isDirected() and neighbors(v).
+ * 
+ * Template argument:
+ * - S = the type of the adjacency
+ */
+template<class S>
+struct AdjacencyCycle {
+
+    /**
+     * Constructor
+     * 
+     * @param adjacency The adjacency of the graph
+     */
+    AdjacencyCycle(const S& adjacency)
+    : adjacency_(adjacency) { }
+
+    /**
+     * Cycle detection: iterative depth-first search for a back arc if the
+     * adjacency is directed, union-find otherwise. A self-loop is a cycle.
+     * 
+     * @return true if cycle is detected, false otherwise.
+     */
+    bool hasCycle() const {
+        if( !adjacency_.isDirected() ) {
+            return hasUndirectedCycle(adjacency_);
+        }
+        using Iterator = decltype(adjacency_.neighbors(0).begin());
+        enum : char { white, grey, black };
+        std::vector<char> colorVector(adjacency_.order(), white);
+        std::vector<std::pair<VertexId, Iterator>> stack;
+        for(VertexId root=0; root<adjacency_.order(); root++) {
+            if( colorVector[root]!=white ) {
+                continue;
+            }
+            colorVector[root] = grey;
+            stack.emplace_back(root, adjacency_.neighbors(root).begin());
+            while( !stack.empty() ) {
+                const VertexId u = stack.back().first;
+                Iterator& it = stack.back().second;
+                if( it==adjacency_.neighbors(u).end() ) {
+                    colorVector[u] = black;
+                    stack.pop_back();
+                    continue;
+                }
+                const VertexId v = *it;
+                ++it;
+                if( colorVector[v]==grey ) {
+                    return true;
+                }
+                if( colorVector[v]==white ) {
+                    colorVector[v] = grey;
+                    stack.emplace_back(v, adjacency_.neighbors(v).begin());
+                }
+            }
+        }
+        return false;
+    }
+
+
+protected:
+
+    /**
+     * The adjacency of the graph.
+     */
+    const S&
+    adjacency_;
+
+};
+
 /**
  * Helper class for template method selection.
  * 
  * Templates arguments:
  * - G = UndirectedGraph or DirectedGraph
  * - T = the type that G has been templated with
+ * - W = the weight type that G has been templated with
  */
-template<template<class> class G, class T>
+template<template<class, class> class G, class T, class W = void>
 struct CycleHelper { };
 
 /**
@@ -39,8 +113,9 @@ struct CycleHelper { };
  * Templates arguments:
  * - G = UndirectedGraph or DirectedGraph
  * - T = the type that G has been templated with
+ * - W = the weight type that G has been templated with, void (default) if unweighted
  */
-template<template<class> class G, class T>
+template<template<class, class> class G, class T, class W = void>
 struct GraphCycle {
 
     /**
@@ -48,7 +123,7 @@ struct GraphCycle {
      * 
      * @param graph The graph, directed or undirected
      */
-    GraphCycle(const G<T>& graph)
+    GraphCycle(const G<T, W>& graph)
     : graph_(graph) { }
 
 protected:
@@ -63,9 +138,9 @@ protected:
      * @return true or false
      */
     bool deepfirstseach(
-        const std::shared_ptr<Vertex<T>>& vertex,
+        const std::shared_ptr<Vertex<T, W>>& vertex,
         std::vector<T>& visited,
-        const std::shared_ptr<Vertex<T>>& previous) const {
+        const std::shared_ptr<Vertex<T, W>>& previous) const {
         visited.push_back(vertex->label_);
         for(const auto& v : vertex->linkVectorPtr_) {
             if(v.lock()!=previous) {
@@ -82,60 +157,29 @@ protected:
 
 
     /**
-     * Cycle detection in an undirected graph.
+     * Cycle detection in an undirected graph, with a union-find
+     * on a snapshot of the graph.
      * 
      * @return true if cycle is detected, false otherwise.
      */
     bool hasCycleUndirected() const {
-        std::vector<T> visited;
-        for(const auto& v : graph_.vertexPtrMap_) {
-            if(std::find_if(visited.begin(), visited.end(), [&](const auto& x) {return v.first==x;})==visited.end()) {
-                if( deepfirstseach(v.second, visited, nullptr) ) {
-                    return true;
-                }
-            }
-        }
-        return false;
+        GRAPHTHEWY_STATS_TIMER(timer, "hasCycle");
+        const GraphSnapshot<T, W> snapshot(graph_);
+        GRAPHTHEWY_STATS_VISIT(timer, snapshot.order(), snapshot.arcCount());
+        return GraphComponents<T, W>(snapshot).hasCycle();
     }
 
     /**
-     * Cycle detection in a directed graph.
+     * Cycle detection in a directed graph, with a depth-first search
+     * on a snapshot of the graph.
      * 
      * @return true if cycle is detected, false otherwise.
      */
     bool hasCycleDirected() const {
-        std::map<T, std::vector<std::weak_ptr<Vertex<T>>>> currentMap, newMap;
-        for(const auto& e : graph_.vertexPtrMap_) {
-            currentMap.insert( std::pair(e.first, e.second->linkVectorPtr_));
-        }
-        unsigned int sum_r = 0;
-        unsigned long long int rollCounter = 0;
-        do {
-            sum_r = 0;
-            newMap.clear();
-            for(const auto& e : currentMap) {
-                std::vector<std::weak_ptr<Vertex<T>>> u;
-                for(const auto& s : e.second) {
-                    for(const auto& h : currentMap[s.lock()->label_]) {
-                        u.push_back( h );
-                    }
-                }
-                newMap.insert( std::pair(e.first, u) );
-            }
-            currentMap = newMap;
-            for(const auto& e : newMap) {
-                sum_r += e.second.size();
-
-                if( contains(e.second, e.first) ) {
-                    return true;
-                }
-            }
-            rollCounter++;
-            if( rollCounter > newMap.size() ) {
-                return true;
-            }
-        } while( sum_r > 0);
-        return false;
+        GRAPHTHEWY_STATS_TIMER(timer, "hasCycle");
+        const GraphSnapshot<T, W> snapshot(graph_);
+        GRAPHTHEWY_STATS_VISIT(timer, snapshot.order(), snapshot.arcCount());
+        return AdjacencyCycle<GraphSnapshot<T, W>>(snapshot).hasCycle();
     }
 
 
@@ -147,7 +191,7 @@ public:
      * @return true if cycle is detected, false otherwise.
      */
     constexpr bool hasCycle() const {
-        return CycleHelper<G, T>::hasCycle(this);
+        return CycleHelper<G, T, W>::hasCycle(this);
     }
 
 
@@ -160,7 +204,7 @@ protected:
      * @param e the element's label
      * @return true or false
      */
-    bool contains(const std::vector<std::shared_ptr<Vertex<T>>>& l, const T& e) const {
+    bool contains(const std::vector<std::shared_ptr<Vertex<T, W>>>& l, const T& e) const {
         for(const auto& v : l) {
             if(v->label_==e) {
                 return true;
@@ -176,7 +220,7 @@ protected:
      * @param e the element's label
      * @return true or false
      */
-    bool contains(const std::vector<std::weak_ptr<Vertex<T>>>& l, const T& e) const {
+    bool contains(const std::vector<std::weak_ptr<Vertex<T, W>>>& l, const T& e) const {
         for(const auto& v : l) {
             if(v.lock()->label_==e) {
                 return true;
@@ -192,7 +236,7 @@ protected:
      * @param e the element
      * @return true or false
      */
-    bool contains(const std::vector<std::shared_ptr<Vertex<T>>>& l, const std::shared_ptr<Vertex<T>>& e) const {
+    bool contains(const std::vector<std::shared_ptr<Vertex<T, W>>>& l, const std::shared_ptr<Vertex<T, W>>& e) const {
         return contains(l, e->label_);
     }
 
@@ -203,7 +247,7 @@ protected:
      * @param e the element
      * @return true or false
      */
-    bool contains(const std::vector<std::weak_ptr<Vertex<T>>>& l, const std::shared_ptr<Vertex<T>>& e) const {
+    bool contains(const std::vector<std::weak_ptr<Vertex<T, W>>>& l, const std::shared_ptr<Vertex<T, W>>& e) const {
         return contains(l, e->label_);
     }
 
@@ -213,7 +257,7 @@ public:
     /**
      * Friend class with the helper.
      */
-    friend class CycleHelper<G, T>;
+    friend class CycleHelper<G, T, W>;
 
 
 protected:
@@ -221,19 +265,19 @@ protected:
     /**
      * The graph.
      */
-    const G<T>&
+    const G<T, W>&
     graph_;
 
 };
 
-template<class T>
-struct CycleHelper<UndirectedGraph, T> {
-    static inline constexpr bool hasCycle(const GraphCycle<UndirectedGraph, T>* gc) { return gc->hasCycleUndirected(); }
+template<class T, class W>
+struct CycleHelper<UndirectedGraph, T, W> {
+    static inline constexpr bool hasCycle(const GraphCycle<UndirectedGraph, T, W>* gc) { return gc->hasCycleUndirected(); }
 };
 
-template<class T>
-struct CycleHelper<DirectedGraph, T> {
-    static inline constexpr bool hasCycle(const GraphCycle<DirectedGraph, T>* gc) { return gc->hasCycleDirected(); }
+template<class T, class W>
+struct CycleHelper<DirectedGraph, T, W> {
+    static inline constexpr bool hasCycle(const GraphCycle<DirectedGraph, T, W>* gc) { return gc->hasCycleDirected(); }
 };
 
 }
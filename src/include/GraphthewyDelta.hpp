@@ -0,0 +1,561 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_DELTA_HPP_
+#define _GRAPH_MODEL_DELTA_HPP_
+
+#include "GraphthewyModel.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Kind of a mutation of a graph.
+ */
+enum class DeltaKind {
+    AddVertex,
+    RemoveVertex,
+    Link,
+    Unlink
+};
+
+/**
+ * Mutation of a graph, recorded in a GraphDelta.
+ * 
+ * Template argument:
+ * - T = the type of the vertex's label
+ */
+template<equality_comparable T>
+struct DeltaOperation {
+
+    /**
+     * The kind of mutation.
+     */
+    DeltaKind
+    kind_;
+
+    /**
+     * The vertex, or the first end of the link.
+     */
+    T
+    source_;
+
+    /**
+     * The second end of the link, the vertex again for a vertex mutation.
+     */
+    T
+    target_;
+
+};
+
+
+/**
+ * Batch of mutations (vertices and links added or removed), recorded
+ * then applied to a graph at once.
+ * 
+ * Whatever the recording order, apply() runs the mutations in four
+ * phases: links removed, vertices removed, vertices added, links added
+ * (creating their missing vertices). In each phase, the work is grouped
+ * by vertex: every adjacency vector is visited or grown once, to its
+ * exact final size, and the vertices are processed in parallel. apply()
+ * returns the inverse batch, which restores the graph when applied.
+ * 
+ * The weights of the links are stored aside the operations, as in a
+ * vertex.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct GraphDelta : public WeightVector<W> {
+
+    /**
+     * Record the addition of a vertex, a no-op if it exists.
+     * 
+     * @param label the vertex's label
+     */
+    void addVertex(const T& label)
+    { push(DeltaKind::AddVertex, label, label); }
+
+    /**
+     * Record the removal of a vertex and of its links, a no-op if it
+     * does not exist.
+     * 
+     * @param label the vertex's label
+     */
+    void removeVertex(const T& label)
+    { push(DeltaKind::RemoveVertex, label, label); }
+
+    /**
+     * Record the creation of a link, subject to the edge policy of the
+     * graph.
+     * 
+     * @param e1 the main vertex's label
+     * @param e2 the second vertex's label
+     */
+    void link(const T& e1, const T& e2)
+    { push(DeltaKind::Link, e1, e2); }
+
+    /**
+     * Record the creation of a weighted link.
+     * 
+     * @param e1 the main vertex's label
+     * @param e2 the second vertex's label
+     * @param weight the weight of the link
+     */
+    template<class U = W, class = std::enable_if_t<!std::is_void_v<U>>>
+    void link(const T& e1, const T& e2, const U& weight) {
+        operationVector_.push_back(DeltaOperation<T>{DeltaKind::Link, e1, e2});
+        this->weightVector_.push_back(weight);
+    }
+
+    /**
+     * Record the removal of a link (one of them, if repeated), a no-op if
+     * there is none.
+     * 
+     * @param e1 the main vertex's label
+     * @param e2 the second vertex's label
+     */
+    void unlink(const T& e1, const T& e2)
+    { push(DeltaKind::Unlink, e1, e2); }
+
+    /**
+     * @return the number of recorded mutations
+     */
+    std::size_t size() const
+    { return operationVector_.size(); }
+
+    /**
+     * @return true if no mutation is recorded
+     */
+    bool empty() const
+    { return operationVector_.empty(); }
+
+    /**
+     * Forget the recorded mutations.
+     */
+    void clear() {
+        operationVector_.clear();
+        if constexpr( !std::is_void_v<W> ) {
+            this->weightVector_.clear();
+        }
+    }
+
+    /**
+     * Recorded mutations, in recording order.
+     * 
+     * @return the vector of mutations
+     */
+    const std::vector<DeltaOperation<T>>& operationVector() const
+    { return operationVector_; }
+
+    /**
+     * Apply the mutations to an undirected graph.
+     * 
+     * @param g The graph
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the inverse batch
+     */
+    GraphDelta<T, W> apply(UndirectedGraph<T, W>& g, unsigned int threadCount = 0) const
+    { return apply(g, threadCount, true); }
+
+    /**
+     * Apply the mutations to a directed graph.
+     * 
+     * @param g The graph
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the inverse batch
+     */
+    GraphDelta<T, W> apply(DirectedGraph<T, W>& g, unsigned int threadCount = 0) const
+    { return apply(g, threadCount, false); }
+
+
+protected:
+
+    /**
+     * Arc to add to, or remove from, the adjacency vector of its source.
+     */
+    struct Arc {
+
+        /**
+         * The source, in the vertex registry.
+         */
+        const std::shared_ptr<Vertex<T, W>>*
+        source_;
+
+        /**
+         * The target, in the vertex registry.
+         */
+        const std::shared_ptr<Vertex<T, W>>*
+        target_;
+
+        /**
+         * Index of the mutation.
+         */
+        std::size_t
+        operation_;
+
+        /**
+         * true for the e1 -> e2 way of the mutation.
+         */
+        bool
+        forward_;
+
+    };
+
+    /**
+     * Record a mutation, with the default weight.
+     * 
+     * @param kind The kind of mutation
+     * @param source The vertex, or the first end of the link
+     * @param target The second end of the link
+     */
+    void push(DeltaKind kind, const T& source, const T& target) {
+        operationVector_.push_back(DeltaOperation<T>{kind, source, target});
+        if constexpr( !std::is_void_v<W> ) {
+            this->weightVector_.push_back(W(1));
+        }
+    }
+
+    /**
+     * Record the creation of a link with a weight taken from a weight
+     * vector (a vertex's, for instance).
+     * 
+     * @param e1 the main vertex's label
+     * @param e2 the second vertex's label
+     * @param weights The weights
+     * @param k The position of the weight
+     */
+    void linkFrom(const T& e1, const T& e2, const WeightVector<W>& weights, std::size_t k) {
+        if constexpr( !std::is_void_v<W> ) {
+            link(e1, e2, weights.weightVector_[k]);
+        } else {
+            (void)weights;
+            (void)k;
+            link(e1, e2);
+        }
+    }
+
+    /**
+     * Apply the mutations, phase by phase.
+     * 
+     * @param g The graph
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @param bothWays true for an undirected graph
+     * @return the inverse batch
+     */
+    GraphDelta<T, W> apply(UndirectedGraph<T, W>& g, unsigned int threadCount, bool bothWays) const {
+        GRAPHTHEWY_STATS_TIMER(timer, "applyDelta");
+        GRAPHTHEWY_STATS_VISIT(timer, 0, operationVector_.size());
+        GraphDelta<T, W> inverse;
+        unlinkPhase(g, threadCount, bothWays, inverse);
+        removePhase(g, threadCount, bothWays, inverse);
+        for(const DeltaOperation<T>& o : operationVector_) {
+            if( o.kind_==DeltaKind::AddVertex && !g.contains(o.source_) ) {
+                g.findOrAddVertex(o.source_);
+                inverse.removeVertex(o.source_);
+            }
+        }
+        linkPhase(g, threadCount, bothWays, inverse);
+        return inverse;
+    }
+
+    /**
+     * Sort arcs by source, and run f(begin, end) on each group of arcs
+     * of the same source, in parallel.
+     * 
+     * @param arcVector The arcs
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @param f The function to call on each group
+     */
+    template<class F>
+    static void forEachSource(std::vector<Arc>& arcVector, unsigned int threadCount, F&& f) {
+        std::stable_sort(arcVector.begin(), arcVector.end(), [](const Arc& a, const Arc& b) {
+            return std::less<const Vertex<T, W>*>()(a.source_->get(), b.source_->get());
+        });
+        std::vector<std::size_t> boundVector;
+        for(std::size_t i=0; i<arcVector.size(); i++) {
+            if( i==0 || arcVector[i].source_->get()!=arcVector[i - 1].source_->get() ) {
+                boundVector.push_back(i);
+            }
+        }
+        boundVector.push_back(arcVector.size());
+        parallelDynamic(boundVector.size() - 1, threadCount, [&](unsigned int, std::size_t g) {
+            f(boundVector[g], boundVector[g + 1]);
+        }, 1);
+    }
+
+    /**
+     * Remove the links of the Unlink mutations, each vertex removing
+     * all its arcs in one pass.
+     * 
+     * @param g The graph
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @param bothWays true for an undirected graph
+     * @param inverse The inverse batch to complete
+     */
+    void unlinkPhase(UndirectedGraph<T, W>& g, unsigned int threadCount, bool bothWays, GraphDelta<T, W>& inverse) const {
+        std::vector<Arc> arcVector;
+        for(std::size_t i=0; i<operationVector_.size(); i++) {
+            const DeltaOperation<T>& o = operationVector_[i];
+            if( o.kind_==DeltaKind::Unlink && g.contains(o.source_) && g.contains(o.target_) ) {
+                const auto& p1 = g.vertexPtrMap_.find(o.source_)->second;
+                const auto& p2 = g.vertexPtrMap_.find(o.target_)->second;
+                arcVector.push_back(Arc{&p1, &p2, i, true});
+                if( bothWays ) {
+                    arcVector.push_back(Arc{&p2, &p1, i, false});
+                }
+            }
+        }
+        if( arcVector.empty() ) {
+            return;
+        }
+        // Whether each mutation found its link, and the weight of the link
+        std::vector<char> foundVector(operationVector_.size(), 0);
+        WeightVector<W> removedWeights;
+        if constexpr( !std::is_void_v<W> ) {
+            removedWeights.weightVector_.resize(operationVector_.size());
+        }
+        forEachSource(arcVector, threadCount, [&](std::size_t begin, std::size_t end) {
+            Vertex<T, W>& v = **arcVector[begin].source_;
+            const std::size_t d = v.linkVectorPtr_.size();
+            std::vector<char> removedLinkVector(d, 0);
+            for(std::size_t a=begin; a<end; a++) {
+                std::size_t k = 0;
+                while( k<d && (removedLinkVector[k] || v.linkVectorPtr_[k].lock().get()!=arcVector[a].target_->get()) ) {
+                    k++;
+                }
+                if( k<d ) {
+                    removedLinkVector[k] = 1;
+                }
+                if( k<d && arcVector[a].forward_ ) {
+                    foundVector[arcVector[a].operation_] = 1;
+                    if constexpr( !std::is_void_v<W> ) {
+                        removedWeights.weightVector_[arcVector[a].operation_] = v.weightVector_[k];
+                    }
+                }
+            }
+            std::size_t kept = 0;
+            for(std::size_t k=0; k<d; k++) {
+                if( !removedLinkVector[k] ) {
+                    if( kept!=k ) {
+                        v.linkVectorPtr_[kept] = std::move(v.linkVectorPtr_[k]);
+                        if constexpr( !std::is_void_v<W> ) {
+                            v.weightVector_[kept] = std::move(v.weightVector_[k]);
+                        }
+                    }
+                    kept++;
+                }
+            }
+            v.linkVectorPtr_.resize(kept);
+            if constexpr( !std::is_void_v<W> ) {
+                v.weightVector_.resize(kept);
+            }
+        });
+        for(const Arc& a : arcVector) {
+            if( a.forward_ && foundVector[a.operation_] ) {
+                const DeltaOperation<T>& o = operationVector_[a.operation_];
+                inverse.linkFrom(o.source_, o.target_, removedWeights, a.operation_);
+                if( g.policy_!=EdgePolicy::Multigraph ) {
+                    g.linkIndex_.erase(g.linkKey(a.source_->get(), a.target_->get(), bothWays));
+                }
+            }
+        }
+    }
+
+    /**
+     * Remove the vertices of the RemoveVertex mutations, and the links
+     * toward them, each vertex dropping them in one pass. Only the
+     * neighbors are visited in an undirected graph, all the vertices in
+     * a directed one.
+     * 
+     * @param g The graph
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @param bothWays true for an undirected graph
+     * @param inverse The inverse batch to complete
+     */
+    void removePhase(UndirectedGraph<T, W>& g, unsigned int threadCount, bool bothWays, GraphDelta<T, W>& inverse) const {
+        std::unordered_set<const Vertex<T, W>*> removedSet;
+        std::vector<const T*> removedLabelVector;
+        for(const DeltaOperation<T>& o : operationVector_) {
+            const auto it = g.vertexPtrMap_.find(o.source_);
+            if( o.kind_==DeltaKind::RemoveVertex && it!=g.vertexPtrMap_.end() && removedSet.insert(it->second.get()).second ) {
+                removedLabelVector.push_back(&it->first);
+            }
+        }
+        if( removedSet.empty() ) {
+            return;
+        }
+        std::vector<Vertex<T, W>*> candidateVector;
+        if( bothWays ) {
+            std::unordered_set<Vertex<T, W>*> candidateSet;
+            for(const T* label : removedLabelVector) {
+                Vertex<T, W>* v = g.vertexPtrMap_.find(*label)->second.get();
+                if( candidateSet.insert(v).second ) {
+                    candidateVector.push_back(v);
+                }
+                for(const auto& p : v->linkVectorPtr_) {
+                    Vertex<T, W>* u = p.lock().get();
+                    if( candidateSet.insert(u).second ) {
+                        candidateVector.push_back(u);
+                    }
+                }
+            }
+        } else {
+            for(const auto& e : g.vertexPtrMap_) {
+                candidateVector.push_back(e.second.get());
+            }
+        }
+        // Removed links of each candidate, as (target, position) pairs, to restore
+        std::vector<std::vector<std::pair<const Vertex<T, W>*, std::size_t>>> recordVector(candidateVector.size());
+        parallelDynamic(candidateVector.size(), threadCount, [&](unsigned int, std::size_t c) {
+            Vertex<T, W>& u = *candidateVector[c];
+            const bool removed = removedSet.count(&u)!=0;
+            std::size_t selfLoopCount = 0;
+            for(std::size_t k=0; k<u.linkVectorPtr_.size(); k++) {
+                const Vertex<T, W>* t = u.linkVectorPtr_[k].lock().get();
+                bool record;
+                if( !bothWays ) {
+                    record = removed || removedSet.count(t)!=0;
+                } else if( !removed ) {
+                    record = false;
+                } else if( t==&u ) {
+                    // An undirected self-loop is stored twice
+                    record = selfLoopCount++ % 2==0;
+                } else {
+                    // A link between two removed vertices is restored once
+                    record = removedSet.count(t)==0 || t->label_<u.label_;
+                }
+                if( record ) {
+                    recordVector[c].push_back(std::make_pair(t, k));
+                }
+            }
+        });
+        for(std::size_t c=0; c<candidateVector.size(); c++) {
+            const Vertex<T, W>& u = *candidateVector[c];
+            for(const auto& r : recordVector[c]) {
+                inverse.linkFrom(u.label_, r.first->label_, u, r.second);
+                if( g.policy_!=EdgePolicy::Multigraph ) {
+                    g.linkIndex_.erase(g.linkKey(&u, r.first, bothWays));
+                }
+            }
+        }
+        parallelDynamic(candidateVector.size(), threadCount, [&](unsigned int, std::size_t c) {
+            Vertex<T, W>& u = *candidateVector[c];
+            if( removedSet.count(&u)==0 ) {
+                dropLinks(u, removedSet);
+            }
+        });
+        for(const T* label : removedLabelVector) {
+            inverse.addVertex(*label);
+        }
+        for(const T* label : removedLabelVector) {
+            g.vertexPtrMap_.erase(*label);
+        }
+    }
+
+    /**
+     * Remove the links of a vertex toward a set of vertices, in one pass.
+     * 
+     * @param u The vertex
+     * @param removedSet The vertices to unlink from
+     */
+    static void dropLinks(Vertex<T, W>& u, const std::unordered_set<const Vertex<T, W>*>& removedSet) {
+        std::size_t kept = 0;
+        for(std::size_t k=0; k<u.linkVectorPtr_.size(); k++) {
+            if( removedSet.count(u.linkVectorPtr_[k].lock().get())==0 ) {
+                if( kept!=k ) {
+                    u.linkVectorPtr_[kept] = std::move(u.linkVectorPtr_[k]);
+                    if constexpr( !std::is_void_v<W> ) {
+                        u.weightVector_[kept] = std::move(u.weightVector_[k]);
+                    }
+                }
+                kept++;
+            }
+        }
+        u.linkVectorPtr_.resize(kept);
+        if constexpr( !std::is_void_v<W> ) {
+            u.weightVector_.resize(kept);
+        }
+    }
+
+    /**
+     * Create the links of the Link mutations, each vertex growing its
+     * adjacency vector once, to its exact final size.
+     * 
+     * @param g The graph
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @param bothWays true for an undirected graph
+     * @param inverse The inverse batch to complete
+     */
+    void linkPhase(UndirectedGraph<T, W>& g, unsigned int threadCount, bool bothWays, GraphDelta<T, W>& inverse) const {
+        std::vector<Arc> arcVector;
+        for(std::size_t i=0; i<operationVector_.size(); i++) {
+            const DeltaOperation<T>& o = operationVector_[i];
+            if( o.kind_!=DeltaKind::Link ) {
+                continue;
+            }
+            for(const T* label : {&o.source_, &o.target_}) {
+                if( !g.contains(*label) ) {
+                    g.findOrAddVertex(*label);
+                    inverse.removeVertex(*label);
+                }
+            }
+            const auto& p1 = g.vertexPtrMap_.find(o.source_)->second;
+            const auto& p2 = g.vertexPtrMap_.find(o.target_)->second;
+            if( g.acceptLink(p1.get(), p2.get(), bothWays) ) {
+                arcVector.push_back(Arc{&p1, &p2, i, true});
+                if( bothWays ) {
+                    arcVector.push_back(Arc{&p2, &p1, i, false});
+                }
+                inverse.unlink(o.source_, o.target_);
+            }
+        }
+        forEachSource(arcVector, threadCount, [&](std::size_t begin, std::size_t end) {
+            Vertex<T, W>& v = **arcVector[begin].source_;
+            trackedReserve(v.linkVectorPtr_, v.linkVectorPtr_.size() + end - begin);
+            if constexpr( !std::is_void_v<W> ) {
+                trackedReserve(v.weightVector_, v.weightVector_.size() + end - begin);
+            }
+            for(std::size_t a=begin; a<end; a++) {
+                if constexpr( !std::is_void_v<W> ) {
+                    v.link(*arcVector[a].target_, this->weightVector_[arcVector[a].operation_]);
+                } else {
+                    v.link(*arcVector[a].target_);
+                }
+            }
+        });
+    }
+
+
+protected:
+
+    /**
+     * Recorded mutations, in recording order.
+     */
+    std::vector<DeltaOperation<T>>
+    operationVector_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_DELTA_HPP_
@@ -0,0 +1,458 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_DENSE_HPP_
+#define _GRAPH_MODEL_DENSE_HPP_
+
+#include "GraphthewyModel.hpp"
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Iterator over the set bits of a bitset row, word by word.
+ */
+class BitIterator {
+
+public:
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = VertexId;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const VertexId*;
+    using reference = VertexId;
+
+    /**
+     * Constructor
+     * 
+     * @param row The words of the row
+     * @param wordCount The number of words of the row
+     * @param word The index of the first word to scan, wordCount for the end iterator
+     */
+    BitIterator(const std::uint64_t* row, std::size_t wordCount, std::size_t word)
+    : row_(row), wordCount_(wordCount), word_(word), bits_(word<wordCount ? row[word] : 0) {
+        skipEmpty();
+    }
+
+    VertexId operator*() const
+    { return static_cast<VertexId>(word_ * 64 + static_cast<std::size_t>(__builtin_ctzll(bits_))); }
+
+    BitIterator& operator++() {
+        bits_ &= bits_ - 1;
+        skipEmpty();
+        return *this;
+    }
+
+    bool operator==(const BitIterator& o) const { return word_==o.word_ && bits_==o.bits_; }
+
+    bool operator!=(const BitIterator& o) const { return !(*this==o); }
+
+
+protected:
+
+    /**
+     * Move to the next word having a set bit.
+     */
+    void skipEmpty() {
+        while( bits_==0 && word_<wordCount_ && ++word_<wordCount_ ) {
+            bits_ = row_[word_];
+        }
+    }
+
+
+protected:
+
+    /**
+     * The words of the row.
+     */
+    const std::uint64_t*
+    row_;
+
+    /**
+     * The number of words of the row.
+     */
+    std::size_t
+    wordCount_;
+
+    /**
+     * The index of the current word.
+     */
+    std::size_t
+    word_;
+
+    /**
+     * The bits of the current word not visited yet.
+     */
+    std::uint64_t
+    bits_;
+
+};
+
+/**
+ * Range of the set bits of a bitset row.
+ */
+struct BitRange {
+
+    /**
+     * @return the iterator on the first set bit
+     */
+    BitIterator begin() const { return BitIterator(row_, wordCount_, 0); }
+
+    /**
+     * @return the end iterator
+     */
+    BitIterator end() const { return BitIterator(row_, wordCount_, wordCount_); }
+
+    /**
+     * The words of the row.
+     */
+    const std::uint64_t*
+    row_;
+
+    /**
+     * The number of words of the row.
+     */
+    std::size_t
+    wordCount_;
+
+};
+
+
+/**
+ * Adjacency matrix stored as one bitset row per vertex, for small dense
+ * graphs: a link costs one bit, testing it one memory access, and the
+ * set operations on neighborhoods work 64 vertices at a time.
+ * 
+ * Repeated links are merged; self-loops are kept.
+ * 
+ * Template argument:
+ * - T = the type of the vertex's label
+ */
+template<equality_comparable T>
+struct DenseBitGraph : public VertexLabels<T> {
+
+    using VertexLabels<T>::labelVector_;
+    using VertexLabels<T>::labelIndexVector_;
+    using VertexLabels<T>::idOf;
+
+    /**
+     * Constructor
+     * 
+     * @param snapshot The snapshot of the graph
+     */
+    template<class W>
+    explicit DenseBitGraph(const GraphSnapshot<T, W>& snapshot)
+    : directed_(snapshot.isDirected()), wordCount_((snapshot.order() + 63) / 64),
+      rowVector_(snapshot.order() * wordCount_, 0) {
+        labelVector_ = snapshot.labelVector_;
+        labelIndexVector_ = snapshot.labelIndexVector_;
+        for(VertexId u=0; u<snapshot.order(); u++) {
+            for(const VertexId v : snapshot.neighbors(u)) {
+                setArc(u, v);
+            }
+        }
+    }
+
+    /**
+     * Constructor
+     * 
+     * @param graph The undirected graph
+     */
+    template<class W>
+    explicit DenseBitGraph(const UndirectedGraph<T, W>& graph)
+    : DenseBitGraph(GraphSnapshot<T, W>(graph)) { }
+
+    /**
+     * Constructor
+     * 
+     * @param graph The directed graph
+     */
+    template<class W>
+    explicit DenseBitGraph(const DirectedGraph<T, W>& graph)
+    : DenseBitGraph(GraphSnapshot<T, W>(graph)) { }
+
+    /**
+     * Order of the graph (number of vertices)
+     * 
+     * @return the order of the graph
+     */
+    std::size_t order() const
+    { return labelVector_.size(); }
+
+    /**
+     * Whether the graph is directed.
+     * 
+     * @return true or false
+     */
+    bool isDirected() const
+    { return directed_; }
+
+    /**
+     * To check whether two vertices are linked (by an arc from e1 to e2
+     * if directed).
+     * 
+     * @param e1 the vertex's label
+     * @param e2 the vertex's label
+     * @return true or false
+     */
+    bool isLinked(const T& e1, const T& e2) const {
+        if( !this->contains(e1) || !this->contains(e2) ) {
+            return false;
+        }
+        return hasArc(idOf(e1), idOf(e2));
+    }
+
+    /**
+     * To check whether there is an arc between two vertex identifiers.
+     * 
+     * @param u the source identifier
+     * @param v the target identifier
+     * @return true or false
+     */
+    bool hasArc(VertexId u, VertexId v) const
+    { return (row(u)[v / 64] >> (v % 64)) & 1; }
+
+    /**
+     * Out-degree of a vertex.
+     * 
+     * @param v the vertex identifier
+     * @return the number of neighbors
+     */
+    std::size_t degree(VertexId v) const {
+        std::size_t d = 0;
+        for(std::size_t w=0; w<wordCount_; w++) {
+            d += static_cast<std::size_t>(__builtin_popcountll(row(v)[w]));
+        }
+        return d;
+    }
+
+    /**
+     * Neighbors of a vertex, by increasing identifier.
+     * 
+     * @param v the vertex identifier
+     * @return the range of neighbor identifiers
+     */
+    BitRange neighbors(VertexId v) const
+    { return BitRange{row(v), wordCount_}; }
+
+    /**
+     * Cycle detection. A directed graph is searched depth-first, the
+     * unvisited neighbors and the back arcs being found by masking the
+     * row with the visit state, 64 vertices at a time. An undirected
+     * graph has a cycle if it has a self-loop, or more links than its
+     * vertices minus its components.
+     * 
+     * @return true if cycle is detected, false otherwise.
+     */
+    bool hasCycle() const {
+        return directed_ ? hasDirectedCycle() : hasUndirectedCycle();
+    }
+
+    /**
+     * Transitive closure, by a breadth-first search from each vertex on
+     * whole rows: the next frontier is the union of the rows of the
+     * frontier, less the vertices already reached. Each row of the
+     * closure only depends on the graph, so that the threads share the
+     * rows once, without any synchronization between them. A vertex
+     * reaches itself only through a cycle (or, undirected, through any
+     * link).
+     * 
+     * @param threadCount The number of threads sharing the rows, 0 for the hardware concurrency
+     * @return the graph linking each vertex to all the vertices it reaches
+     */
+    DenseBitGraph<T> transitiveClosure(unsigned int threadCount = 1) const {
+        DenseBitGraph<T> closure(*this);
+        if( threadCount==0 ) {
+            threadCount = defaultThreadCount();
+        }
+        std::vector<std::vector<std::uint64_t>> frontierVector(threadCount, std::vector<std::uint64_t>(wordCount_));
+        std::vector<std::vector<std::uint64_t>> nextVector(threadCount, std::vector<std::uint64_t>(wordCount_));
+        parallelDynamic(order(), threadCount, [&](unsigned int c, std::size_t i) {
+            std::uint64_t* reached = closure.row(static_cast<VertexId>(i));
+            std::vector<std::uint64_t>& frontier = frontierVector[c];
+            std::vector<std::uint64_t>& next = nextVector[c];
+            std::copy(reached, reached + wordCount_, frontier.begin());
+            for(bool grown=true; grown; ) {
+                std::fill(next.begin(), next.end(), 0);
+                for(const VertexId v : BitRange{frontier.data(), wordCount_}) {
+                    const std::uint64_t* rowV = row(v);
+                    for(std::size_t w=0; w<wordCount_; w++) {
+                        next[w] |= rowV[w];
+                    }
+                }
+                grown = false;
+                for(std::size_t w=0; w<wordCount_; w++) {
+                    next[w] &= ~reached[w];
+                    reached[w] |= next[w];
+                    grown = grown || next[w]!=0;
+                }
+                frontier.swap(next);
+            }
+        }, 16);
+        return closure;
+    }
+
+protected:
+
+    /**
+     * @param v the vertex identifier
+     * @return the words of the row of v
+     */
+    const std::uint64_t* row(VertexId v) const
+    { return rowVector_.data() + v * wordCount_; }
+
+    /**
+     * @param v the vertex identifier
+     * @return the words of the row of v
+     */
+    std::uint64_t* row(VertexId v)
+    { return rowVector_.data() + v * wordCount_; }
+
+    /**
+     * Set the bit of an arc.
+     * 
+     * @param u the source identifier
+     * @param v the target identifier
+     */
+    void setArc(VertexId u, VertexId v)
+    { row(u)[v / 64] |= std::uint64_t(1) << (v % 64); }
+
+    /**
+     * Iterative depth-first search for a back arc. A vertex is checked
+     * against the vertices on the stack when it is pushed: the vertices
+     * pushed later are its descendants.
+     * 
+     * @return true if cycle is detected, false otherwise.
+     */
+    bool hasDirectedCycle() const {
+        const std::size_t n = order();
+        std::vector<std::uint64_t> unvisited(wordCount_, ~std::uint64_t(0)), onStack(wordCount_, 0);
+        if( n % 64!=0 ) {
+            unvisited.back() = (std::uint64_t(1) << (n % 64)) - 1;
+        }
+        // Each frame resumes the scan of its row at the word where it stopped
+        std::vector<std::pair<VertexId, std::size_t>> stack;
+        const auto push = [&](VertexId v) {
+            unvisited[v / 64] &= ~(std::uint64_t(1) << (v % 64));
+            onStack[v / 64] |= std::uint64_t(1) << (v % 64);
+            for(std::size_t w=0; w<wordCount_; w++) {
+                if( row(v)[w] & onStack[w] ) {
+                    return true;
+                }
+            }
+            stack.emplace_back(v, 0);
+            return false;
+        };
+        for(std::size_t w=0; w<wordCount_; w++) {
+            while( unvisited[w]!=0 ) {
+                if( push(static_cast<VertexId>(w * 64 + static_cast<std::size_t>(__builtin_ctzll(unvisited[w])))) ) {
+                    return true;
+                }
+                while( !stack.empty() ) {
+                    const VertexId u = stack.back().first;
+                    std::size_t& word = stack.back().second;
+                    while( word<wordCount_ && (row(u)[word] & unvisited[word])==0 ) {
+                        word++;
+                    }
+                    if( word==wordCount_ ) {
+                        onStack[u / 64] &= ~(std::uint64_t(1) << (u % 64));
+                        stack.pop_back();
+                        continue;
+                    }
+                    const std::uint64_t bits = row(u)[word] & unvisited[word];
+                    if( push(static_cast<VertexId>(word * 64 + static_cast<std::size_t>(__builtin_ctzll(bits)))) ) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Cycle detection in an undirected graph: a self-loop, or more links
+     * than a forest of the same components would have. The components
+     * are found by breadth-first search on whole words.
+     * 
+     * @return true if cycle is detected, false otherwise.
+     */
+    bool hasUndirectedCycle() const {
+        const std::size_t n = order();
+        std::size_t bitCount = 0;
+        for(VertexId v=0; v<n; v++) {
+            if( hasArc(v, v) ) {
+                return true;
+            }
+            bitCount += degree(v);
+        }
+        std::vector<std::uint64_t> unvisited(wordCount_, ~std::uint64_t(0));
+        if( n % 64!=0 ) {
+            unvisited.back() = (std::uint64_t(1) << (n % 64)) - 1;
+        }
+        std::size_t componentCount = 0;
+        std::vector<VertexId> queue;
+        for(std::size_t w=0; w<wordCount_; w++) {
+            while( unvisited[w]!=0 ) {
+                const VertexId root = static_cast<VertexId>(w * 64 + static_cast<std::size_t>(__builtin_ctzll(unvisited[w])));
+                componentCount++;
+                unvisited[w] &= unvisited[w] - 1;
+                queue.assign(1, root);
+                for(std::size_t head=0; head<queue.size(); head++) {
+                    const std::uint64_t* r = row(queue[head]);
+                    for(std::size_t x=0; x<wordCount_; x++) {
+                        std::uint64_t bits = r[x] & unvisited[x];
+                        unvisited[x] &= ~bits;
+                        while( bits!=0 ) {
+                            queue.push_back(static_cast<VertexId>(x * 64 + static_cast<std::size_t>(__builtin_ctzll(bits))));
+                            bits &= bits - 1;
+                        }
+                    }
+                }
+            }
+        }
+        return bitCount / 2 > n - componentCount;
+    }
+
+
+protected:
+
+    /**
+     * Whether the graph is directed.
+     */
+    bool
+    directed_;
+
+    /**
+     * Number of 64-bit words of a row.
+     */
+    std::size_t
+    wordCount_;
+
+    /**
+     * The rows, one after the other.
+     */
+    std::vector<std::uint64_t>
+    rowVector_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_DENSE_HPP_
@@ -0,0 +1,338 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_EXECUTOR_HPP_
+#define _GRAPH_MODEL_EXECUTOR_HPP_
+
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Pool of threads running read-only queries over a snapshot, each query
+ * being a function of the snapshot whose result is given by a future:
+ * 
+ *   auto f = executor.submit([](const GraphSnapshot<int>& s) { return s.degree(0); });
+ * 
+ * Each thread has its own queue of tasks: it takes its newest task
+ * first, and when its queue is empty it steals the oldest task of
+ * another thread. A task submitted from a query goes to the queue of
+ * its thread, other tasks are spread over the queues in turn.
+ * 
+ * The snapshot is shared and never modified, so that the queries need
+ * no lock; they must not modify anything else they share either. The
+ * destructor waits for all the submitted tasks.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+class QueryExecutor {
+
+public:
+
+    /**
+     * Constructor, starting the threads.
+     * 
+     * @param snapshot The snapshot of the graph, shared with the caller
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    QueryExecutor(std::shared_ptr<const GraphSnapshot<T, W>> snapshot, unsigned int threadCount = 0)
+    : snapshot_(std::move(snapshot)), queueVector_(threadCount==0 ? defaultThreadCount() : threadCount),
+      nextQueue_(0), pendingCount_(0), stealCount_(0), stop_(false) {
+        threadVector_.reserve(queueVector_.size());
+        for(unsigned int i=0; i<queueVector_.size(); i++) {
+            threadVector_.emplace_back([this, i]() { run(i); });
+        }
+    }
+
+    QueryExecutor(const QueryExecutor&) = delete;
+
+    QueryExecutor& operator=(const QueryExecutor&) = delete;
+
+    /**
+     * Destructor, waiting for the submitted tasks, then for the threads.
+     */
+    ~QueryExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        condition_.notify_all();
+        for(auto& t : threadVector_) {
+            t.join();
+        }
+    }
+
+    /**
+     * Submit a query.
+     * 
+     * @param query The function called with the snapshot
+     * @return the future of its result, or of the exception it throws
+     */
+    template<class F>
+    auto submit(F&& query) -> std::future<std::invoke_result_t<F&, const GraphSnapshot<T, W>&>> {
+        using R = std::invoke_result_t<F&, const GraphSnapshot<T, W>&>;
+        auto task = std::make_shared<std::packaged_task<R()>>(
+            [this, q = std::forward<F>(query)]() mutable { return q(*snapshot_); });
+        std::future<R> future = task->get_future();
+        push([task]() { (*task)(); });
+        return future;
+    }
+
+    /**
+     * Submit the same query for many inputs, such as many pairs of
+     * vertices. The inputs are grouped in tasks of batchSize, so that
+     * small queries do not pay the scheduling one by one.
+     * 
+     * @param inputVector The inputs, copied
+     * @param query The function called with the snapshot and an input
+     * @param batchSize The number of inputs per task
+     * @return the future of the result of each input, in the same order
+     */
+    template<class I, class F>
+    auto submitBatch(const std::vector<I>& inputVector, F query, std::size_t batchSize = 64)
+    -> std::vector<std::future<std::invoke_result_t<F&, const GraphSnapshot<T, W>&, const I&>>> {
+        using R = std::invoke_result_t<F&, const GraphSnapshot<T, W>&, const I&>;
+        const std::size_t count = inputVector.size();
+        batchSize = std::max<std::size_t>(1, batchSize);
+        auto inputs = std::make_shared<const std::vector<I>>(inputVector);
+        auto promises = std::make_shared<std::vector<std::promise<R>>>(count);
+        std::vector<std::future<R>> futureVector;
+        futureVector.reserve(count);
+        for(auto& p : *promises) {
+            futureVector.push_back(p.get_future());
+        }
+        for(std::size_t begin=0; begin<count; begin+=batchSize) {
+            const std::size_t end = std::min(count, begin + batchSize);
+            push([this, inputs, promises, query, begin, end]() mutable {
+                for(std::size_t i=begin; i<end; i++) {
+                    try {
+                        if constexpr( std::is_void_v<R> ) {
+                            query(*snapshot_, (*inputs)[i]);
+                            (*promises)[i].set_value();
+                        } else {
+                            (*promises)[i].set_value(query(*snapshot_, (*inputs)[i]));
+                        }
+                    } catch(...) {
+                        (*promises)[i].set_exception(std::current_exception());
+                    }
+                }
+            });
+        }
+        return futureVector;
+    }
+
+    /**
+     * @return the snapshot queried
+     */
+    const GraphSnapshot<T, W>& snapshot() const
+    { return *snapshot_; }
+
+    /**
+     * @return the number of threads
+     */
+    std::size_t threadCount() const
+    { return threadVector_.size(); }
+
+    /**
+     * @return the number of tasks taken from the queue of another thread so far
+     */
+    std::size_t stealCount() const
+    { return stealCount_.load(std::memory_order_relaxed); }
+
+
+protected:
+
+    using Task = std::function<void()>;
+
+    /**
+     * Queue of the tasks of a thread.
+     */
+    struct WorkQueue {
+
+        std::mutex
+        mutex_;
+
+        std::deque<Task>
+        taskDeque_;
+
+    };
+
+    /**
+     * The executor and the queue of the calling thread, if it is one of
+     * the threads of an executor.
+     * 
+     * @return the executor, or nullptr, and the queue index
+     */
+    static std::pair<const QueryExecutor*, std::size_t>& worker() {
+        static thread_local std::pair<const QueryExecutor*, std::size_t> current(nullptr, 0);
+        return current;
+    }
+
+    /**
+     * Queue a task and wake a thread up.
+     * 
+     * @param task The task
+     */
+    void push(Task task) {
+        const auto& current = worker();
+        const std::size_t q = current.first==this
+            ? current.second
+            : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queueVector_.size();
+        // Counted first, so that a thread taking it never sees a negative count
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pendingCount_++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queueVector_[q].mutex_);
+            queueVector_[q].taskDeque_.push_back(std::move(task));
+        }
+        condition_.notify_one();
+    }
+
+    /**
+     * Take a task: the newest of the own queue, or else the oldest of
+     * another queue.
+     * 
+     * @param index The queue of the thread
+     * @param task The task taken
+     * @return false if all the queues are empty
+     */
+    bool pop(std::size_t index, Task& task) {
+        {
+            WorkQueue& own = queueVector_[index];
+            std::lock_guard<std::mutex> lock(own.mutex_);
+            if( !own.taskDeque_.empty() ) {
+                task = std::move(own.taskDeque_.back());
+                own.taskDeque_.pop_back();
+                pendingCount_--;
+                return true;
+            }
+        }
+        for(std::size_t k=1; k<queueVector_.size(); k++) {
+            WorkQueue& victim = queueVector_[(index + k) % queueVector_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex_);
+            if( !victim.taskDeque_.empty() ) {
+                task = std::move(victim.taskDeque_.front());
+                victim.taskDeque_.pop_front();
+                pendingCount_--;
+                stealCount_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Loop of a thread, until the executor stops and no task is left.
+     * 
+     * @param index The queue of the thread
+     */
+    void run(std::size_t index) {
+        worker() = std::make_pair(this, index);
+        Task task;
+        for(;;) {
+            if( pop(index, task) ) {
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return stop_ || pendingCount_>0; });
+            if( stop_ && pendingCount_==0 ) {
+                return;
+            }
+        }
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    std::shared_ptr<const GraphSnapshot<T, W>>
+    snapshot_;
+
+    /**
+     * Queue of each thread.
+     */
+    std::vector<WorkQueue>
+    queueVector_;
+
+    /**
+     * The threads.
+     */
+    std::vector<std::thread>
+    threadVector_;
+
+    /**
+     * Counter spreading the tasks submitted from outside over the queues.
+     */
+    std::atomic<std::size_t>
+    nextQueue_;
+
+    /**
+     * Number of tasks queued and not taken yet.
+     */
+    std::atomic<std::size_t>
+    pendingCount_;
+
+    /**
+     * Number of tasks stolen.
+     */
+    std::atomic<std::size_t>
+    stealCount_;
+
+    /**
+     * Whether the executor is being destroyed.
+     */
+    bool
+    stop_;
+
+    /**
+     * Guards stop_ and the increments of pendingCount_ against lost wake-ups.
+     */
+    std::mutex
+    mutex_;
+
+    /**
+     * Where the idle threads wait for tasks.
+     */
+    std::condition_variable
+    condition_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_EXECUTOR_HPP_
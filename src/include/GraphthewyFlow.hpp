@@ -0,0 +1,359 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_FLOW_HPP_
+#define _GRAPH_MODEL_FLOW_HPP_
+
+#include "GraphthewySnapshot.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Maximum flow and minimum cut between two vertices, with Dinic's
+ * algorithm. The weight of each arc is its capacity (1 for an
+ * unweighted graph); an undirected link carries flow both ways, up to
+ * its capacity each way.
+ * 
+ * The residual graph is kept in compact arrays: the arc i of the
+ * snapshot is the residual edge 2i, and its reverse the edge 2i + 1, so
+ * that the reverse of any edge e is e ^ 1.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct MaxFlow {
+
+    using WeightType = typename GraphSnapshot<T, W>::WeightType;
+
+    /**
+     * Constructor, building the residual graph.
+     * 
+     * @param snapshot The snapshot of the graph, with non-negative weights
+     */
+    MaxFlow(const GraphSnapshot<T, W>& snapshot)
+    : snapshot_(snapshot), source_(0), flow_(0) {
+        const std::size_t n = snapshot_.order();
+        const std::size_t m = snapshot_.arcCount();
+        headVector_.resize(2 * m);
+        capacityVector_.resize(2 * m);
+        offsetVector_.assign(n + 1, 0);
+        for(VertexId u=0; u<n; u++) {
+            for(std::size_t a=snapshot_.offsetVector_[u]; a<snapshot_.offsetVector_[u + 1]; a++) {
+                const VertexId v = snapshot_.targetVector_[a];
+                headVector_[2 * a] = v;
+                headVector_[2 * a + 1] = u;
+                offsetVector_[u + 1]++;
+                offsetVector_[v + 1]++;
+            }
+        }
+        for(std::size_t v=0; v<n; v++) {
+            offsetVector_[v + 1] += offsetVector_[v];
+        }
+        edgeVector_.resize(2 * m);
+        std::vector<std::size_t> cursor(offsetVector_.begin(), offsetVector_.end() - 1);
+        for(std::size_t e=0; e<2 * m; e++) {
+            edgeVector_[cursor[headVector_[e ^ 1]]++] = e;
+        }
+        reset();
+    }
+
+    /**
+     * Maximum flow from a vertex to another: breadth-first searches give
+     * the residual distances to the source, then a blocking flow is
+     * pushed along the shortest paths by an iterative depth-first search
+     * which never retries an edge in the same phase. The flow of a
+     * previous call is discarded.
+     * 
+     * @param source The label of the source vertex
+     * @param sink The label of the sink vertex
+     * @return the value of the flow
+     */
+    WeightType maxFlow(const T& source, const T& sink) {
+        GRAPHTHEWY_STATS_TIMER(timer, "maxFlow");
+        const VertexId s = snapshot_.idOf(source);
+        const VertexId t = snapshot_.idOf(sink);
+        reset();
+        source_ = s;
+        if( s==t ) {
+            markSourceSide();
+            return flow_;
+        }
+        std::vector<std::size_t> iteratorVector(snapshot_.order());
+        std::vector<std::size_t> pathVector;
+        while( levelFrom(s, t) ) {
+            GRAPHTHEWY_STATS_VISIT(timer, snapshot_.order(), edgeVector_.size());
+            std::copy(offsetVector_.begin(), offsetVector_.end() - 1, iteratorVector.begin());
+            pathVector.clear();
+            VertexId u = s;
+            for(;;) {
+                if( u==t ) {
+                    WeightType bottleneck = capacityVector_[pathVector.front()];
+                    for(const std::size_t e : pathVector) {
+                        bottleneck = std::min(bottleneck, capacityVector_[e]);
+                    }
+                    std::size_t saturated = pathVector.size();
+                    for(std::size_t i=0; i<pathVector.size(); i++) {
+                        const std::size_t e = pathVector[i];
+                        capacityVector_[e] -= bottleneck;
+                        capacityVector_[e ^ 1] += bottleneck;
+                        if( saturated==pathVector.size() && !(zero<capacityVector_[e]) ) {
+                            saturated = i;
+                        }
+                    }
+                    flow_ += bottleneck;
+                    // Resume from the tail of the first saturated edge
+                    pathVector.resize(saturated);
+                    u = pathVector.empty() ? s : headVector_[pathVector.back()];
+                    continue;
+                }
+                bool advanced = false;
+                for(std::size_t& i=iteratorVector[u]; i<offsetVector_[u + 1]; i++) {
+                    const std::size_t e = edgeVector_[i];
+                    if( zero<capacityVector_[e] && levelVector_[headVector_[e]]==levelVector_[u] + 1 ) {
+                        pathVector.push_back(e);
+                        u = headVector_[e];
+                        advanced = true;
+                        break;
+                    }
+                }
+                if( advanced ) {
+                    continue;
+                }
+                if( u==s ) {
+                    break;
+                }
+                // Dead end for the rest of the phase
+                levelVector_[u] = noLevel;
+                const std::size_t e = pathVector.back();
+                pathVector.pop_back();
+                u = headVector_[e ^ 1];
+                iteratorVector[u]++;
+            }
+        }
+        markSourceSide();
+        return flow_;
+    }
+
+    /**
+     * @return the value of the last flow
+     */
+    WeightType flow() const
+    { return flow_; }
+
+    /**
+     * Flow through an arc, after maxFlow().
+     * 
+     * @param arc the arc index in the snapshot
+     * @return the flow, between 0 and the weight of the arc
+     */
+    WeightType arcFlow(std::size_t arc) const
+    { return snapshot_.weight(arc) - capacityVector_[2 * arc]; }
+
+    /**
+     * Side of a vertex in the minimum cut, after maxFlow().
+     * 
+     * @param label the vertex's label
+     * @return true if the vertex is still reachable from the source in the residual graph
+     */
+    bool isSourceSide(const T& label) const
+    { return sourceSideVector_[snapshot_.idOf(label)]; }
+
+    /**
+     * Vertices of the source side of the minimum cut, after maxFlow().
+     * 
+     * @return their labels, sorted
+     */
+    std::vector<T> sourceSide() const {
+        std::vector<T> labelVector;
+        for(VertexId v=0; v<snapshot_.order(); v++) {
+            if( sourceSideVector_[v] ) {
+                labelVector.push_back(snapshot_.label(v));
+            }
+        }
+        std::sort(labelVector.begin(), labelVector.end());
+        return labelVector;
+    }
+
+    /**
+     * Arcs of the minimum cut, going from the source side to the sink
+     * side, after maxFlow(). Their weights add up to the flow.
+     * 
+     * @return vector of pairs of label corresponding to edge
+     */
+    std::vector<std::pair<T, T>> cutEdgePairList() const {
+        std::vector<std::pair<T, T>> edgePairList;
+        for(VertexId u=0; u<snapshot_.order(); u++) {
+            if( !sourceSideVector_[u] ) {
+                continue;
+            }
+            for(std::size_t a=snapshot_.offsetVector_[u]; a<snapshot_.offsetVector_[u + 1]; a++) {
+                const VertexId v = snapshot_.targetVector_[a];
+                if( !sourceSideVector_[v] && zero<snapshot_.weight(a) ) {
+                    edgePairList.emplace_back(snapshot_.label(u), snapshot_.label(v));
+                }
+            }
+        }
+        return edgePairList;
+    }
+
+
+protected:
+
+    /**
+     * Level of the vertices unreachable in the current phase.
+     */
+    static constexpr std::uint32_t noLevel = std::numeric_limits<std::uint32_t>::max();
+
+    /**
+     * The null capacity.
+     */
+    static constexpr WeightType zero = WeightType(0);
+
+    /**
+     * Restore the capacities of the snapshot, without any flow.
+     */
+    void reset() {
+        for(std::size_t a=0; a<snapshot_.arcCount(); a++) {
+            capacityVector_[2 * a] = snapshot_.weight(a);
+            capacityVector_[2 * a + 1] = zero;
+        }
+        flow_ = zero;
+    }
+
+    /**
+     * Residual distance of each vertex to the source, by breadth-first
+     * search, stopping at the level of the sink.
+     * 
+     * @param s the source
+     * @param t the sink
+     * @return true if the sink is reachable
+     */
+    bool levelFrom(VertexId s, VertexId t) {
+        levelVector_.assign(snapshot_.order(), noLevel);
+        levelVector_[s] = 0;
+        queueVector_.clear();
+        queueVector_.push_back(s);
+        for(std::size_t head=0; head<queueVector_.size(); head++) {
+            const VertexId u = queueVector_[head];
+            if( levelVector_[u]>=levelVector_[t] ) {
+                break;
+            }
+            for(std::size_t i=offsetVector_[u]; i<offsetVector_[u + 1]; i++) {
+                const std::size_t e = edgeVector_[i];
+                const VertexId v = headVector_[e];
+                if( zero<capacityVector_[e] && levelVector_[v]==noLevel ) {
+                    levelVector_[v] = levelVector_[u] + 1;
+                    queueVector_.push_back(v);
+                }
+            }
+        }
+        return levelVector_[t]!=noLevel;
+    }
+
+    /**
+     * Mark the vertices reachable from the source in the residual graph.
+     */
+    void markSourceSide() {
+        sourceSideVector_.assign(snapshot_.order(), false);
+        sourceSideVector_[source_] = true;
+        queueVector_.clear();
+        queueVector_.push_back(source_);
+        for(std::size_t head=0; head<queueVector_.size(); head++) {
+            const VertexId u = queueVector_[head];
+            for(std::size_t i=offsetVector_[u]; i<offsetVector_[u + 1]; i++) {
+                const std::size_t e = edgeVector_[i];
+                if( zero<capacityVector_[e] && !sourceSideVector_[headVector_[e]] ) {
+                    sourceSideVector_[headVector_[e]] = true;
+                    queueVector_.push_back(headVector_[e]);
+                }
+            }
+        }
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * Index in edgeVector_ of the first residual edge of each vertex,
+     * plus the total number of residual edges.
+     */
+    std::vector<std::size_t>
+    offsetVector_;
+
+    /**
+     * Residual edges of each vertex, by source.
+     */
+    std::vector<std::size_t>
+    edgeVector_;
+
+    /**
+     * Head of each residual edge.
+     */
+    std::vector<VertexId>
+    headVector_;
+
+    /**
+     * Residual capacity of each residual edge.
+     */
+    std::vector<WeightType>
+    capacityVector_;
+
+    /**
+     * Residual distance of each vertex to the source.
+     */
+    std::vector<std::uint32_t>
+    levelVector_;
+
+    /**
+     * Queue of the breadth-first searches.
+     */
+    std::vector<VertexId>
+    queueVector_;
+
+    /**
+     * Whether each vertex is on the source side of the minimum cut.
+     */
+    std::vector<bool>
+    sourceSideVector_;
+
+    /**
+     * The source of the last flow.
+     */
+    VertexId
+    source_;
+
+    /**
+     * The value of the last flow.
+     */
+    WeightType
+    flow_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_FLOW_HPP_
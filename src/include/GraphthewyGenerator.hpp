@@ -0,0 +1,315 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_GENERATOR_HPP_
+#define _GRAPH_MODEL_GENERATOR_HPP_
+
+#include "GraphthewyParallel.hpp"
+#include "GraphthewyStats.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Counter-based random number: a hash of a seed and of counters, so
+ * that any draw can be computed independently of the others, by any
+ * thread, in any order (SplitMix64 finalizer).
+ * 
+ * @param seed The seed
+ * @param counter The number of the draw
+ * @param lane A second counter, for the draws that need several numbers
+ * @return 64 random bits
+ */
+inline std::uint64_t counterRandom(std::uint64_t seed, std::uint64_t counter, std::uint64_t lane = 0) {
+    std::uint64_t x = seed ^ (counter * 0x9e3779b97f4a7c15ull) ^ (lane * 0xd1b54a32d192ed03ull);
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    x += 0x9e3779b97f4a7c15ull;
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Counter-based random number in [0, 1).
+ * 
+ * @param seed The seed
+ * @param counter The number of the draw
+ * @param lane A second counter
+ * @return the number
+ */
+inline double counterUniform(std::uint64_t seed, std::uint64_t counter, std::uint64_t lane = 0) {
+    return static_cast<double>(counterRandom(seed, counter, lane) >> 11) * 0x1.0p-53;
+}
+
+/**
+ * Counter-based random integer in [0, bound).
+ * 
+ * @param seed The seed
+ * @param counter The number of the draw
+ * @param lane A second counter
+ * @param bound The exclusive upper bound, not 0
+ * @return the integer
+ */
+inline std::uint64_t counterBelow(std::uint64_t seed, std::uint64_t counter, std::uint64_t lane, std::uint64_t bound) {
+    return std::min<std::uint64_t>(bound - 1, static_cast<std::uint64_t>(counterUniform(seed, counter, lane) * static_cast<double>(bound)));
+}
+
+
+/**
+ * Seedable generators of synthetic graphs, as edge lists to give to
+ * UndirectedGraph::addEdgeList, DirectedGraph::addEdgeList or
+ * GraphSnapshot::fromEdgeList.
+ * 
+ * Vertices are numbered from 0 and labelled by their number converted
+ * to T; a vertex without any link does not appear in the list. Every
+ * edge is drawn from counterRandom(seed, edge number), so the edges are
+ * generated in parallel and the result only depends on the seed, not on
+ * the number of threads.
+ * 
+ * Template argument:
+ * - T = the type of the vertex's label, built from an integer
+ */
+template<class T = std::uint64_t>
+struct GraphGenerator {
+
+    /**
+     * Constructor
+     * 
+     * @param seed The seed of the draws
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    GraphGenerator(std::uint64_t seed, unsigned int threadCount = 0)
+    : seed_(seed), threadCount_(threadCount) { }
+
+    /**
+     * Erdős–Rényi G(n, m) graph: edgeCount edges with both ends drawn
+     * uniformly, without self-loops. Repeated edges are possible, rare
+     * on sparse graphs.
+     * 
+     * @param vertexCount The number of vertices, at least 2
+     * @param edgeCount The number of edges
+     * @return the edge list
+     */
+    std::vector<std::pair<T, T>> erdosRenyi(std::size_t vertexCount, std::size_t edgeCount) const {
+        GRAPHTHEWY_STATS_TIMER(timer, "generateErdosRenyi");
+        if( vertexCount<2 ) {
+            throw std::runtime_error("graphthewy: at least 2 vertices are needed");
+        }
+        std::vector<std::pair<T, T>> edgeList(edgeCount);
+        forEachEdge(edgeCount, [&](std::size_t i) {
+            const std::uint64_t u = counterBelow(seed_, i, 0, vertexCount);
+            // Drawn among the others, so that there is no self-loop
+            std::uint64_t v = counterBelow(seed_, i, 1, vertexCount - 1);
+            v += v>=u ? 1 : 0;
+            edgeList[i] = std::make_pair(T(u), T(v));
+        });
+        return edgeList;
+    }
+
+    /**
+     * R-MAT (recursive matrix, Kronecker-like) graph: each edge falls
+     * in one of the four quadrants of the adjacency matrix with the
+     * probabilities a, b, c and 1 - a - b - c, recursively, giving the
+     * skewed degrees and communities of real networks. Self-loops and
+     * repeated edges are kept.
+     * 
+     * @param scale The base 2 logarithm of the number of vertices
+     * @param edgeCount The number of edges
+     * @param a The probability of the top left quadrant
+     * @param b The probability of the top right quadrant
+     * @param c The probability of the bottom left quadrant
+     * @return the edge list
+     */
+    std::vector<std::pair<T, T>> rmat(unsigned int scale, std::size_t edgeCount, double a = 0.57, double b = 0.19, double c = 0.19) const {
+        GRAPHTHEWY_STATS_TIMER(timer, "generateRmat");
+        if( scale>63 || a<0 || b<0 || c<0 || a + b + c>1 ) {
+            throw std::runtime_error("graphthewy: bad R-MAT parameters");
+        }
+        std::vector<std::pair<T, T>> edgeList(edgeCount);
+        forEachEdge(edgeCount, [&](std::size_t i) {
+            std::uint64_t u = 0;
+            std::uint64_t v = 0;
+            std::uint64_t bits = 0;
+            for(unsigned int level=0; level<scale; level++) {
+                // 32 random bits per level are plenty, so a draw serves two levels
+                if( level % 2==0 ) {
+                    bits = counterRandom(seed_, i, level / 2);
+                }
+                const double r = static_cast<double>((level % 2==0 ? bits : bits >> 32) & 0xffffffffull) * 0x1.0p-32;
+                u = (u << 1) | (r>=a + b ? 1 : 0);
+                v = (v << 1) | ((r>=a && r<a + b) || r>=a + b + c ? 1 : 0);
+            }
+            edgeList[i] = std::make_pair(T(u), T(v));
+        });
+        return edgeList;
+    }
+
+    /**
+     * Barabási–Albert preferential attachment graph: each vertex links
+     * to linkCount earlier vertices chosen with a probability
+     * proportional to their degree. This is the edge copy model of
+     * Batagelj and Brandes, where the target of an edge is an end of an
+     * earlier edge drawn uniformly; the chains of copies are resolved by
+     * each thread on its own, as every draw can be replayed. Self-loops
+     * and repeated edges are kept, as in the model.
+     * 
+     * @param vertexCount The number of vertices
+     * @param linkCount The number of links added with each vertex, at least 1
+     * @return the edge list
+     */
+    std::vector<std::pair<T, T>> barabasiAlbert(std::size_t vertexCount, std::size_t linkCount) const {
+        GRAPHTHEWY_STATS_TIMER(timer, "generateBarabasiAlbert");
+        if( linkCount==0 ) {
+            throw std::runtime_error("graphthewy: at least 1 link per vertex is needed");
+        }
+        std::vector<std::pair<T, T>> edgeList(vertexCount * linkCount);
+        forEachEdge(edgeList.size(), [&](std::size_t i) {
+            // The ends of the edges are the slots 2i (the new vertex) and
+            // 2i + 1 (a copy of any earlier slot)
+            std::uint64_t slot = 2 * i + 1;
+            while( slot % 2==1 ) {
+                slot = counterBelow(seed_, slot / 2, 0, slot);
+            }
+            edgeList[i] = std::make_pair(T(i / linkCount), T(slot / 2 / linkCount));
+        });
+        return edgeList;
+    }
+
+    /**
+     * Two dimensional grid: each vertex r * columnCount + c is linked to
+     * its right and bottom neighbors. Deterministic, the seed is unused.
+     * 
+     * @param rowCount The number of rows
+     * @param columnCount The number of columns
+     * @return the edge list, row by row
+     */
+    std::vector<std::pair<T, T>> grid(std::size_t rowCount, std::size_t columnCount) const {
+        GRAPHTHEWY_STATS_TIMER(timer, "generateGrid");
+        if( rowCount==0 || columnCount==0 ) {
+            return {};
+        }
+        // Each row r but the last one holds columnCount - 1 horizontal and
+        // columnCount vertical edges
+        const std::size_t rowEdgeCount = 2 * columnCount - 1;
+        std::vector<std::pair<T, T>> edgeList(rowCount * rowEdgeCount - columnCount);
+        parallelChunks(rowCount, threadCount_, [&](unsigned int, std::size_t begin, std::size_t end) {
+            for(std::size_t r=begin; r<end; r++) {
+                std::size_t i = r * rowEdgeCount;
+                for(std::size_t c=0; c<columnCount; c++) {
+                    const std::uint64_t u = r * columnCount + c;
+                    if( c + 1<columnCount ) {
+                        edgeList[i++] = std::make_pair(T(u), T(u + 1));
+                    }
+                    if( r + 1<rowCount ) {
+                        edgeList[i++] = std::make_pair(T(u), T(u + columnCount));
+                    }
+                }
+            }
+        });
+        return edgeList;
+    }
+
+    /**
+     * Random directed acyclic graph: edgeCount arcs between distinct
+     * vertices drawn uniformly, each going from the lower to the higher
+     * number, followed by cycleCount injected cycles. An injected cycle
+     * goes through cycleLength distinct vertices in increasing order,
+     * then back to the first one, so that GraphCycle can be measured on
+     * graphs with a known number of cycles. Only the arcs of the
+     * injected cycles may close a cycle.
+     * 
+     * @param vertexCount The number of vertices, at least 2 and at least cycleLength
+     * @param edgeCount The number of acyclic arcs
+     * @param cycleCount The number of cycles to inject
+     * @param cycleLength The number of vertices of each injected cycle, at least 2
+     * @return the arc list, the cycleCount * cycleLength injected arcs last
+     */
+    std::vector<std::pair<T, T>> randomDag(std::size_t vertexCount, std::size_t edgeCount, std::size_t cycleCount = 0, std::size_t cycleLength = 3) const {
+        GRAPHTHEWY_STATS_TIMER(timer, "generateRandomDag");
+        if( vertexCount<2 || (cycleCount>0 && (cycleLength<2 || cycleLength>vertexCount)) ) {
+            throw std::runtime_error("graphthewy: bad random DAG parameters");
+        }
+        std::vector<std::pair<T, T>> edgeList(edgeCount + cycleCount * cycleLength);
+        forEachEdge(edgeCount, [&](std::size_t i) {
+            const std::uint64_t u = counterBelow(seed_, i, 0, vertexCount);
+            std::uint64_t v = counterBelow(seed_, i, 1, vertexCount - 1);
+            v += v>=u ? 1 : 0;
+            edgeList[i] = std::make_pair(T(std::min(u, v)), T(std::max(u, v)));
+        });
+        forEachEdge(cycleCount, [&](std::size_t k) {
+            // Distinct vertices by rejection, cycleLength being small
+            std::vector<std::uint64_t> cycle;
+            for(std::uint64_t draw=0; cycle.size()<cycleLength; draw++) {
+                const std::uint64_t v = counterBelow(seed_, edgeCount + k, draw, vertexCount);
+                if( std::find(cycle.begin(), cycle.end(), v)==cycle.end() ) {
+                    cycle.push_back(v);
+                }
+            }
+            std::sort(cycle.begin(), cycle.end());
+            const std::size_t base = edgeCount + k * cycleLength;
+            for(std::size_t j=0; j<cycleLength; j++) {
+                edgeList[base + j] = std::make_pair(T(cycle[j]), T(cycle[(j + 1) % cycleLength]));
+            }
+        });
+        return edgeList;
+    }
+
+
+protected:
+
+    /**
+     * Run f(i) on each edge number of [0, edgeCount), in parallel.
+     * 
+     * @param edgeCount The number of edges
+     * @param f The function to call on each edge number
+     */
+    template<class F>
+    void forEachEdge(std::size_t edgeCount, F&& f) const {
+        parallelChunks(edgeCount, threadCount_, [&](unsigned int, std::size_t begin, std::size_t end) {
+            for(std::size_t i=begin; i<end; i++) {
+                f(i);
+            }
+        });
+    }
+
+
+protected:
+
+    /**
+     * The seed of the draws.
+     */
+    std::uint64_t
+    seed_;
+
+    /**
+     * The number of threads, 0 for the hardware concurrency.
+     */
+    unsigned int
+    threadCount_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_GENERATOR_HPP_
@@ -0,0 +1,213 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_INTERSECTION_HPP_
+#define _GRAPH_MODEL_INTERSECTION_HPP_
+
+#include "GraphthewySnapshot.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define GRAPHTHEWY_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+
+
+namespace graphthewy {
+
+/**
+ * Instruction sets usable by the intersection kernels.
+ */
+enum class SimdLevel { Scalar, Sse4, Avx2 };
+
+/**
+ * Best instruction set supported by the running processor, detected
+ * once.
+ * 
+ * @return the instruction set
+ */
+inline SimdLevel simdLevel() {
+#ifdef GRAPHTHEWY_X86_SIMD
+    static const SimdLevel level = __builtin_cpu_supports("avx2") ? SimdLevel::Avx2
+        : __builtin_cpu_supports("sse4.2") ? SimdLevel::Sse4 : SimdLevel::Scalar;
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+/**
+ * Size of the intersection of two sorted lists, by merging.
+ * 
+ * @param a The first list, strictly increasing
+ * @param na The size of the first list
+ * @param b The second list, strictly increasing
+ * @param nb The size of the second list
+ * @return the number of common elements
+ */
+inline std::size_t intersectionSizeScalar(const VertexId* a, std::size_t na, const VertexId* b, std::size_t nb) {
+    std::size_t i = 0, j = 0, count = 0;
+    while( i<na && j<nb ) {
+        if( a[i]<b[j] ) {
+            i++;
+        } else if( b[j]<a[i] ) {
+            j++;
+        } else {
+            count++;
+            i++;
+            j++;
+        }
+    }
+    return count;
+}
+
+/**
+ * Size of the intersection of a short sorted list with a much longer
+ * one, by galloping searches in the longer one.
+ * 
+ * @param a The short list, strictly increasing
+ * @param na The size of the short list
+ * @param b The long list, strictly increasing
+ * @param nb The size of the long list
+ * @return the number of common elements
+ */
+inline std::size_t intersectionSizeGalloping(const VertexId* a, std::size_t na, const VertexId* b, std::size_t nb) {
+    std::size_t count = 0;
+    const VertexId* end = b + nb;
+    for(std::size_t i=0; i<na && b<end; i++) {
+        std::size_t step = 1;
+        while( b + step<end && b[step]<a[i] ) {
+            step *= 2;
+        }
+        b = std::lower_bound(b + step / 2, std::min(b + step + 1, end), a[i]);
+        if( b<end && *b==a[i] ) {
+            count++;
+            b++;
+        }
+    }
+    return count;
+}
+
+#ifdef GRAPHTHEWY_X86_SIMD
+
+/**
+ * Size of the intersection of two sorted lists, comparing blocks of 4
+ * elements against the 4 rotations of each other (SSE4.2).
+ * 
+ * @param a The first list, strictly increasing
+ * @param na The size of the first list
+ * @param b The second list, strictly increasing
+ * @param nb The size of the second list
+ * @return the number of common elements
+ */
+__attribute__((target("sse4.2,popcnt")))
+inline std::size_t intersectionSizeSse4(const VertexId* a, std::size_t na, const VertexId* b, std::size_t nb) {
+    std::size_t i = 0, j = 0, count = 0;
+    while( i + 4<=na && j + 4<=nb ) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        __m128i match = _mm_cmpeq_epi32(va, vb);
+        match = _mm_or_si128(match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x39)));
+        match = _mm_or_si128(match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x4e)));
+        match = _mm_or_si128(match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x93)));
+        count += static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(match)))));
+        const VertexId aLast = a[i + 3], bLast = b[j + 3];
+        i += aLast<=bLast ? 4 : 0;
+        j += bLast<=aLast ? 4 : 0;
+    }
+    return count + intersectionSizeScalar(a + i, na - i, b + j, nb - j);
+}
+
+/**
+ * Size of the intersection of two sorted lists, comparing blocks of 8
+ * elements against the 8 rotations of each other (AVX2).
+ * 
+ * @param a The first list, strictly increasing
+ * @param na The size of the first list
+ * @param b The second list, strictly increasing
+ * @param nb The size of the second list
+ * @return the number of common elements
+ */
+__attribute__((target("avx2,popcnt")))
+inline std::size_t intersectionSizeAvx2(const VertexId* a, std::size_t na, const VertexId* b, std::size_t nb) {
+    std::size_t i = 0, j = 0, count = 0;
+    const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+    while( i + 8<=na && j + 8<=nb ) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        __m256i match = _mm256_cmpeq_epi32(va, vb);
+        for(int r=1; r<8; r++) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+        }
+        count += static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(match)))));
+        const VertexId aLast = a[i + 7], bLast = b[j + 7];
+        i += aLast<=bLast ? 8 : 0;
+        j += bLast<=aLast ? 8 : 0;
+    }
+    return count + intersectionSizeSse4(a + i, na - i, b + j, nb - j);
+}
+
+#endif
+
+/**
+ * Size of the intersection of two sorted lists, with a given kernel.
+ * Lists of very different sizes are intersected by galloping.
+ * 
+ * @param a The first list, strictly increasing
+ * @param na The size of the first list
+ * @param b The second list, strictly increasing
+ * @param nb The size of the second list
+ * @param level The instruction set, at most simdLevel()
+ * @return the number of common elements
+ */
+inline std::size_t intersectionSize(const VertexId* a, std::size_t na, const VertexId* b, std::size_t nb, SimdLevel level) {
+    if( na>nb ) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if( na * 32<nb ) {
+        return intersectionSizeGalloping(a, na, b, nb);
+    }
+#ifdef GRAPHTHEWY_X86_SIMD
+    if( level==SimdLevel::Avx2 ) {
+        return intersectionSizeAvx2(a, na, b, nb);
+    }
+    if( level==SimdLevel::Sse4 ) {
+        return intersectionSizeSse4(a, na, b, nb);
+    }
+#else
+    (void)level;
+#endif
+    return intersectionSizeScalar(a, na, b, nb);
+}
+
+/**
+ * Size of the intersection of two sorted lists, with the best kernel
+ * supported by the processor.
+ * 
+ * @param a The first list, strictly increasing
+ * @param na The size of the first list
+ * @param b The second list, strictly increasing
+ * @param nb The size of the second list
+ * @return the number of common elements
+ */
+inline std::size_t intersectionSize(const VertexId* a, std::size_t na, const VertexId* b, std::size_t nb) {
+    return intersectionSize(a, na, b, nb, simdLevel());
+}
+
+}
+
+
+#endif // _GRAPH_MODEL_INTERSECTION_HPP_
@@ -0,0 +1,855 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_JOURNAL_HPP_
+#define _GRAPH_MODEL_JOURNAL_HPP_
+
+#include "GraphthewyModel.hpp"
+#include "GraphthewyCompressed.hpp"
+#include "GraphthewyDelta.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GRAPHTHEWY_POSIX 1
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+namespace graphthewy {
+
+/**
+ * Read an unsigned integer in LEB128 varint encoding, checking the end
+ * of the bytes.
+ * 
+ * @param p The current position, moved after the integer
+ * @param end The end of the bytes
+ * @return the integer
+ */
+inline std::uint64_t readJournalVarint(const std::uint8_t*& p, const std::uint8_t* end) {
+    std::uint64_t value = 0;
+    for(unsigned int shift=0; p<end && shift<64; shift+=7) {
+        const std::uint8_t b = *p++;
+        value |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+        if( !(b & 0x80) ) {
+            return value;
+        }
+    }
+    throw std::runtime_error("graphthewy: truncated journal record");
+}
+
+/**
+ * Binary encoding of a label or a weight in the journal and the
+ * checkpoints. Specialize it for other types.
+ * 
+ * Template argument:
+ * - X = the encoded type
+ */
+template<class X, class = void>
+struct BinaryCodec;
+
+/**
+ * Binary encoding of an arithmetic type: its bytes, in host order.
+ */
+template<class X>
+struct BinaryCodec<X, std::enable_if_t<std::is_arithmetic_v<X>>> {
+
+    /**
+     * @param x The value
+     * @param byteVector The bytes to append to
+     */
+    static void write(const X& x, std::vector<std::uint8_t>& byteVector) {
+        const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(&x);
+        byteVector.insert(byteVector.end(), p, p + sizeof(X));
+    }
+
+    /**
+     * @param p The current position, moved after the value
+     * @param end The end of the bytes
+     * @return the value
+     */
+    static X read(const std::uint8_t*& p, const std::uint8_t* end) {
+        if( end - p<static_cast<std::ptrdiff_t>(sizeof(X)) ) {
+            throw std::runtime_error("graphthewy: truncated journal record");
+        }
+        X x;
+        std::memcpy(&x, p, sizeof(X));
+        p += sizeof(X);
+        return x;
+    }
+
+};
+
+/**
+ * Binary encoding of a string: its length as a varint, then its characters.
+ */
+template<class C, class Tr, class A>
+struct BinaryCodec<std::basic_string<C, Tr, A>> {
+
+    /**
+     * @param x The value
+     * @param byteVector The bytes to append to
+     */
+    static void write(const std::basic_string<C, Tr, A>& x, std::vector<std::uint8_t>& byteVector) {
+        writeVarint(x.size(), byteVector);
+        const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(x.data());
+        byteVector.insert(byteVector.end(), p, p + x.size() * sizeof(C));
+    }
+
+    /**
+     * @param p The current position, moved after the value
+     * @param end The end of the bytes
+     * @return the value
+     */
+    static std::basic_string<C, Tr, A> read(const std::uint8_t*& p, const std::uint8_t* end) {
+        const std::uint64_t size = readJournalVarint(p, end);
+        if( static_cast<std::uint64_t>(end - p) / sizeof(C)<size ) {
+            throw std::runtime_error("graphthewy: truncated journal record");
+        }
+        std::basic_string<C, Tr, A> x(static_cast<std::size_t>(size), C());
+        std::memcpy(&x[0], p, x.size() * sizeof(C));
+        p += x.size() * sizeof(C);
+        return x;
+    }
+
+};
+
+
+/**
+ * 32-bit FNV-1a hash, the checksum of the journal records and of the
+ * checkpoints.
+ * 
+ * @param p The bytes
+ * @param size The number of bytes
+ * @return the checksum
+ */
+inline std::uint32_t journalChecksum(const std::uint8_t* p, std::size_t size) {
+    std::uint32_t h = 2166136261u;
+    for(std::size_t i=0; i<size; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+/**
+ * Read a whole file.
+ * 
+ * @param path The path of the file
+ * @param byteVector The bytes read
+ * @return false if the file does not exist
+ */
+inline bool readJournalFile(const std::string& path, std::vector<std::uint8_t>& byteVector) {
+    std::ifstream in(path, std::ios::binary);
+    if( !in ) {
+        return false;
+    }
+    byteVector.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+
+/**
+ * File opened for appending, whose writes can be made durable. Without
+ * POSIX, sync() only flushes the C library buffers.
+ */
+class JournalFile {
+
+public:
+
+    /**
+     * Constructor, not opening any file.
+     */
+    JournalFile()
+#ifdef GRAPHTHEWY_POSIX
+    : fd_(-1) { }
+#else
+    : file_(nullptr) { }
+#endif
+
+    JournalFile(const JournalFile&) = delete;
+
+    JournalFile& operator=(const JournalFile&) = delete;
+
+    ~JournalFile()
+    { close(); }
+
+    /**
+     * Open a file for appending, creating it if needed.
+     * 
+     * @param path The path of the file
+     */
+    void open(const std::string& path) {
+        close();
+#ifdef GRAPHTHEWY_POSIX
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if( fd_<0 ) {
+            throw std::runtime_error("graphthewy: cannot open " + path);
+        }
+#else
+        file_ = std::fopen(path.c_str(), "ab");
+        if( file_==nullptr ) {
+            throw std::runtime_error("graphthewy: cannot open " + path);
+        }
+#endif
+    }
+
+    /**
+     * @return true if a file is open
+     */
+    bool isOpen() const {
+#ifdef GRAPHTHEWY_POSIX
+        return fd_>=0;
+#else
+        return file_!=nullptr;
+#endif
+    }
+
+    /**
+     * Append bytes at the end of the file.
+     * 
+     * @param p The bytes
+     * @param size The number of bytes
+     */
+    void append(const std::uint8_t* p, std::size_t size) {
+#ifdef GRAPHTHEWY_POSIX
+        while( size>0 ) {
+            const ssize_t n = ::write(fd_, p, size);
+            if( n<0 ) {
+                throw std::runtime_error("graphthewy: journal write failed");
+            }
+            p += n;
+            size -= static_cast<std::size_t>(n);
+        }
+#else
+        if( std::fwrite(p, 1, size, file_)!=size ) {
+            throw std::runtime_error("graphthewy: journal write failed");
+        }
+#endif
+    }
+
+    /**
+     * Make the appended bytes durable.
+     */
+    void sync() {
+#ifdef GRAPHTHEWY_POSIX
+        if( ::fsync(fd_)!=0 ) {
+            throw std::runtime_error("graphthewy: journal sync failed");
+        }
+#else
+        std::fflush(file_);
+#endif
+    }
+
+    /**
+     * Cut the file to a size.
+     * 
+     * @param path The path of the file, for the reopening if needed
+     * @param size The new size
+     */
+    void truncate(const std::string& path, std::size_t size) {
+#ifdef GRAPHTHEWY_POSIX
+        (void)path;
+        if( ::ftruncate(fd_, static_cast<off_t>(size))!=0 || ::fsync(fd_)!=0 ) {
+            throw std::runtime_error("graphthewy: journal truncation failed");
+        }
+#else
+        std::vector<std::uint8_t> byteVector;
+        readJournalFile(path, byteVector);
+        byteVector.resize(std::min(size, byteVector.size()));
+        std::fclose(file_);
+        file_ = std::fopen(path.c_str(), "wb");
+        if( file_==nullptr ) {
+            throw std::runtime_error("graphthewy: cannot open " + path);
+        }
+        append(byteVector.data(), byteVector.size());
+        std::fclose(file_);
+        open(path);
+#endif
+    }
+
+    /**
+     * Close the file, if open.
+     */
+    void close() {
+#ifdef GRAPHTHEWY_POSIX
+        if( fd_>=0 ) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+#else
+        if( file_!=nullptr ) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+#endif
+    }
+
+    /**
+     * Replace a file by new content, atomically: the content is written
+     * to a temporary file, made durable, then renamed over the file.
+     * 
+     * @param path The path of the file
+     * @param byteVector The new content
+     */
+    static void replace(const std::string& path, const std::vector<std::uint8_t>& byteVector) {
+        const std::string temporaryPath = path + ".tmp";
+        std::remove(temporaryPath.c_str());
+        JournalFile file;
+        file.open(temporaryPath);
+        file.append(byteVector.data(), byteVector.size());
+        file.sync();
+        file.close();
+#ifdef GRAPHTHEWY_POSIX
+        if( std::rename(temporaryPath.c_str(), path.c_str())!=0 ) {
+            throw std::runtime_error("graphthewy: cannot rename " + temporaryPath);
+        }
+        // Make the rename itself durable
+        const std::size_t slash = path.find_last_of('/');
+        const std::string directory = slash==std::string::npos ? "." : path.substr(0, slash + 1);
+        const int fd = ::open(directory.c_str(), O_RDONLY);
+        if( fd>=0 ) {
+            ::fsync(fd);
+            ::close(fd);
+        }
+#else
+        std::remove(path.c_str());
+        if( std::rename(temporaryPath.c_str(), path.c_str())!=0 ) {
+            throw std::runtime_error("graphthewy: cannot rename " + temporaryPath);
+        }
+#endif
+    }
+
+
+protected:
+
+#ifdef GRAPHTHEWY_POSIX
+    /**
+     * The file descriptor, -1 if closed.
+     */
+    int
+    fd_;
+#else
+    /**
+     * The file, nullptr if closed.
+     */
+    std::FILE*
+    file_;
+#endif
+
+};
+
+
+/**
+ * Write-ahead journal of the mutations of a graph, for crash recovery.
+ * 
+ * The mutations are made through the journal, which applies them to the
+ * graph and appends them to the log file, "journal" in its directory.
+ * The records are buffered and written with a single fsync every
+ * groupSize records (group commit), or on commit(): a mutation is
+ * durable once committed. A checkpoint writes the whole graph to the
+ * "checkpoint" file, atomically, then empties the log. recover() loads
+ * the latest checkpoint and replays the records logged after it; a torn
+ * record at the end of the log, from a crash during a write, is dropped.
+ * 
+ * The records and checkpoints are in host byte order; the labels and
+ * weights are encoded by BinaryCodec.
+ * 
+ * Templates arguments:
+ * - G = UndirectedGraph or DirectedGraph
+ * - T = the type that G has been templated with
+ * - W = the weight type that G has been templated with, void (default) if unweighted
+ */
+template<template<class, class> class G, class T, class W = void>
+class GraphJournal {
+
+public:
+
+    /**
+     * Constructor, not opening any file: call recover() first.
+     * 
+     * @param graph The graph, empty until recover()
+     * @param directory The directory of the files, created if needed
+     * @param groupSize The number of records written by each fsync
+     * @param checkpointInterval The number of records between automatic checkpoints, 0 for none
+     */
+    GraphJournal(G<T, W>& graph, const std::string& directory, std::size_t groupSize = 64, std::size_t checkpointInterval = 0)
+    : graph_(graph), journalPath_(directory + "/journal"), checkpointPath_(directory + "/checkpoint"),
+      groupSize_(groupSize==0 ? 1 : groupSize), checkpointInterval_(checkpointInterval),
+      sequence_(0), pendingCount_(0), recordCount_(0) {
+#ifdef GRAPHTHEWY_POSIX
+        ::mkdir(directory.c_str(), 0755);
+#endif
+    }
+
+    GraphJournal(const GraphJournal&) = delete;
+
+    GraphJournal& operator=(const GraphJournal&) = delete;
+
+    /**
+     * Destructor, committing the pending records.
+     */
+    ~GraphJournal() {
+        try {
+            commit();
+        } catch(const std::exception&) { }
+    }
+
+    /**
+     * Load the latest checkpoint into the graph, which must be empty,
+     * replay the records logged after it, and open the log.
+     * 
+     * @return the number of records replayed
+     */
+    std::size_t recover() {
+        if( graph_.order()!=0 ) {
+            throw std::runtime_error("graphthewy: recovery needs an empty graph");
+        }
+        std::vector<std::uint8_t> byteVector;
+        std::uint64_t checkpointSequence = 0;
+        if( readJournalFile(checkpointPath_, byteVector) ) {
+            checkpointSequence = loadCheckpoint(byteVector);
+        }
+        sequence_ = checkpointSequence;
+        std::size_t replayed = 0;
+        std::size_t validSize = 0;
+        const bool exists = readJournalFile(journalPath_, byteVector);
+        if( exists ) {
+            const std::uint8_t* p = byteVector.data();
+            const std::uint8_t* end = p + byteVector.size();
+            while( end - p>=8 ) {
+                std::uint32_t size, checksum;
+                std::memcpy(&size, p, 4);
+                std::memcpy(&checksum, p + 4, 4);
+                if( static_cast<std::size_t>(end - p - 8)<size || journalChecksum(p + 8, size)!=checksum ) {
+                    break;
+                }
+                const std::uint8_t* q = p + 8;
+                const std::uint64_t sequence = BinaryCodec<std::uint64_t>::read(q, p + 8 + size);
+                if( sequence>checkpointSequence ) {
+                    replay(q, p + 8 + size);
+                    sequence_ = sequence;
+                    replayed++;
+                }
+                p += 8 + size;
+            }
+            validSize = static_cast<std::size_t>(p - byteVector.data());
+        }
+        file_.open(journalPath_);
+        if( exists && validSize<byteVector.size() ) {
+            file_.truncate(journalPath_, validSize);
+        }
+        recordCount_ = replayed;
+        return replayed;
+    }
+
+    /**
+     * Add a vertex, and log it.
+     * 
+     * @param label the vertex's label
+     */
+    void addVertex(const T& label) {
+        graph_.addVertex(label);
+        log(DeltaKind::AddVertex, label, label, nullptr);
+    }
+
+    /**
+     * Remove a vertex and its links, and log it.
+     * 
+     * @param label the vertex's label
+     * @return false if there was no such vertex
+     */
+    bool removeVertex(const T& label) {
+        const bool removed = graph_.removeVertex(label);
+        log(DeltaKind::RemoveVertex, label, label, nullptr);
+        return removed;
+    }
+
+    /**
+     * Create a link, and log it.
+     * 
+     * @param e1 the main vertex's label
+     * @param e2 the second vertex's label
+     * @return false if a vertex is missing or the edge policy rejected the link
+     */
+    bool link(const T& e1, const T& e2) {
+        const bool linked = graph_.link(e1, e2);
+        if constexpr( !std::is_void_v<W> ) {
+            const W weight(1);
+            log(DeltaKind::Link, e1, e2, &weight);
+        } else {
+            log(DeltaKind::Link, e1, e2, nullptr);
+        }
+        return linked;
+    }
+
+    /**
+     * Create a weighted link, and log it.
+     * 
+     * @param e1 the main vertex's label
+     * @param e2 the second vertex's label
+     * @param weight the weight of the link
+     * @return false if a vertex is missing or the edge policy rejected the link
+     */
+    template<class U = W, class = std::enable_if_t<!std::is_void_v<U>>>
+    bool link(const T& e1, const T& e2, const U& weight) {
+        const bool linked = graph_.link(e1, e2, weight);
+        log(DeltaKind::Link, e1, e2, &weight);
+        return linked;
+    }
+
+    /**
+     * Remove a link, and log it.
+     * 
+     * @param e1 the main vertex's label
+     * @param e2 the second vertex's label
+     * @return false if there was no such link
+     */
+    bool unlink(const T& e1, const T& e2) {
+        const bool unlinked = graph_.unlink(e1, e2);
+        log(DeltaKind::Unlink, e1, e2, nullptr);
+        return unlinked;
+    }
+
+    /**
+     * Apply a batch of mutations, and log it as a single record.
+     * 
+     * @param delta The mutations
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the inverse batch
+     */
+    GraphDelta<T, W> apply(const GraphDelta<T, W>& delta, unsigned int threadCount = 0) {
+        GraphDelta<T, W> inverse = delta.apply(graph_, threadCount);
+        const std::size_t begin = beginRecord(true, delta.size());
+        for(std::size_t i=0; i<delta.size(); i++) {
+            const DeltaOperation<T>& o = delta.operationVector()[i];
+            if constexpr( !std::is_void_v<W> ) {
+                writeOperation(o.kind_, o.source_, o.target_, &delta.weightVector_[i]);
+            } else {
+                writeOperation(o.kind_, o.source_, o.target_, nullptr);
+            }
+        }
+        endRecord(begin);
+        return inverse;
+    }
+
+    /**
+     * Write the pending records, with a single fsync.
+     */
+    void commit() {
+        if( pendingCount_==0 ) {
+            return;
+        }
+        if( !file_.isOpen() ) {
+            throw std::runtime_error("graphthewy: journal not recovered");
+        }
+        GRAPHTHEWY_STATS_TIMER(timer, "journalCommit");
+        GRAPHTHEWY_STATS_VISIT(timer, 0, pendingCount_);
+        file_.append(pendingVector_.data(), pendingVector_.size());
+        file_.sync();
+        pendingVector_.clear();
+        pendingCount_ = 0;
+    }
+
+    /**
+     * Write the whole graph to the checkpoint file, atomically, then
+     * empty the log.
+     */
+    void checkpoint() {
+        commit();
+        GRAPHTHEWY_STATS_TIMER(timer, "checkpoint");
+        std::vector<std::uint8_t> byteVector;
+        const char magic[8] = {'G', 'T', 'W', 'Y', 'C', 'K', 'P', '1'};
+        byteVector.insert(byteVector.end(), magic, magic + 8);
+        BinaryCodec<std::uint64_t>::write(sequence_, byteVector);
+        writeVarint(graph_.vertexPtrMap_.size(), byteVector);
+        std::unordered_map<const Vertex<T, W>*, std::uint64_t> indexMap;
+        indexMap.reserve(graph_.vertexPtrMap_.size());
+        for(const auto& e : graph_.vertexPtrMap_) {
+            indexMap.emplace(e.second.get(), indexMap.size());
+            BinaryCodec<T>::write(e.first, byteVector);
+        }
+        for(const auto& e : graph_.vertexPtrMap_) {
+            const Vertex<T, W>& v = *e.second;
+            writeVarint(v.linkVectorPtr_.size(), byteVector);
+            for(std::size_t k=0; k<v.linkVectorPtr_.size(); k++) {
+                writeVarint(indexMap.at(v.linkVectorPtr_[k].lock().get()), byteVector);
+                if constexpr( !std::is_void_v<W> ) {
+                    BinaryCodec<W>::write(v.weightVector_[k], byteVector);
+                }
+            }
+            GRAPHTHEWY_STATS_VISIT(timer, 1, v.linkVectorPtr_.size());
+        }
+        BinaryCodec<std::uint32_t>::write(journalChecksum(byteVector.data(), byteVector.size()), byteVector);
+        JournalFile::replace(checkpointPath_, byteVector);
+        file_.truncate(journalPath_, 0);
+        recordCount_ = 0;
+    }
+
+    /**
+     * @return the sequence number of the last logged record
+     */
+    std::uint64_t sequence() const
+    { return sequence_; }
+
+
+protected:
+
+    /**
+     * The type of the weights, char in place of void.
+     */
+    using WeightType = std::conditional_t<std::is_void_v<W>, char, W>;
+
+    /**
+     * Start a record in the pending buffer.
+     * 
+     * @param batch true for a GraphDelta, false for a single mutation
+     * @param operationCount The number of mutations
+     * @return the position of the record
+     */
+    std::size_t beginRecord(bool batch, std::size_t operationCount) {
+        const std::size_t begin = pendingVector_.size();
+        pendingVector_.resize(begin + 8);
+        BinaryCodec<std::uint64_t>::write(++sequence_, pendingVector_);
+        pendingVector_.push_back(batch ? 1 : 0);
+        writeVarint(operationCount, pendingVector_);
+        return begin;
+    }
+
+    /**
+     * Complete a record with its size and checksum, then commit or
+     * checkpoint if due.
+     * 
+     * @param begin The position of the record
+     */
+    void endRecord(std::size_t begin) {
+        const std::uint32_t size = static_cast<std::uint32_t>(pendingVector_.size() - begin - 8);
+        const std::uint32_t checksum = journalChecksum(pendingVector_.data() + begin + 8, size);
+        std::memcpy(pendingVector_.data() + begin, &size, 4);
+        std::memcpy(pendingVector_.data() + begin + 4, &checksum, 4);
+        pendingCount_++;
+        recordCount_++;
+        if( checkpointInterval_!=0 && recordCount_>=checkpointInterval_ ) {
+            checkpoint();
+        } else if( pendingCount_>=groupSize_ ) {
+            commit();
+        }
+    }
+
+    /**
+     * Log a single mutation.
+     * 
+     * @param kind The kind of mutation
+     * @param source The vertex, or the first end of the link
+     * @param target The second end of the link
+     * @param weight The weight of a link, nullptr if unweighted
+     */
+    void log(DeltaKind kind, const T& source, const T& target, const WeightType* weight) {
+        const std::size_t begin = beginRecord(false, 1);
+        writeOperation(kind, source, target, weight);
+        endRecord(begin);
+    }
+
+    /**
+     * Encode a mutation in the pending buffer.
+     * 
+     * @param kind The kind of mutation
+     * @param source The vertex, or the first end of the link
+     * @param target The second end of the link
+     * @param weight The weight of a link, nullptr if unweighted
+     */
+    void writeOperation(DeltaKind kind, const T& source, const T& target, const WeightType* weight) {
+        pendingVector_.push_back(static_cast<std::uint8_t>(kind));
+        BinaryCodec<T>::write(source, pendingVector_);
+        if( kind==DeltaKind::Link || kind==DeltaKind::Unlink ) {
+            BinaryCodec<T>::write(target, pendingVector_);
+        }
+        if constexpr( !std::is_void_v<W> ) {
+            if( kind==DeltaKind::Link ) {
+                BinaryCodec<W>::write(*weight, pendingVector_);
+            }
+        } else {
+            (void)weight;
+        }
+    }
+
+    /**
+     * Apply a logged record to the graph.
+     * 
+     * @param p The position after the sequence number
+     * @param end The end of the record
+     */
+    void replay(const std::uint8_t* p, const std::uint8_t* end) {
+        if( p>=end ) {
+            throw std::runtime_error("graphthewy: truncated journal record");
+        }
+        const bool batch = *p++!=0;
+        const std::uint64_t operationCount = readJournalVarint(p, end);
+        GraphDelta<T, W> delta;
+        for(std::uint64_t i=0; i<operationCount; i++) {
+            if( p>=end ) {
+                throw std::runtime_error("graphthewy: truncated journal record");
+            }
+            const DeltaKind kind = static_cast<DeltaKind>(*p++);
+            const T source = BinaryCodec<T>::read(p, end);
+            const T target = kind==DeltaKind::Link || kind==DeltaKind::Unlink ? BinaryCodec<T>::read(p, end) : source;
+            if( kind==DeltaKind::AddVertex ) {
+                batch ? delta.addVertex(source) : graph_.addVertex(source);
+            } else if( kind==DeltaKind::RemoveVertex ) {
+                batch ? delta.removeVertex(source) : (void)graph_.removeVertex(source);
+            } else if( kind==DeltaKind::Unlink ) {
+                batch ? delta.unlink(source, target) : (void)graph_.unlink(source, target);
+            } else if constexpr( !std::is_void_v<W> ) {
+                const W weight = BinaryCodec<W>::read(p, end);
+                batch ? delta.link(source, target, weight) : (void)graph_.link(source, target, weight);
+            } else {
+                batch ? delta.link(source, target) : (void)graph_.link(source, target);
+            }
+        }
+        if( batch ) {
+            delta.apply(graph_);
+        }
+    }
+
+    /**
+     * Load a checkpoint into the empty graph. Each adjacency vector is
+     * allocated once, to its exact size.
+     * 
+     * @param byteVector The content of the checkpoint file
+     * @return the sequence number of the last record it contains
+     */
+    std::uint64_t loadCheckpoint(const std::vector<std::uint8_t>& byteVector) {
+        GRAPHTHEWY_STATS_TIMER(timer, "loadCheckpoint");
+        if( byteVector.size()<20 || std::memcmp(byteVector.data(), "GTWYCKP1", 8)!=0 ) {
+            throw std::runtime_error("graphthewy: not a checkpoint");
+        }
+        const std::uint8_t* end = byteVector.data() + byteVector.size() - 4;
+        std::uint32_t checksum;
+        std::memcpy(&checksum, end, 4);
+        if( journalChecksum(byteVector.data(), byteVector.size() - 4)!=checksum ) {
+            throw std::runtime_error("graphthewy: corrupt checkpoint");
+        }
+        const std::uint8_t* p = byteVector.data() + 8;
+        const std::uint64_t sequence = BinaryCodec<std::uint64_t>::read(p, end);
+        const std::uint64_t n = readJournalVarint(p, end);
+        std::vector<const std::shared_ptr<Vertex<T, W>>*> ptrVector;
+        ptrVector.reserve(static_cast<std::size_t>(n));
+        for(std::uint64_t i=0; i<n; i++) {
+            const T label = BinaryCodec<T>::read(p, end);
+            const auto it = graph_.vertexPtrMap_.emplace_hint(graph_.vertexPtrMap_.end(), label, std::shared_ptr<Vertex<T, W>>(new Vertex<T, W>(label)));
+            ptrVector.push_back(&it->second);
+        }
+        for(std::uint64_t i=0; i<n; i++) {
+            Vertex<T, W>& v = **ptrVector[i];
+            const std::uint64_t d = readJournalVarint(p, end);
+            trackedReserve(v.linkVectorPtr_, static_cast<std::size_t>(d));
+            if constexpr( !std::is_void_v<W> ) {
+                trackedReserve(v.weightVector_, static_cast<std::size_t>(d));
+            }
+            for(std::uint64_t k=0; k<d; k++) {
+                const std::uint64_t target = readJournalVarint(p, end);
+                if( target>=n ) {
+                    throw std::runtime_error("graphthewy: corrupt checkpoint");
+                }
+                v.linkVectorPtr_.push_back(*ptrVector[target]);
+                if constexpr( !std::is_void_v<W> ) {
+                    v.weightVector_.push_back(BinaryCodec<W>::read(p, end));
+                }
+            }
+            GRAPHTHEWY_STATS_VISIT(timer, 1, d);
+        }
+        if( graph_.edgePolicy()!=EdgePolicy::Multigraph ) {
+            // Rebuild the link index
+            graph_.setEdgePolicy(graph_.edgePolicy());
+        }
+        return sequence;
+    }
+
+
+protected:
+
+    /**
+     * The graph.
+     */
+    G<T, W>&
+    graph_;
+
+    /**
+     * The path of the log file.
+     */
+    std::string
+    journalPath_;
+
+    /**
+     * The path of the checkpoint file.
+     */
+    std::string
+    checkpointPath_;
+
+    /**
+     * The number of records written by each fsync.
+     */
+    std::size_t
+    groupSize_;
+
+    /**
+     * The number of records between automatic checkpoints, 0 for none.
+     */
+    std::size_t
+    checkpointInterval_;
+
+    /**
+     * The sequence number of the last logged record.
+     */
+    std::uint64_t
+    sequence_;
+
+    /**
+     * The records not written yet.
+     */
+    std::vector<std::uint8_t>
+    pendingVector_;
+
+    /**
+     * The number of records not written yet.
+     */
+    std::size_t
+    pendingCount_;
+
+    /**
+     * The number of records in the log since the last checkpoint.
+     */
+    std::size_t
+    recordCount_;
+
+    /**
+     * The log file.
+     */
+    JournalFile
+    file_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_JOURNAL_HPP_
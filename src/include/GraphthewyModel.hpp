@@ -12,11 +12,21 @@
 #ifndef _GRAPH_MODEL_HPP_
 #define _GRAPH_MODEL_HPP_
 
+#include "GraphthewyStats.hpp"
+#include "GraphthewyParallel.hpp"
+
 #include <initializer_list>
 #include <memory>
 #include <algorithm>
 #include <vector>
 #include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <tuple>
+#include <type_traits>
+#include <string>
+#include <functional>
 
 
 namespace graphthewy {
@@ -43,14 +53,38 @@ concept equality_comparable = requires(const Tp& t, const Tp& u) {
 };
 #endif
 
+/**
+ * Edge weights, aligned with a list of links.
+ * 
+ * Template argument:
+ * - W = the type of the edge weight, void for an unweighted graph
+ */
+template<class W>
+struct WeightVector {
+
+    /**
+     * List of weights, weightVector_[i] being the weight of the i-th link.
+     */
+    std::vector<W> weightVector_;
+
+};
+
+/**
+ * Edge weights of an unweighted graph: nothing is stored.
+ */
+template<>
+struct WeightVector<void> { };
+
+
 /**
  * Vertex
  * 
  * Template argument:
  * - T the type of label
+ * - W the type of the edge weight, void (default) for an unweighted graph
  */
-template<equality_comparable T>
-struct Vertex {
+template<equality_comparable T, class W = void>
+struct Vertex : public WeightVector<W> {
 
 #if __cplusplus < 202002L
 
@@ -64,6 +98,8 @@ struct Vertex {
             EqualityComparable<T>::value,
             "Type must be comparable."
         );
+        GRAPHTHEWY_STATS_ADD(allocationCount_, 1);
+        GRAPHTHEWY_STATS_ADD(bytesInUse_, static_cast<std::int64_t>(sizeof(*this)));
     };
 
 #else
@@ -73,9 +109,44 @@ struct Vertex {
      * 
      * @param label The vertex's label
      */
-    Vertex(const T& label) : label_(label) { };
+    Vertex(const T& label) : label_(label) {
+        GRAPHTHEWY_STATS_ADD(allocationCount_, 1);
+        GRAPHTHEWY_STATS_ADD(bytesInUse_, static_cast<std::int64_t>(sizeof(*this)));
+    };
 
 #endif
+
+#ifdef GRAPHTHEWY_STATS
+
+    /**
+     * Copy constructor, counted in the stats.
+     * 
+     * @param o The vertex to copy
+     */
+    Vertex(const Vertex<T, W>& o) : WeightVector<W>(o), label_(o.label_), linkVectorPtr_(o.linkVectorPtr_) {
+        GRAPHTHEWY_STATS_ADD(allocationCount_, 1);
+        GRAPHTHEWY_STATS_ADD(bytesInUse_, byteCount());
+    }
+
+    /**
+     * Destructor, releasing the bytes counted in the stats.
+     */
+    ~Vertex()
+    { GRAPHTHEWY_STATS_ADD(bytesInUse_, -byteCount()); }
+
+    /**
+     * @return the bytes held by the vertex and its vectors
+     */
+    std::int64_t byteCount() const {
+        std::size_t bytes = sizeof(*this) + linkVectorPtr_.capacity() * sizeof(std::weak_ptr<Vertex<T, W>>);
+        if constexpr( !std::is_void_v<W> ) {
+            bytes += this->weightVector_.capacity() * sizeof(W);
+        }
+        return static_cast<std::int64_t>(bytes);
+    }
+
+#endif
+
     /**
      * Operator
      * 
@@ -90,7 +161,7 @@ struct Vertex {
      * @param o The vertex to compare
      * @return true if the vertexes' labels are equals
      */
-    bool operator==(const Vertex<T>& o) const { return o.label_==label_; }
+    bool operator==(const Vertex<T, W>& o) const { return o.label_==label_; }
 
     /**
      * Operator
@@ -98,7 +169,7 @@ struct Vertex {
      * @param o The pointed vertex to compare
      * @return true if the pointed vertexes' labels are equals
      */
-    bool operator==(const std::shared_ptr<Vertex<T>>& o) const { return o->label_==label_; }
+    bool operator==(const std::shared_ptr<Vertex<T, W>>& o) const { return o->label_==label_; }
 
     /**
      * Operator
@@ -106,7 +177,7 @@ struct Vertex {
      * @param o The pointed vertex to compare
      * @return true if the pointed vertexes' labels are equals
      */
-    bool operator==(const std::weak_ptr<Vertex<T>>& o) const { return o->label_==label_; }
+    bool operator==(const std::weak_ptr<Vertex<T, W>>& o) const { return o->label_==label_; }
 
     /**
      * To check whether the label represents an existing vertex in the
@@ -116,11 +187,14 @@ struct Vertex {
      * @return true or false
      */
     bool contains(const T& label) const {
-        for(const auto& e : linkVectorPtr_) {
-            if(e.lock()->label_ == label) {
+        GRAPHTHEWY_STATS_ADD(containsCount_, 1);
+        for(std::size_t i=0; i<linkVectorPtr_.size(); i++) {
+            if(linkVectorPtr_[i].lock()->label_ == label) {
+                GRAPHTHEWY_STATS_ADD(containsScanCount_, i + 1);
                 return true;
             }
         }
+        GRAPHTHEWY_STATS_ADD(containsScanCount_, linkVectorPtr_.size());
         return false;
     }
 
@@ -131,7 +205,7 @@ struct Vertex {
      * @param label The vertex
      * @return true or false
      */
-    bool contains(const Vertex<T>& vertex) const
+    bool contains(const Vertex<T, W>& vertex) const
     { return contains(vertex.label_); }
 
     /**
@@ -141,7 +215,7 @@ struct Vertex {
      * @param label The pointed vertex
      * @return true or false
      */
-    bool contains(const std::shared_ptr<Vertex<T>>& vertex) const
+    bool contains(const std::shared_ptr<Vertex<T, W>>& vertex) const
     { return contains(vertex->label_); }
 
     /**
@@ -153,8 +227,8 @@ struct Vertex {
      * 
      * @param vertex The vertex to create a link with.
      */
-    void link(const Vertex<T>& vertex)
-    { linkVectorPtr_.push_back(std::shared_ptr<Vertex<T>>(vertex)); }
+    void link(const Vertex<T, W>& vertex)
+    { linkVectorPtr_.push_back(std::shared_ptr<Vertex<T, W>>(vertex)); }
 
     /**
      * To create a link between this vertex and the pointed vertex in argument.
@@ -165,7 +239,72 @@ struct Vertex {
      * 
      * @param vertex The pointed vertex to create a link with.
      */
-    void link(const std::shared_ptr<Vertex<T>>& vertexPtr) { linkVectorPtr_.push_back(vertexPtr); }
+    void link(const std::shared_ptr<Vertex<T, W>>& vertexPtr) {
+        GRAPHTHEWY_STATS_ADD(linkCount_, 1);
+        trackedPushBack(linkVectorPtr_, vertexPtr);
+        if constexpr( !std::is_void_v<W> ) {
+            trackedPushBack(this->weightVector_, W(1));
+        }
+    }
+
+    /**
+     * To create a weighted link between this vertex and the pointed vertex in argument.
+     * 
+     * @param vertex The pointed vertex to create a link with.
+     * @param weight The weight of the link
+     */
+    template<class U = W, class = std::enable_if_t<!std::is_void_v<U>>>
+    void link(const std::shared_ptr<Vertex<T, W>>& vertexPtr, const U& weight) {
+        GRAPHTHEWY_STATS_ADD(linkCount_, 1);
+        trackedPushBack(linkVectorPtr_, vertexPtr);
+        trackedPushBack(this->weightVector_, weight);
+    }
+
+    /**
+     * Remove the first link, or all the links, toward a vertex. The
+     * weights stay aligned with the links.
+     * 
+     * @param vertex The vertex to unlink from
+     * @param all true to remove every link toward the vertex
+     * @return the number of links removed
+     */
+    std::size_t unlink(const Vertex<T, W>* vertex, bool all) {
+        std::size_t kept = 0;
+        for(std::size_t k=0; k<linkVectorPtr_.size(); k++) {
+            if( (all || kept==k) && linkVectorPtr_[k].lock().get()==vertex ) {
+                continue;
+            }
+            if( kept!=k ) {
+                linkVectorPtr_[kept] = std::move(linkVectorPtr_[k]);
+                if constexpr( !std::is_void_v<W> ) {
+                    this->weightVector_[kept] = std::move(this->weightVector_[k]);
+                }
+            }
+            kept++;
+        }
+        const std::size_t removed = linkVectorPtr_.size() - kept;
+        linkVectorPtr_.resize(kept);
+        if constexpr( !std::is_void_v<W> ) {
+            this->weightVector_.resize(kept);
+        }
+        return removed;
+    }
+
+    /**
+     * Get the weight of the first link toward the label.
+     * 
+     * @param label The label
+     * @return the weight of the link
+     */
+    template<class U = W, class = std::enable_if_t<!std::is_void_v<U>>>
+    const U& getWeight(const T& label) const {
+        for(std::size_t i=0; i<linkVectorPtr_.size(); i++) {
+            if(linkVectorPtr_[i].lock()->label_ == label) {
+                return this->weightVector_[i];
+            }
+        }
+        throw std::out_of_range("graphthewy: no such link");
+    }
 
     /**
      * Vertex's label of type T
@@ -176,18 +315,126 @@ struct Vertex {
      * List of linked vertexes. The degree of the current vertex is
      * the size of the vector.
      */
-    std::vector<std::weak_ptr<Vertex<T>>> linkVectorPtr_;
+    std::vector<std::weak_ptr<Vertex<T, W>>> linkVectorPtr_;
 
 };
 
 
+/**
+ * Heap storage owned by a label, none for most types.
+ * 
+ * @param label The label
+ * @return the number of bytes
+ */
+template<class T>
+std::size_t labelHeapBytes(const T&)
+{ return 0; }
+
+/**
+ * Heap storage owned by a string label, none if it is short enough to be
+ * stored inside the string object.
+ * 
+ * @param label The label
+ * @return the number of bytes
+ */
+template<class C, class Tr, class A>
+std::size_t labelHeapBytes(const std::basic_string<C, Tr, A>& label) {
+    const char* begin = reinterpret_cast<const char*>(&label);
+    const char* data = reinterpret_cast<const char*>(label.data());
+    if( data>=begin && data<begin + sizeof(label) ) {
+        return 0;
+    }
+    return (label.capacity() + 1) * sizeof(C);
+}
+
+/**
+ * Memory held by a graph, by category, as returned by memoryUsage().
+ * The sizes of the allocator's bookkeeping are not included, and those
+ * of the map nodes and shared_ptr control blocks are estimates.
+ */
+struct MemoryUsage {
+
+    /**
+     * @return the sum of the categories
+     */
+    std::size_t total() const
+    { return registry_ + vertices_ + adjacency_ + labels_; }
+
+    /**
+     * Vertex registry: map nodes holding a label and a shared_ptr.
+     */
+    std::size_t
+    registry_;
+
+    /**
+     * Vertex objects and their shared_ptr control blocks.
+     */
+    std::size_t
+    vertices_;
+
+    /**
+     * Adjacency and weight vectors, unused capacity included.
+     */
+    std::size_t
+    adjacency_;
+
+    /**
+     * Unused capacity of the adjacency and weight vectors, part of adjacency_.
+     */
+    std::size_t
+    slack_;
+
+    /**
+     * Heap storage of the labels (map keys and vertex labels).
+     */
+    std::size_t
+    labels_;
+
+};
+
+
+/**
+ * What a graph does with repeated links and self-loops.
+ */
+enum class EdgePolicy {
+    /** Every link is stored, even repeated (default). */
+    Multigraph,
+    /** A link already in the graph is ignored, self-loops are stored. */
+    NoParallelEdges,
+    /** Repeated links and self-loops are ignored. */
+    Simple
+};
+
+/**
+ * Hash of a pair of vertex addresses, for the link index.
+ */
+struct VertexPairHash {
+
+    /**
+     * @param p The pair of addresses
+     * @return the hash
+     */
+    template<class V>
+    std::size_t operator()(const std::pair<const V*, const V*>& p) const {
+        const std::size_t h = std::hash<const V*>()(p.first);
+        return h ^ (std::hash<const V*>()(p.second) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+    }
+
+};
+
+
+template<equality_comparable T, class W>
+struct GraphDelta;
+
+
 /**
  * Undirected graph.
  * 
  * Template argument:
  * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
  */
-template<equality_comparable T>
+template<equality_comparable T, class W = void>
 class UndirectedGraph {
 
 public:
@@ -195,7 +442,14 @@ public:
     /**
      * Constructor
      */
-    UndirectedGraph() { }
+    UndirectedGraph() : policy_(EdgePolicy::Multigraph) { }
+
+    /**
+     * Constructor
+     * 
+     * @param policy What to do with repeated links and self-loops
+     */
+    UndirectedGraph(EdgePolicy policy) : policy_(policy) { }
 
     /**
      * Copy constructor
@@ -205,34 +459,24 @@ public:
      * 
      * @param g The graph to operate a copy from.
      */
-    UndirectedGraph(const UndirectedGraph<T>& g) {
-        for(const auto& e : g.vertexPtrMap_) {
-            vertexPtrMap_.insert(std::pair(e.first, std::shared_ptr<Vertex<T>>(new Vertex<T>(e.first))));
-        }
-        for(const auto& q : g.vertexPtrMap_) {
-            for(const auto& p : q.second->linkVectorPtr_) {
-                if(g.isLinked(p.lock()->label_, q.first)) {
-                    link(p.lock()->label_, q.first);
-                }
-            }
-        }
-    }
+    UndirectedGraph(const UndirectedGraph<T, W>& g)
+    { copyFrom(g); }
 
     /**
      * Constructor
      * 
      * @param vertexLabelList List of the vertex
      */
-    UndirectedGraph(const std::initializer_list<Vertex<T>>& vertexList) : vertexPtrMap_(vertexList) { }
+    UndirectedGraph(const std::initializer_list<Vertex<T, W>>& vertexList) : vertexPtrMap_(vertexList), policy_(EdgePolicy::Multigraph) { }
 
     /**
      * Constructor
      * 
      * @param vertexLabelList List of the vertex labels
      */
-    UndirectedGraph(const std::initializer_list<T>& vertexLabelList) {
+    UndirectedGraph(const std::initializer_list<T>& vertexLabelList) : policy_(EdgePolicy::Multigraph) {
         for(auto& e : vertexLabelList) {
-            vertexPtrMap_.insert(std::pair(e, std::shared_ptr<Vertex<T>>(new Vertex<T>(e))) );
+            vertexPtrMap_.insert(std::pair(e, std::shared_ptr<Vertex<T, W>>(new Vertex<T, W>(e))) );
         }
     }
 
@@ -243,15 +487,15 @@ public:
      * @param label The new vertex's label to create the new vertex with
      */
     void addVertex(const T& label)
-    { vertexPtrMap_.insert(std::pair(label, std::shared_ptr<Vertex<T>>(new Vertex<T>(label)))); }
+    { vertexPtrMap_.insert(std::pair(label, std::shared_ptr<Vertex<T, W>>(new Vertex<T, W>(label)))); }
 
     /**
      * To add a vertex in the current graph.
      * 
      * @param vertex The vertex to add
      */
-    void addVertex(const Vertex<T>& vertex)
-    { vertexPtrMap_.emplace( std::pair(vertex.label_, std::shared_ptr<Vertex<T>>(vertex))); }
+    void addVertex(const Vertex<T, W>& vertex)
+    { vertexPtrMap_.emplace( std::pair(vertex.label_, std::shared_ptr<Vertex<T, W>>(vertex))); }
 
     /**
      * To check whether the vertex's represents a vertex in the vertex registry
@@ -260,7 +504,10 @@ public:
      * @param label The vertex's label
      * @return true or false
      */
-    bool contains(const T& label) const { return vertexPtrMap_.find(label)!=vertexPtrMap_.end(); }
+    bool contains(const T& label) const {
+        GRAPHTHEWY_STATS_ADD(vertexLookupCount_, 1);
+        return vertexPtrMap_.find(label)!=vertexPtrMap_.end();
+    }
 
     /**
      * To check whether the vertex is contained in the vertex registry
@@ -269,7 +516,7 @@ public:
      * @param vertex The vertex
      * @return true or false
      */
-    bool contains(const Vertex<T>& vertex) const { return contains(vertex.label_); }
+    bool contains(const Vertex<T, W>& vertex) const { return contains(vertex.label_); }
 
     /**
      * To check whether the pointed vertex is contained in the vertex registry
@@ -278,7 +525,7 @@ public:
      * @param vertex A pointer to the vertex
      * @return true or false
      */
-    bool contains(const std::shared_ptr<Vertex<T>>& vertex) const { return contains(vertex->label_); }
+    bool contains(const std::shared_ptr<Vertex<T, W>>& vertex) const { return contains(vertex->label_); }
 
     /**
      * Get the corresponding vertex by label.
@@ -286,21 +533,413 @@ public:
      * @param label the vertex's label
      * @return the vertex
      */
-    const Vertex<T>& getVertex(const T& label) { return *(vertexPtrMap_.at(label)); }
+    const Vertex<T, W>& getVertex(const T& label) {
+        GRAPHTHEWY_STATS_ADD(vertexLookupCount_, 1);
+        return *(vertexPtrMap_.at(label));
+    }
 
     /**
      * Create a link between vertex e1 and e2.
      * 
      * @param e1 the vertex's label
      * @param e2 the vertex's label
+     * @return false if a vertex is missing or the edge policy rejected the link
      */
-    void link(const T& e1, const T& e2) {
-        if( contains(e1) && contains(e2) ) {
+    bool link(const T& e1, const T& e2) {
+        if( contains(e1) && contains(e2) && acceptLink(vertexPtrMap_.at(e1).get(), vertexPtrMap_.at(e2).get(), true) ) {
             vertexPtrMap_.at(e1)->link(vertexPtrMap_.at(e2));
             vertexPtrMap_.at(e2)->link(vertexPtrMap_.at(e1));
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Create a weighted link between vertex e1 and e2. A repeated link
+     * rejected by the edge policy keeps its first weight.
+     * 
+     * @param e1 the vertex's label
+     * @param e2 the vertex's label
+     * @param weight the weight of the link
+     * @return false if a vertex is missing or the edge policy rejected the link
+     */
+    template<class U = W, class = std::enable_if_t<!std::is_void_v<U>>>
+    bool link(const T& e1, const T& e2, const U& weight) {
+        if( contains(e1) && contains(e2) && acceptLink(vertexPtrMap_.at(e1).get(), vertexPtrMap_.at(e2).get(), true) ) {
+            vertexPtrMap_.at(e1)->link(vertexPtrMap_.at(e2), weight);
+            vertexPtrMap_.at(e2)->link(vertexPtrMap_.at(e1), weight);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Bulk creation of links from an edge list (list of label pairs).
+     * 
+     * Missing vertices are created, and each adjacency vector is grown
+     * once to its final size instead of once per link. The result is
+     * the same as calling link(e1, e2) for each pair, the edge policy
+     * included.
+     * 
+     * @param edgePairList vector of pairs of label corresponding to edge
+     */
+    void addEdgeList(const std::vector<std::pair<T, T>>& edgePairList)
+    { addEdgeList(edgePairList, true); }
+
+    /**
+     * Bulk creation of weighted links from an edge list (list of
+     * label, label, weight tuples).
+     * 
+     * @param edgeList vector of tuples corresponding to weighted edge
+     */
+    template<class U = W, class = std::enable_if_t<!std::is_void_v<U>>>
+    void addEdgeList(const std::vector<std::tuple<T, T, U>>& edgeList)
+    { addEdgeList(edgeList, true); }
+
+    /**
+     * Get the weight of the link between vertex e1 and e2.
+     * 
+     * @param e1 the vertex's label
+     * @param e2 the vertex's label
+     * @return the weight of the link
+     */
+    template<class U = W, class = std::enable_if_t<!std::is_void_v<U>>>
+    const U& getWeight(const T& e1, const T& e2) const
+    { return vertexPtrMap_.at(e1)->getWeight(e2); }
+
+    /**
+     * @return what the graph does with repeated links and self-loops
+     */
+    EdgePolicy edgePolicy() const
+    { return policy_; }
+
+    /**
+     * Change the edge policy. The links already in the graph are made
+     * to follow it, as with deduplicate(); none is removed when the new
+     * policy is Multigraph.
+     * 
+     * @param policy What to do with repeated links and self-loops
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    void setEdgePolicy(EdgePolicy policy, unsigned int threadCount = 0)
+    { setEdgePolicy(policy, threadCount, true); }
+
+    /**
+     * Remove the repeated links, keeping the first one (and its weight)
+     * in each adjacency vector, and the self-loops if the edge policy is
+     * Simple. The vertices are processed in parallel, each sorting the
+     * positions of its links by target.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    void deduplicate(unsigned int threadCount = 0)
+    { deduplicate(threadCount, true); }
+
+    /**
+     * Remove a link between vertex e1 and e2 (one of them, if repeated).
+     * 
+     * @param e1 the vertex's label
+     * @param e2 the vertex's label
+     * @return false if there was no such link
+     */
+    bool unlink(const T& e1, const T& e2)
+    { return unlink(e1, e2, true); }
+
+    /**
+     * Remove a vertex and its links.
+     * 
+     * @param label the vertex's label
+     * @return false if there was no such vertex
+     */
+    bool removeVertex(const T& label)
+    { return removeVertex(label, true); }
+
+
+protected:
+
+    /**
+     * Bulk creation of links, shared by the undirected and the
+     * directed graph.
+     * 
+     * @param edgeList vector of pairs or tuples (e1, e2[, weight]) corresponding to edge
+     * @param bothWays true to link e2 -> e1 as well
+     */
+    template<class E>
+    void addEdgeList(const std::vector<E>& edgeList, bool bothWays) {
+        std::vector<std::pair<const std::shared_ptr<Vertex<T, W>>*, const std::shared_ptr<Vertex<T, W>>*>> resolvedPtr;
+        resolvedPtr.reserve(edgeList.size());
+        std::unordered_map<Vertex<T, W>*, std::size_t> degreeMap;
+        for(const auto& e : edgeList) {
+            const auto& p1 = findOrAddVertex(std::get<0>(e));
+            const auto& p2 = findOrAddVertex(std::get<1>(e));
+            if( !acceptLink(p1.get(), p2.get(), bothWays) ) {
+                resolvedPtr.push_back(std::make_pair(nullptr, nullptr));
+                continue;
+            }
+            resolvedPtr.push_back(std::make_pair(&p1, &p2));
+            degreeMap[p1.get()]++;
+            if( bothWays ) {
+                degreeMap[p2.get()]++;
+            }
+        }
+        for(const auto& d : degreeMap) {
+            trackedReserve(d.first->linkVectorPtr_, d.first->linkVectorPtr_.size() + d.second);
+            if constexpr( !std::is_void_v<W> ) {
+                trackedReserve(d.first->weightVector_, d.first->weightVector_.size() + d.second);
+            }
+        }
+        for(std::size_t i=0; i<edgeList.size(); i++) {
+            const auto& e = resolvedPtr[i];
+            if( e.first==nullptr ) {
+                continue;
+            }
+            if constexpr( std::tuple_size_v<E> == 3 ) {
+                (*e.first)->link(*e.second, std::get<2>(edgeList[i]));
+                if( bothWays ) {
+                    (*e.second)->link(*e.first, std::get<2>(edgeList[i]));
+                }
+            } else {
+                (*e.first)->link(*e.second);
+                if( bothWays ) {
+                    (*e.second)->link(*e.first);
+                }
+            }
+        }
+    }
+
+    /**
+     * Perfect copy of the labels, links and weights of another graph
+     * into the current, empty, graph.
+     * 
+     * @param g The graph to operate a copy from.
+     */
+    void copyFrom(const UndirectedGraph<T, W>& g) {
+        GRAPHTHEWY_STATS_ADD(copyCount_, 1);
+        GRAPHTHEWY_STATS_TIMER(timer, "copy");
+        policy_ = g.policy_;
+        for(const auto& e : g.vertexPtrMap_) {
+            vertexPtrMap_.emplace_hint(vertexPtrMap_.end(), e.first, std::shared_ptr<Vertex<T, W>>(new Vertex<T, W>(e.first)));
+        }
+        for(const auto& q : g.vertexPtrMap_) {
+            const auto& v = vertexPtrMap_.at(q.first);
+            trackedReserve(v->linkVectorPtr_, q.second->linkVectorPtr_.size());
+            for(const auto& p : q.second->linkVectorPtr_) {
+                v->linkVectorPtr_.push_back(vertexPtrMap_.at(p.lock()->label_));
+            }
+            if constexpr( !std::is_void_v<W> ) {
+                trackedReserve(v->weightVector_, q.second->weightVector_.size());
+                v->weightVector_ = q.second->weightVector_;
+            }
+            GRAPHTHEWY_STATS_VISIT(timer, 1, q.second->linkVectorPtr_.size());
+        }
+        if( !g.linkIndex_.empty() ) {
+            linkIndex_.reserve(g.linkIndex_.size());
+            for(const auto& a : g.linkIndex_) {
+                linkIndex_.emplace(vertexPtrMap_.at(a.first->label_).get(), vertexPtrMap_.at(a.second->label_).get());
+            }
         }
     }
 
+    /**
+     * Check a new link against the edge policy, and record it in the
+     * link index if accepted.
+     * 
+     * @param v1 the first vertex
+     * @param v2 the second vertex
+     * @param bothWays true for an undirected link
+     * @return true if the link must be created
+     */
+    bool acceptLink(const Vertex<T, W>* v1, const Vertex<T, W>* v2, bool bothWays) {
+        if( policy_==EdgePolicy::Multigraph ) {
+            return true;
+        }
+        if( policy_==EdgePolicy::Simple && v1==v2 ) {
+            return false;
+        }
+        return linkIndex_.insert(linkKey(v1, v2, bothWays)).second;
+    }
+
+    /**
+     * Key of a link in the link index, with the ends of an undirected
+     * link in label order, so that the key of a copy is the copy of the key.
+     * 
+     * @param v1 the first vertex
+     * @param v2 the second vertex
+     * @param bothWays true for an undirected link
+     * @return the key
+     */
+    static std::pair<const Vertex<T, W>*, const Vertex<T, W>*> linkKey(const Vertex<T, W>* v1, const Vertex<T, W>* v2, bool bothWays) {
+        if( bothWays && v2->label_<v1->label_ ) {
+            return std::make_pair(v2, v1);
+        }
+        return std::make_pair(v1, v2);
+    }
+
+    /**
+     * Remove a link, shared by the undirected and the directed graph.
+     * 
+     * @param e1 the vertex's label
+     * @param e2 the vertex's label
+     * @param bothWays true to unlink e2 -> e1 as well
+     * @return false if there was no such link
+     */
+    bool unlink(const T& e1, const T& e2, bool bothWays) {
+        if( !contains(e1) || !contains(e2) ) {
+            return false;
+        }
+        Vertex<T, W>* v1 = vertexPtrMap_.at(e1).get();
+        Vertex<T, W>* v2 = vertexPtrMap_.at(e2).get();
+        if( v1->unlink(v2, false)==0 ) {
+            return false;
+        }
+        if( bothWays ) {
+            v2->unlink(v1, false);
+        }
+        if( policy_!=EdgePolicy::Multigraph ) {
+            linkIndex_.erase(linkKey(v1, v2, bothWays));
+        }
+        return true;
+    }
+
+    /**
+     * Remove a vertex, shared by the undirected and the directed graph.
+     * The links toward it are found among its neighbors in an undirected
+     * graph, and among all the vertices in a directed one.
+     * 
+     * @param label the vertex's label
+     * @param bothWays true for an undirected graph
+     * @return false if there was no such vertex
+     */
+    bool removeVertex(const T& label, bool bothWays) {
+        const auto it = vertexPtrMap_.find(label);
+        if( it==vertexPtrMap_.end() ) {
+            return false;
+        }
+        Vertex<T, W>* v = it->second.get();
+        if( policy_!=EdgePolicy::Multigraph ) {
+            for(const auto& p : v->linkVectorPtr_) {
+                linkIndex_.erase(linkKey(v, p.lock().get(), bothWays));
+            }
+        }
+        if( bothWays ) {
+            for(const auto& p : v->linkVectorPtr_) {
+                const std::shared_ptr<Vertex<T, W>> u = p.lock();
+                if( u.get()!=v ) {
+                    u->unlink(v, true);
+                }
+            }
+        } else {
+            for(const auto& e : vertexPtrMap_) {
+                if( e.second.get()!=v && e.second->unlink(v, true)!=0 && policy_!=EdgePolicy::Multigraph ) {
+                    linkIndex_.erase(linkKey(e.second.get(), v, false));
+                }
+            }
+        }
+        vertexPtrMap_.erase(it);
+        return true;
+    }
+
+    /**
+     * Change the edge policy, shared by the undirected and the directed graph.
+     * 
+     * @param policy What to do with repeated links and self-loops
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @param bothWays true for an undirected graph
+     */
+    void setEdgePolicy(EdgePolicy policy, unsigned int threadCount, bool bothWays) {
+        policy_ = policy;
+        if( policy==EdgePolicy::Multigraph ) {
+            // Every link already follows it, and no index is kept
+            linkIndex_.clear();
+            return;
+        }
+        deduplicate(threadCount, bothWays);
+    }
+
+    /**
+     * Remove the repeated links, shared by the undirected and the
+     * directed graph, and rebuild the link index. In an undirected graph,
+     * a self-loop is stored twice in its vertex and is kept so.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @param bothWays true for an undirected graph
+     */
+    void deduplicate(unsigned int threadCount, bool bothWays) {
+        GRAPHTHEWY_STATS_TIMER(timer, "deduplicate");
+        std::vector<Vertex<T, W>*> vertexVector;
+        vertexVector.reserve(vertexPtrMap_.size());
+        for(const auto& e : vertexPtrMap_) {
+            vertexVector.push_back(e.second.get());
+        }
+        const bool keepSelfLoops = policy_!=EdgePolicy::Simple;
+        parallelDynamic(vertexVector.size(), threadCount, [&](unsigned int, std::size_t i) {
+            Vertex<T, W>& v = *vertexVector[i];
+            const std::size_t d = v.linkVectorPtr_.size();
+            std::vector<const Vertex<T, W>*> targetVector(d);
+            std::vector<std::size_t> positionVector(d);
+            for(std::size_t k=0; k<d; k++) {
+                targetVector[k] = v.linkVectorPtr_[k].lock().get();
+                positionVector[k] = k;
+            }
+            std::stable_sort(positionVector.begin(), positionVector.end(), [&](std::size_t a, std::size_t b) {
+                return std::less<const Vertex<T, W>*>()(targetVector[a], targetVector[b]);
+            });
+            std::vector<char> keepVector(d, 0);
+            for(std::size_t k=0; k<d; k++) {
+                const Vertex<T, W>* u = targetVector[positionVector[k]];
+                const bool first = k==0 || targetVector[positionVector[k - 1]]!=u;
+                if( u==&v ) {
+                    // An undirected self-loop is stored twice
+                    const bool second = bothWays && k>0 && targetVector[positionVector[k - 1]]==u
+                        && (k==1 || targetVector[positionVector[k - 2]]!=u);
+                    keepVector[positionVector[k]] = keepSelfLoops && (first || second);
+                } else {
+                    keepVector[positionVector[k]] = first;
+                }
+            }
+            std::size_t kept = 0;
+            for(std::size_t k=0; k<d; k++) {
+                if( keepVector[k] ) {
+                    v.linkVectorPtr_[kept] = v.linkVectorPtr_[k];
+                    if constexpr( !std::is_void_v<W> ) {
+                        v.weightVector_[kept] = v.weightVector_[k];
+                    }
+                    kept++;
+                }
+            }
+            v.linkVectorPtr_.resize(kept);
+            if constexpr( !std::is_void_v<W> ) {
+                v.weightVector_.resize(kept);
+            }
+        });
+        linkIndex_.clear();
+        if( policy_!=EdgePolicy::Multigraph ) {
+            for(const Vertex<T, W>* v : vertexVector) {
+                for(const auto& p : v->linkVectorPtr_) {
+                    linkIndex_.insert(linkKey(v, p.lock().get(), bothWays));
+                }
+            }
+        }
+        GRAPHTHEWY_STATS_VISIT(timer, vertexVector.size(), linkIndex_.size());
+    }
+
+    /**
+     * Get the pointed vertex by label, creating it if it does not exist.
+     * 
+     * @param label the vertex's label
+     * @return the pointed vertex, stored in the vertex registry
+     */
+    const std::shared_ptr<Vertex<T, W>>& findOrAddVertex(const T& label) {
+        auto it = vertexPtrMap_.lower_bound(label);
+        if( it==vertexPtrMap_.end() || !(it->first==label) ) {
+            it = vertexPtrMap_.emplace_hint(it, label, std::shared_ptr<Vertex<T, W>>(new Vertex<T, W>(label)));
+        }
+        return it->second;
+    }
+
+
+public:
+
     /**
      * Check whether there is a link between vertex e1 and e2,
      * by label.
@@ -310,9 +949,13 @@ public:
      * @return true or false
      */
     bool isLinked(const T& e1, const T& e2) const {
+        GRAPHTHEWY_STATS_ADD(linkLookupCount_, 1);
         if( !contains(e1) || !contains(e2) ) {
             return false;
         }
+        if( policy_!=EdgePolicy::Multigraph ) {
+            return linkIndex_.count(linkKey(vertexPtrMap_.at(e1).get(), vertexPtrMap_.at(e2).get(), true))!=0;
+        }
         if( vertexPtrMap_.at(e1)->contains(e2) && vertexPtrMap_.at(e2)->contains(e1) ) {
             return true;
         }
@@ -326,7 +969,7 @@ public:
      * @param e2 the vertex
      * @return true or false
      */
-    bool isLinked(const Vertex<T>& e1, const Vertex<T>& e2) const {
+    bool isLinked(const Vertex<T, W>& e1, const Vertex<T, W>& e2) const {
         return isLinked(e1->label_, e2->label_);
     }
 
@@ -357,7 +1000,7 @@ public:
      * @param e vertex label
      * @return graph instance
      */
-    UndirectedGraph<T>& operator <<(const T& e) {
+    UndirectedGraph<T, W>& operator <<(const T& e) {
         if( !contains(e) ) {
             addVertex(e);
         }
@@ -372,7 +1015,7 @@ public:
      * @param e vertex
      * @return graph instance
      */
-    UndirectedGraph<T>& operator <<(const Vertex<T>& e) {
+    UndirectedGraph<T, W>& operator <<(const Vertex<T, W>& e) {
         if( !contains(e) ) {
             addVertex(e);
         }
@@ -382,6 +1025,49 @@ public:
 
 public:
 
+    /**
+     * Memory held by the graph, by category.
+     * 
+     * @return the breakdown of the memory usage
+     */
+    MemoryUsage memoryUsage() const {
+        // Estimates: a tree node header (color, parent, left, right), and the
+        // control block (vtable, two counts, pointer) of a vertex created with new
+        const std::size_t nodeHeaderBytes = 4 * sizeof(void*);
+        const std::size_t controlBlockBytes = 2 * sizeof(void*) + 2 * sizeof(int);
+        MemoryUsage usage{0, 0, 0, 0, 0};
+        for(const auto& e : vertexPtrMap_) {
+            const Vertex<T, W>& v = *e.second;
+            usage.registry_ += nodeHeaderBytes + sizeof(typename std::map<T, std::shared_ptr<Vertex<T, W>>>::value_type);
+            usage.vertices_ += sizeof(Vertex<T, W>) + controlBlockBytes;
+            usage.adjacency_ += v.linkVectorPtr_.capacity() * sizeof(std::weak_ptr<Vertex<T, W>>);
+            usage.slack_ += (v.linkVectorPtr_.capacity() - v.linkVectorPtr_.size()) * sizeof(std::weak_ptr<Vertex<T, W>>);
+            if constexpr( !std::is_void_v<W> ) {
+                usage.adjacency_ += v.weightVector_.capacity() * sizeof(W);
+                usage.slack_ += (v.weightVector_.capacity() - v.weightVector_.size()) * sizeof(W);
+            }
+            usage.labels_ += labelHeapBytes(e.first) + labelHeapBytes(v.label_);
+        }
+        if( policy_!=EdgePolicy::Multigraph ) {
+            // Link index: bucket array, and nodes holding a next pointer, the key and its hash
+            usage.adjacency_ += linkIndex_.bucket_count() * sizeof(void*)
+                + linkIndex_.size() * (sizeof(void*) + sizeof(typename decltype(linkIndex_)::value_type) + sizeof(std::size_t));
+        }
+        return usage;
+    }
+
+    /**
+     * Release the unused capacity of the adjacency and weight vectors.
+     */
+    void shrinkToFit() {
+        for(const auto& e : vertexPtrMap_) {
+            trackedShrinkToFit(e.second->linkVectorPtr_);
+            if constexpr( !std::is_void_v<W> ) {
+                trackedShrinkToFit(e.second->weightVector_);
+            }
+        }
+    }
+
     /**
      * Order of the graph (number of vertices)
      * 
@@ -390,6 +1076,17 @@ public:
     std::size_t order() const
     { return vertexPtrMap_.size(); }
 
+    /**
+     * Degree of a vertex: its number of links, a self-loop counting
+     * twice. In a directed graph, the number of links starting from the
+     * vertex (out-degree), a self-loop counting once.
+     * 
+     * @param label the vertex's label
+     * @return the degree, std::out_of_range is thrown if there is no such vertex
+     */
+    std::size_t degree(const T& label) const
+    { return vertexPtrMap_.at(label)->linkVectorPtr_.size(); }
+
     /**
      * Size of the graph (number of edges)
      * 
@@ -405,9 +1102,27 @@ public:
     /**
      * Map label to vertex.
      */
-    std::map<T, std::shared_ptr<Vertex<T>>>
+    std::map<T, std::shared_ptr<Vertex<T, W>>>
     vertexPtrMap_;
 
+
+protected:
+
+    /**
+     * What the graph does with repeated links and self-loops.
+     */
+    EdgePolicy
+    policy_;
+
+    /**
+     * Links of the graph, when the edge policy is not Multigraph.
+     */
+    std::unordered_set<std::pair<const Vertex<T, W>*, const Vertex<T, W>*>, VertexPairHash>
+    linkIndex_;
+
+    template<equality_comparable, class>
+    friend struct GraphDelta;
+
 };
 
 
@@ -416,15 +1131,16 @@ public:
  * 
  * Template argument:
  * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
  */
-template<equality_comparable T>
-class DirectedGraph : public UndirectedGraph<T> {
+template<equality_comparable T, class W = void>
+class DirectedGraph : public UndirectedGraph<T, W> {
 
 public:
 
-    using UndirectedGraph<T>::vertexPtrMap_;
-    using UndirectedGraph<T>::contains;
-    using UndirectedGraph<T>::getEdgePairList;
+    using UndirectedGraph<T, W>::vertexPtrMap_;
+    using UndirectedGraph<T, W>::contains;
+    using UndirectedGraph<T, W>::getEdgePairList;
 
 
 public:
@@ -432,7 +1148,14 @@ public:
     /**
      * Constructor
      */
-    DirectedGraph() : UndirectedGraph<T>() {}
+    DirectedGraph() : UndirectedGraph<T, W>() {}
+
+    /**
+     * Constructor
+     * 
+     * @param policy What to do with repeated links and self-loops
+     */
+    DirectedGraph(EdgePolicy policy) : UndirectedGraph<T, W>(policy) {}
 
     /**
      * Copy constructor
@@ -442,45 +1165,118 @@ public:
      * 
      * @param g The graph to operate a copy from.
      */
-    DirectedGraph(const DirectedGraph<T>& g) : UndirectedGraph<T>() {
-        for(const auto& e : g.vertexPtrMap_) {
-            vertexPtrMap_.insert(std::pair(e.first, std::shared_ptr<Vertex<T>>(new Vertex<T>(e.first))));
-        }
-        for(const auto& q : g.vertexPtrMap_) {
-            for(const auto& p : q.second->linkVectorPtr_) {
-                if(g.isLinked(q.first, p.lock()->label_)) {
-                    link(q.first, p.lock()->label_);
-                }
-            }
-        }
-    }
+    DirectedGraph(const DirectedGraph<T, W>& g) : UndirectedGraph<T, W>()
+    { this->copyFrom(g); }
 
     /**
      * Constructor
      * 
      * @param vertexLabelList List of the vertex
      */
-    DirectedGraph(const std::initializer_list<Vertex<T>>& vertexList) : UndirectedGraph<T>(vertexList) { }
+    DirectedGraph(const std::initializer_list<Vertex<T, W>>& vertexList) : UndirectedGraph<T, W>(vertexList) { }
 
     /**
      * Constructor
      * 
      * @param vertexLabelList List of the vertex labels
      */
-    DirectedGraph(const std::initializer_list<T>& vertexLabelList) : UndirectedGraph<T>(vertexLabelList) { }
+    DirectedGraph(const std::initializer_list<T>& vertexLabelList) : UndirectedGraph<T, W>(vertexLabelList) { }
 
     /**
      * Create a link between vertex e1 and e2, in the e1 -> e2 way.
      * 
      * @param e1 the main vertex's label
      * @param e2 the second vertex's label
+     * @return false if a vertex is missing or the edge policy rejected the link
      */
-    void link(const T& e1, const T& e2) {
-        if( contains(e1) && contains(e2) ) {
+    bool link(const T& e1, const T& e2) {
+        if( contains(e1) && contains(e2) && this->acceptLink(vertexPtrMap_.at(e1).get(), vertexPtrMap_.at(e2).get(), false) ) {
             vertexPtrMap_.at(e1)->link(vertexPtrMap_.at(e2));
+            return true;
         }
+        return false;
     }
 
+    /**
+     * Create a weighted link between vertex e1 and e2, in the e1 -> e2 way.
+     * 
+     * @param e1 the main vertex's label
+     * @param e2 the second vertex's label
+     * @param weight the weight of the link
+     * @return false if a vertex is missing or the edge policy rejected the link
+     */
+    template<class U = W, class = std::enable_if_t<!std::is_void_v<U>>>
+    bool link(const T& e1, const T& e2, const U& weight) {
+        if( contains(e1) && contains(e2) && this->acceptLink(vertexPtrMap_.at(e1).get(), vertexPtrMap_.at(e2).get(), false) ) {
+            vertexPtrMap_.at(e1)->link(vertexPtrMap_.at(e2), weight);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Bulk creation of links from an edge list (list of label pairs),
+     * in the e1 -> e2 way.
+     * 
+     * Missing vertices are created, and each adjacency vector is grown
+     * once to its final size instead of once per link.
+     * 
+     * @param edgePairList vector of pairs of label corresponding to edge
+     */
+    void addEdgeList(const std::vector<std::pair<T, T>>& edgePairList)
+    { UndirectedGraph<T, W>::addEdgeList(edgePairList, false); }
+
+    /**
+     * Bulk creation of weighted links from an edge list (list of
+     * label, label, weight tuples), in the e1 -> e2 way.
+     * 
+     * @param edgeList vector of tuples corresponding to weighted edge
+     */
+    template<class U = W, class = std::enable_if_t<!std::is_void_v<U>>>
+    void addEdgeList(const std::vector<std::tuple<T, T, U>>& edgeList)
+    { UndirectedGraph<T, W>::addEdgeList(edgeList, false); }
+
+    /**
+     * Change the edge policy. The links already in the graph are made
+     * to follow it, as with deduplicate(); none is removed when the new
+     * policy is Multigraph.
+     * 
+     * @param policy What to do with repeated links and self-loops
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    void setEdgePolicy(EdgePolicy policy, unsigned int threadCount = 0)
+    { UndirectedGraph<T, W>::setEdgePolicy(policy, threadCount, false); }
+
+    /**
+     * Remove the repeated arcs, keeping the first one (and its weight)
+     * in each adjacency vector, and the self-loops if the edge policy is
+     * Simple.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    void deduplicate(unsigned int threadCount = 0)
+    { UndirectedGraph<T, W>::deduplicate(threadCount, false); }
+
+    /**
+     * Remove an arc e1 -> e2 (one of them, if repeated).
+     * 
+     * @param e1 the main vertex's label
+     * @param e2 the second vertex's label
+     * @return false if there was no such arc
+     */
+    bool unlink(const T& e1, const T& e2)
+    { return UndirectedGraph<T, W>::unlink(e1, e2, false); }
+
+    /**
+     * Remove a vertex, its arcs and the arcs toward it, found by a scan
+     * of all the vertices.
+     * 
+     * @param label the vertex's label
+     * @return false if there was no such vertex
+     */
+    bool removeVertex(const T& label)
+    { return UndirectedGraph<T, W>::removeVertex(label, false); }
+
     /**
      * Check whether there is a link between vertex e1 and e2
      * in the e1 -> e2 way.
@@ -490,9 +1286,13 @@ public:
      * @return true or false
      */
     bool isLinked(const T& e1, const T& e2) const {
+        GRAPHTHEWY_STATS_ADD(linkLookupCount_, 1);
         if( !contains(e1) || !contains(e2) ) {
             return false;
         }
+        if( this->policy_!=EdgePolicy::Multigraph ) {
+            return this->linkIndex_.count(this->linkKey(vertexPtrMap_.at(e1).get(), vertexPtrMap_.at(e2).get(), false))!=0;
+        }
         if( vertexPtrMap_.at(e1)->contains(e2) ) {
             return true;
         }
@@ -0,0 +1,233 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_PARALLEL_HPP_
+#define _GRAPH_MODEL_PARALLEL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Number of threads to use when the caller did not specify one.
+ * 
+ * @return the hardware concurrency, at least 1
+ */
+inline unsigned int defaultThreadCount() {
+    const unsigned int n = std::thread::hardware_concurrency();
+    return n==0 ? 1 : n;
+}
+
+/**
+ * Split the range [0, count) in at most threadCount contiguous chunks
+ * of equal size and run f(chunkIndex, begin, end) on each of them.
+ * 
+ * The first chunk runs on the calling thread, so that a threadCount of
+ * 1 never spawns a thread. An exception thrown by f on any chunk is
+ * rethrown on the calling thread once all the chunks are done, the one
+ * of the lowest chunk if several throw.
+ * 
+ * @param count The number of items
+ * @param threadCount The maximum number of threads
+ * @param f The function to call on each chunk
+ * @return the number of chunks actually used
+ */
+template<class F>
+unsigned int parallelChunks(std::size_t count, unsigned int threadCount, F&& f) {
+    if( threadCount==0 ) {
+        threadCount = defaultThreadCount();
+    }
+    const std::size_t chunkCount = std::max<std::size_t>(1, std::min<std::size_t>(threadCount, count));
+    const std::size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    // An exception escaping a thread would terminate the process
+    std::vector<std::exception_ptr> errorVector(chunkCount);
+    auto run = [&f, &errorVector](std::size_t c, std::size_t begin, std::size_t end) {
+        try {
+            f(static_cast<unsigned int>(c), begin, end);
+        } catch(...) {
+            errorVector[c] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threadVector;
+    threadVector.reserve(chunkCount - 1);
+    for(std::size_t c=1; c<chunkCount; c++) {
+        const std::size_t begin = std::min(count, c * chunkSize);
+        const std::size_t end = std::min(count, begin + chunkSize);
+        threadVector.emplace_back([&run, c, begin, end]() { run(c, begin, end); });
+    }
+    run(0, 0, std::min(count, chunkSize));
+    for(auto& t : threadVector) {
+        t.join();
+    }
+    for(const auto& error : errorVector) {
+        if( error ) {
+            std::rethrow_exception(error);
+        }
+    }
+    return static_cast<unsigned int>(chunkCount);
+}
+
+/**
+ * Reusable barrier: the threads calling wait() are blocked until all
+ * the threadCount threads have called it, then all resume.
+ */
+class ThreadBarrier {
+
+public:
+
+    /**
+     * Constructor
+     * 
+     * @param threadCount The number of threads meeting at the barrier
+     */
+    explicit ThreadBarrier(std::size_t threadCount)
+    : threadCount_(threadCount), waitingCount_(0), generation_(0) { }
+
+    /**
+     * Wait for the other threads.
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const std::size_t generation = generation_;
+        if( ++waitingCount_==threadCount_ ) {
+            waitingCount_ = 0;
+            generation_++;
+            condition_.notify_all();
+        } else {
+            condition_.wait(lock, [&]() { return generation_!=generation; });
+        }
+    }
+
+
+protected:
+
+    /**
+     * The number of threads meeting at the barrier.
+     */
+    std::size_t
+    threadCount_;
+
+    /**
+     * The number of threads waiting.
+     */
+    std::size_t
+    waitingCount_;
+
+    /**
+     * The number of times all the threads have met.
+     */
+    std::size_t
+    generation_;
+
+    std::mutex
+    mutex_;
+
+    std::condition_variable
+    condition_;
+
+};
+
+/**
+ * Run f(threadIndex, barrier) on threadCount threads at once, the first
+ * one being the calling thread. For iterative algorithms: the threads
+ * are started once, and meet at the barrier between the steps instead
+ * of being started again for each step. f must not throw between two
+ * barriers, or the other threads would wait for it forever.
+ * 
+ * @param threadCount The number of threads, 0 for the hardware concurrency
+ * @param f The function run by each thread
+ */
+template<class F>
+void parallelTeam(unsigned int threadCount, F&& f) {
+    if( threadCount==0 ) {
+        threadCount = defaultThreadCount();
+    }
+    ThreadBarrier barrier(threadCount);
+    parallelChunks(threadCount, threadCount, [&](unsigned int c, std::size_t, std::size_t) {
+        f(c, barrier);
+    });
+}
+
+/**
+ * Run f(threadIndex, i) on each item of the range [0, count), the
+ * threads taking blocks of items on demand. Better than parallelChunks()
+ * when the work per item is uneven, as with vertices of skewed degrees.
+ * An exception thrown by f is rethrown on the calling thread, as with
+ * parallelChunks().
+ * 
+ * @param count The number of items
+ * @param threadCount The number of threads, 0 for the hardware concurrency
+ * @param f The function to call on each item
+ * @param blockSize The number of items taken at once
+ */
+template<class F>
+void parallelDynamic(std::size_t count, unsigned int threadCount, F&& f, std::size_t blockSize = 64) {
+    if( threadCount==0 ) {
+        threadCount = defaultThreadCount();
+    }
+    std::atomic<std::size_t> next(0);
+    parallelChunks(threadCount, threadCount, [&](unsigned int c, std::size_t, std::size_t) {
+        for(std::size_t begin=next.fetch_add(blockSize); begin<count; begin=next.fetch_add(blockSize)) {
+            const std::size_t end = std::min(count, begin + blockSize);
+            for(std::size_t i=begin; i<end; i++) {
+                f(c, i);
+            }
+        }
+    });
+}
+
+/**
+ * Parallel sort: each thread sorts a contiguous chunk, then the sorted
+ * chunks are merged two by two, the merges of a level running in
+ * parallel. No memory is allocated per element.
+ * 
+ * @param begin The first element
+ * @param end Past the last element
+ * @param less The strict weak ordering
+ * @param threadCount The number of threads, 0 for the hardware concurrency
+ */
+template<class I, class C>
+void parallelSort(I begin, I end, C less, unsigned int threadCount = 0) {
+    const std::size_t count = static_cast<std::size_t>(end - begin);
+    if( threadCount==0 ) {
+        threadCount = defaultThreadCount();
+    }
+    const std::size_t chunkCount = std::max<std::size_t>(1, std::min<std::size_t>(threadCount, count / 4096));
+    const std::size_t chunkSize = (count + chunkCount - 1) / std::max<std::size_t>(1, chunkCount);
+    parallelChunks(chunkCount, static_cast<unsigned int>(chunkCount), [&](unsigned int, std::size_t first, std::size_t last) {
+        for(std::size_t c=first; c<last; c++) {
+            std::sort(begin + std::min(count, c * chunkSize), begin + std::min(count, (c + 1) * chunkSize), less);
+        }
+    });
+    for(std::size_t width=chunkSize; width<count; width*=2) {
+        const std::size_t mergeCount = (count + 2 * width - 1) / (2 * width);
+        parallelChunks(mergeCount, threadCount, [&](unsigned int, std::size_t first, std::size_t last) {
+            for(std::size_t m=first; m<last; m++) {
+                const std::size_t low = m * 2 * width;
+                const std::size_t middle = std::min(count, low + width);
+                std::inplace_merge(begin + low, begin + middle, begin + std::min(count, low + 2 * width), less);
+            }
+        });
+    }
+}
+
+}
+
+
+#endif // _GRAPH_MODEL_PARALLEL_HPP_
@@ -0,0 +1,426 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_PARSER_HPP_
+#define _GRAPH_MODEL_PARSER_HPP_
+
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Text formats understood by GraphParser.
+ * 
+ * - EdgeList = one "e1 e2" pair per line, '#' and '%' start a comment
+ * - Snap = the SNAP datasets format, same as EdgeList
+ * - Dimacs = "a e1 e2 [w]" or "e e1 e2" lines, 'c' comments, 'p' problem line and
+ *   'n' node designator lines (skipped)
+ * - MatrixMarket = coordinate format, '%' comments, the first data line is the size line;
+ *   with a symmetric, skew-symmetric or hermitian banner, each off-diagonal entry (i, j)
+ *   also gives the edge (j, i), with the opposite weight when skew-symmetric
+ */
+enum class GraphFormat {
+    EdgeList,
+    Snap,
+    Dimacs,
+    MatrixMarket
+};
+
+/**
+ * Streaming parser for graph text formats.
+ * 
+ * The input is read in large chunks, labels are parsed with
+ * std::from_chars, and each chunk can be split at line boundaries
+ * to be parsed by several threads. The result is an edge list to
+ * give to UndirectedGraph::addEdgeList or DirectedGraph::addEdgeList.
+ * 
+ * For a weighted graph, the column following the two labels is read as
+ * the weight of the edge (1 when absent).
+ * 
+ * Template argument:
+ * - T = the type of the vertex's label, integral or std::string
+ * - W = the type of the edge weight, arithmetic, or void (default) to ignore weights
+ */
+template<class T, class W = void>
+struct GraphParser {
+
+    /**
+     * Type of the parsed edges: (e1, e2) pairs, or (e1, e2, weight) tuples.
+     */
+    using EdgeType = std::conditional_t<std::is_void_v<W>, std::pair<T, T>, std::tuple<T, T, W>>;
+
+    /**
+     * Constructor
+     * 
+     * @param format The text format
+     * @param threadCount The number of threads used to parse each chunk
+     * @param bufferSize The size of the chunks, in bytes
+     */
+    GraphParser(GraphFormat format, unsigned int threadCount = 1, std::size_t bufferSize = 1 << 24)
+    : format_(format), threadCount_(threadCount), bufferSize_(std::max<std::size_t>(bufferSize, 64)) {
+        static_assert(
+            std::is_integral_v<T> || std::is_same_v<T, std::string>,
+            "Label type must be integral or std::string."
+        );
+        static_assert(
+            std::is_void_v<W> || std::is_arithmetic_v<W>,
+            "Weight type must be arithmetic."
+        );
+    }
+
+    /**
+     * Parse a file.
+     * 
+     * @param path The path of the file
+     * @return vector of pairs (or tuples) corresponding to edge
+     */
+    std::vector<EdgeType> parseFile(const std::string& path) const {
+        std::ifstream in(path, std::ios::in | std::ios::binary);
+        if( !in ) {
+            throw std::runtime_error("graphthewy: cannot open " + path);
+        }
+        return parse(in);
+    }
+
+    /**
+     * Parse a stream, chunk by chunk.
+     * 
+     * @param in The input stream
+     * @return vector of pairs (or tuples) corresponding to edge
+     */
+    std::vector<EdgeType> parse(std::istream& in) const {
+        std::vector<EdgeType> edgePairList;
+        std::vector<char> buffer(bufferSize_);
+        std::size_t carry = 0;
+        bool headerPending = format_==GraphFormat::MatrixMarket;
+        Symmetry symmetry = Symmetry::General;
+        while( true ) {
+            in.read(buffer.data() + carry, static_cast<std::streamsize>(buffer.size() - carry));
+            const std::size_t total = carry + static_cast<std::size_t>(in.gcount());
+            if( !in ) {
+                parseChunk(buffer.data(), buffer.data() + total, headerPending, symmetry, edgePairList);
+                break;
+            }
+            std::size_t cut = total;
+            while( cut>0 && buffer[cut - 1]!='\n' ) {
+                cut--;
+            }
+            if( cut==0 ) {
+                // A single line does not fit in the buffer
+                carry = total;
+                buffer.resize(buffer.size() * 2);
+                continue;
+            }
+            parseChunk(buffer.data(), buffer.data() + cut, headerPending, symmetry, edgePairList);
+            carry = total - cut;
+            std::memmove(buffer.data(), buffer.data() + cut, carry);
+        }
+        return edgePairList;
+    }
+
+    /**
+     * Parse a string.
+     * 
+     * @param text The text to parse
+     * @return vector of pairs (or tuples) corresponding to edge
+     */
+    std::vector<EdgeType> parseString(const std::string& text) const {
+        std::vector<EdgeType> edgePairList;
+        bool headerPending = format_==GraphFormat::MatrixMarket;
+        Symmetry symmetry = Symmetry::General;
+        parseChunk(text.data(), text.data() + text.size(), headerPending, symmetry, edgePairList);
+        return edgePairList;
+    }
+
+
+protected:
+
+    /**
+     * Symmetry declared by a Matrix Market banner.
+     */
+    enum class Symmetry {
+        General,
+        Symmetric,
+        SkewSymmetric
+    };
+
+    /**
+     * Parse a chunk made of complete lines, in parallel if
+     * the chunk is large enough.
+     * 
+     * @param begin The beginning of the chunk
+     * @param end The end of the chunk
+     * @param headerPending true while the Matrix Market size line has not been read
+     * @param symmetry The symmetry of the Matrix Market banner, set when it is read
+     * @param edgePairList The edge list to append to
+     */
+    void parseChunk(const char* begin, const char* end, bool& headerPending, Symmetry& symmetry, std::vector<EdgeType>& edgePairList) const {
+        while( headerPending && begin<end ) {
+            const char* eol = lineEnd(begin, end);
+            const char* p = skipBlank(begin, eol);
+            if( eol - p>=14 && std::memcmp(p, "%%MatrixMarket", 14)==0 ) {
+                symmetry = parseBanner(p + 14, eol);
+            } else if( p!=eol && *p!='%' ) {
+                headerPending = false;
+            }
+            begin = eol==end ? end : eol + 1;
+        }
+        const std::size_t length = static_cast<std::size_t>(end - begin);
+        const unsigned int partCount = threadCount_<=1 || length<(1 << 16) ? 1 : threadCount_;
+        if( partCount==1 ) {
+            parseLines(begin, end, symmetry, edgePairList);
+            return;
+        }
+        std::vector<const char*> bound(partCount + 1, end);
+        bound[0] = begin;
+        for(unsigned int i=1; i<partCount; i++) {
+            const char* p = std::max(bound[i - 1], begin + length * i / partCount);
+            p = lineEnd(p, end);
+            bound[i] = p==end ? end : p + 1;
+        }
+        std::vector<std::vector<EdgeType>> partList(partCount);
+        parallelChunks(partCount, partCount, [&](unsigned int, std::size_t b, std::size_t e) {
+            for(std::size_t i=b; i<e; i++) {
+                parseLines(bound[i], bound[i + 1], symmetry, partList[i]);
+            }
+        });
+        std::size_t total = edgePairList.size();
+        for(const auto& part : partList) {
+            total += part.size();
+        }
+        edgePairList.reserve(total);
+        for(auto& part : partList) {
+            std::move(part.begin(), part.end(), std::back_inserter(edgePairList));
+        }
+    }
+
+    /**
+     * Parse complete lines.
+     * 
+     * @param begin The beginning of the first line
+     * @param end The end of the last line
+     * @param symmetry Whether each off-diagonal edge is also given reversed
+     * @param edgePairList The edge list to append to
+     */
+    void parseLines(const char* begin, const char* end, Symmetry symmetry, std::vector<EdgeType>& edgePairList) const {
+        while( begin<end ) {
+            const char* eol = lineEnd(begin, end);
+            const char* p = skipBlank(begin, eol);
+            if( p!=eol && !isComment(*p) ) {
+                if( format_==GraphFormat::Dimacs ) {
+                    if( *p=='p' || *p=='n' ) {
+                        begin = eol==end ? end : eol + 1;
+                        continue;
+                    }
+                    if( *p!='a' && *p!='e' ) {
+                        throw std::runtime_error("graphthewy: malformed line: " + std::string(begin, eol));
+                    }
+                    p++;
+                }
+                T e1, e2;
+                if( !parseLabel(p, eol, e1) || !parseLabel(p, eol, e2) ) {
+                    throw std::runtime_error("graphthewy: malformed line: " + std::string(begin, eol));
+                }
+                const bool mirrored = symmetry!=Symmetry::General && !(e1==e2);
+                if constexpr( std::is_void_v<W> ) {
+                    if( mirrored ) {
+                        edgePairList.emplace_back(e1, e2);
+                        edgePairList.emplace_back(std::move(e2), std::move(e1));
+                    } else {
+                        edgePairList.emplace_back(std::move(e1), std::move(e2));
+                    }
+                } else {
+                    W weight = W(1);
+                    if( skipBlank(p, eol)!=eol && !parseWeight(p, eol, weight) ) {
+                        throw std::runtime_error("graphthewy: malformed line: " + std::string(begin, eol));
+                    }
+                    if( mirrored ) {
+                        W opposite = weight;
+                        if constexpr( std::is_signed_v<W> ) {
+                            opposite = symmetry==Symmetry::SkewSymmetric ? -weight : weight;
+                        }
+                        edgePairList.emplace_back(e1, e2, weight);
+                        edgePairList.emplace_back(std::move(e2), std::move(e1), opposite);
+                    } else {
+                        edgePairList.emplace_back(std::move(e1), std::move(e2), weight);
+                    }
+                }
+            }
+            begin = eol==end ? end : eol + 1;
+        }
+    }
+
+    /**
+     * Parse the rest of a Matrix Market banner line,
+     * "%%MatrixMarket matrix coordinate <field> <symmetry>".
+     * 
+     * @param p The position after "%%MatrixMarket"
+     * @param eol The end of the line
+     * @return the symmetry
+     */
+    static Symmetry parseBanner(const char* p, const char* eol) {
+        Symmetry symmetry = Symmetry::General;
+        while( (p = skipBlank(p, eol))!=eol ) {
+            std::string token;
+            while( p<eol && !isBlank(*p) ) {
+                token.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(*p))));
+                p++;
+            }
+            if( token=="array" ) {
+                throw std::runtime_error("graphthewy: only the coordinate Matrix Market format is supported");
+            }
+            if( token=="symmetric" || token=="hermitian" ) {
+                symmetry = Symmetry::Symmetric;
+            } else if( token=="skew-symmetric" ) {
+                symmetry = Symmetry::SkewSymmetric;
+            }
+        }
+        return symmetry;
+    }
+
+    /**
+     * Parse the next label of a line.
+     * 
+     * @param p The current position, moved after the label
+     * @param eol The end of the line
+     * @param label The parsed label
+     * @return true if a label has been parsed
+     */
+    static bool parseLabel(const char*& p, const char* eol, T& label) {
+        p = skipBlank(p, eol);
+        const char* tokenEnd = p;
+        while( tokenEnd<eol && !isBlank(*tokenEnd) ) {
+            tokenEnd++;
+        }
+        if( tokenEnd==p ) {
+            return false;
+        }
+        if constexpr( std::is_integral_v<T> ) {
+            const auto result = std::from_chars(p, tokenEnd, label);
+            if( result.ec!=std::errc() || result.ptr!=tokenEnd ) {
+                return false;
+            }
+        } else {
+            label.assign(p, tokenEnd);
+        }
+        p = tokenEnd;
+        return true;
+    }
+
+    /**
+     * Parse the weight column of a line.
+     * 
+     * @param p The current position, moved after the weight
+     * @param eol The end of the line
+     * @param weight The parsed weight
+     * @return true if a weight has been parsed
+     */
+    template<class U = W>
+    static bool parseWeight(const char*& p, const char* eol, U& weight) {
+        p = skipBlank(p, eol);
+        const char* tokenEnd = p;
+        while( tokenEnd<eol && !isBlank(*tokenEnd) ) {
+            tokenEnd++;
+        }
+        if constexpr( std::is_integral_v<U> ) {
+            const auto result = std::from_chars(p, tokenEnd, weight);
+            if( result.ec!=std::errc() || result.ptr!=tokenEnd ) {
+                return false;
+            }
+        } else {
+            char token[64];
+            const std::size_t length = static_cast<std::size_t>(tokenEnd - p);
+            if( length==0 || length>=sizeof(token) ) {
+                return false;
+            }
+            std::memcpy(token, p, length);
+            token[length] = '\0';
+            char* parsedEnd = nullptr;
+            weight = static_cast<U>(std::strtod(token, &parsedEnd));
+            if( parsedEnd!=token + length ) {
+                return false;
+            }
+        }
+        p = tokenEnd;
+        return true;
+    }
+
+    /**
+     * To check whether a line starting with c is a comment.
+     * 
+     * @param c The first non blank character of the line
+     * @return true or false
+     */
+    bool isComment(char c) const {
+        switch( format_ ) {
+            case GraphFormat::Dimacs: return c=='c';
+            case GraphFormat::MatrixMarket: return c=='%';
+            default: return c=='#' || c=='%';
+        }
+    }
+
+    static bool isBlank(char c) { return c==' ' || c=='\t' || c=='\r' || c==','; }
+
+    static const char* skipBlank(const char* p, const char* end) {
+        while( p<end && isBlank(*p) ) {
+            p++;
+        }
+        return p;
+    }
+
+    static const char* lineEnd(const char* p, const char* end) {
+        const void* eol = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+        return eol==nullptr ? end : static_cast<const char*>(eol);
+    }
+
+
+protected:
+
+    /**
+     * The text format.
+     */
+    GraphFormat
+    format_;
+
+    /**
+     * The number of threads used to parse each chunk.
+     */
+    unsigned int
+    threadCount_;
+
+    /**
+     * The size of the chunks, in bytes.
+     */
+    std::size_t
+    bufferSize_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_PARSER_HPP_
@@ -0,0 +1,397 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_RANDOM_WALK_HPP_
+#define _GRAPH_MODEL_RANDOM_WALK_HPP_
+
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyGenerator.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Random walks over a snapshot, for instance to train vertex embeddings
+ * (DeepWalk, node2vec).
+ * 
+ * From a vertex, a walk follows one of its arcs, uniformly in an
+ * unweighted graph, proportionally to the weights otherwise. The
+ * weighted choice is made in constant time by an alias table per vertex
+ * (Walker, Vose), kept in two flat vectors along the arcs. With the
+ * node2vec bias, the arc is then accepted or drawn again depending on
+ * the previous vertex, so that the second order walk needs no table per
+ * pair of arcs.
+ * 
+ * The walk w starts at the vertex w % order(), and every draw of the
+ * walk w is counterRandom(seed, w, draw number): the walks only depend
+ * on the seed, not on the number of threads. A walk reaching a vertex
+ * without any arc stops, the rest of its row being noVertex.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct RandomWalker {
+
+    /**
+     * Constructor, building the alias tables of a weighted snapshot.
+     * 
+     * @param snapshot The snapshot of the graph, with non-negative weights
+     * @param seed The seed of the walks
+     * @param threadCount The number of threads of the alias tables, 0 for the hardware concurrency
+     */
+    RandomWalker(const GraphSnapshot<T, W>& snapshot, std::uint64_t seed = 0, unsigned int threadCount = 0)
+    : snapshot_(snapshot), seed_(seed), returnWeight_(1.0), outWeight_(1.0), maxWeight_(1.0) {
+        if constexpr( !std::is_void_v<W> ) {
+            buildAliasTables(threadCount);
+        }
+    }
+
+    /**
+     * Bias the walks as node2vec: from v, reached from u, the next vertex
+     * x is weighted by 1 / p if x is u, by 1 if x is a neighbor of u, by
+     * 1 / q otherwise, on top of the weight of the arc. p = q = 1 (the
+     * default) gives the plain walks.
+     * 
+     * @param p The return parameter, a high value avoids going back
+     * @param q The in-out parameter, a high value keeps the walk near its previous vertex
+     */
+    void setBias(double p, double q) {
+        if( !(p>0.0) || !(q>0.0) ) {
+            throw std::runtime_error("graphthewy: node2vec parameters must be positive");
+        }
+        returnWeight_ = 1.0 / p;
+        outWeight_ = 1.0 / q;
+        maxWeight_ = std::max({returnWeight_, 1.0, outWeight_});
+    }
+
+    /**
+     * @param walksPerVertex The number of walks from each vertex
+     * @return the number of walks, and of rows of the buffer
+     */
+    std::size_t walkCount(std::size_t walksPerVertex) const
+    { return walksPerVertex * snapshot_.order(); }
+
+    /**
+     * Walk into a buffer allocated by the caller, the threads taking
+     * blocks of walks.
+     * 
+     * @param walksPerVertex The number of walks from each vertex
+     * @param length The number of vertices of a walk, its start included
+     * @param buffer The rows of the walks, of walkCount(walksPerVertex) * length vertex identifiers
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    void walk(std::size_t walksPerVertex, std::size_t length, VertexId* buffer, unsigned int threadCount = 0) const {
+        GRAPHTHEWY_STATS_TIMER(timer, "randomWalks");
+        walkRange(0, walkCount(walksPerVertex), length, buffer, threadCount);
+        GRAPHTHEWY_STATS_VISIT(timer, walkCount(walksPerVertex), walkCount(walksPerVertex) * (length>0 ? length - 1 : 0));
+    }
+
+    /**
+     * Walk into a new buffer.
+     * 
+     * @param walksPerVertex The number of walks from each vertex
+     * @param length The number of vertices of a walk, its start included
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the rows of the walks, of length vertex identifiers each
+     */
+    std::vector<VertexId> walk(std::size_t walksPerVertex, std::size_t length, unsigned int threadCount = 0) const {
+        std::vector<VertexId> buffer(walkCount(walksPerVertex) * length);
+        walk(walksPerVertex, length, buffer.data(), threadCount);
+        return buffer;
+    }
+
+    /**
+     * Walk into a text file, one walk per line as labels separated by
+     * spaces, as read by word2vec. The walks are made by blocks in
+     * memory, so that the file may be far larger than the memory.
+     * 
+     * @param path The path of the file, replaced
+     * @param walksPerVertex The number of walks from each vertex
+     * @param length The number of vertices of a walk, its start included
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the number of walks written
+     */
+    std::size_t writeWalks(const std::string& path, std::size_t walksPerVertex, std::size_t length, unsigned int threadCount = 0) const {
+        GRAPHTHEWY_STATS_TIMER(timer, "randomWalks");
+        std::ofstream out(path, std::ios::trunc);
+        if( !out ) {
+            throw std::runtime_error("graphthewy: cannot open " + path);
+        }
+        if( threadCount==0 ) {
+            threadCount = defaultThreadCount();
+        }
+        const std::size_t count = walkCount(walksPerVertex);
+        const std::size_t blockSize = std::max<std::size_t>(1, (std::size_t(1) << 20) / std::max<std::size_t>(1, length)) * threadCount;
+        std::vector<VertexId> buffer(std::min(count, blockSize) * length);
+        for(std::size_t first=0; first<count; first+=blockSize) {
+            const std::size_t last = std::min(count, first + blockSize);
+            walkRange(first, last, length, buffer.data(), threadCount);
+            for(std::size_t w=0; w<last - first; w++) {
+                const VertexId* row = buffer.data() + w * length;
+                for(std::size_t s=0; s<length && row[s]!=noVertex; s++) {
+                    if( s>0 ) {
+                        out << ' ';
+                    }
+                    out << snapshot_.label(row[s]);
+                }
+                out << '\n';
+            }
+        }
+        out.flush();
+        if( !out ) {
+            throw std::runtime_error("graphthewy: cannot write " + path);
+        }
+        GRAPHTHEWY_STATS_VISIT(timer, count, count * (length>0 ? length - 1 : 0));
+        return count;
+    }
+
+    /**
+     * Marks the end of a walk stopped at a vertex without any arc.
+     */
+    static constexpr VertexId noVertex = std::numeric_limits<VertexId>::max();
+
+
+protected:
+
+    /**
+     * Alias tables (Vose): for each vertex, the probabilities of its arcs
+     * scaled by its degree are split into slots of 1, each holding its
+     * own arc up to probabilityVector_ and the arc aliasVector_ above.
+     * A vertex whose weights are all 0 is walked uniformly.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    void buildAliasTables(unsigned int threadCount) {
+        const std::size_t n = snapshot_.order();
+        if constexpr( std::is_signed_v<W> ) {
+            for(std::size_t a=0; a<snapshot_.arcCount(); a++) {
+                if( snapshot_.weight(a)<0 ) {
+                    throw std::runtime_error("graphthewy: random walks need non-negative weights");
+                }
+            }
+        }
+        if( threadCount==0 ) {
+            threadCount = defaultThreadCount();
+        }
+        probabilityVector_.resize(snapshot_.arcCount());
+        aliasVector_.resize(snapshot_.arcCount());
+        std::vector<std::vector<std::uint32_t>> smallVector(threadCount);
+        std::vector<std::vector<std::uint32_t>> largeVector(threadCount);
+        std::vector<std::vector<double>> scaledVector(threadCount);
+        parallelDynamic(n, threadCount, [&](unsigned int c, std::size_t u) {
+            const std::size_t begin = snapshot_.offsetVector_[u];
+            const std::size_t d = snapshot_.offsetVector_[u + 1] - begin;
+            double total = 0.0;
+            for(std::size_t i=0; i<d; i++) {
+                total += static_cast<double>(snapshot_.weight(begin + i));
+            }
+            auto& small = smallVector[c];
+            auto& large = largeVector[c];
+            auto& scaled = scaledVector[c];
+            small.clear();
+            large.clear();
+            scaled.resize(d);
+            for(std::size_t i=0; i<d; i++) {
+                scaled[i] = total>0.0 ? static_cast<double>(snapshot_.weight(begin + i)) * static_cast<double>(d) / total : 1.0;
+                (scaled[i]<1.0 ? small : large).push_back(static_cast<std::uint32_t>(i));
+            }
+            while( !small.empty() && !large.empty() ) {
+                const std::uint32_t s = small.back();
+                const std::uint32_t l = large.back();
+                small.pop_back();
+                probabilityVector_[begin + s] = static_cast<float>(scaled[s]);
+                aliasVector_[begin + s] = l;
+                scaled[l] -= 1.0 - scaled[s];
+                if( scaled[l]<1.0 ) {
+                    large.pop_back();
+                    small.push_back(l);
+                }
+            }
+            // Left over by rounding: full slots
+            for(const std::uint32_t i : small) {
+                probabilityVector_[begin + i] = 1.0f;
+                aliasVector_[begin + i] = i;
+            }
+            for(const std::uint32_t i : large) {
+                probabilityVector_[begin + i] = 1.0f;
+                aliasVector_[begin + i] = i;
+            }
+        }, 256);
+    }
+
+    /**
+     * Check whether there is an arc, by binary search of the sorted
+     * neighbors.
+     * 
+     * @param u the source
+     * @param v the target
+     * @return true if the arc exists
+     */
+    bool hasArc(VertexId u, VertexId v) const {
+        const auto range = snapshot_.neighbors(u);
+        return std::binary_search(range.begin(), range.end(), v);
+    }
+
+    /**
+     * Number of walks made together by a thread: their steps are
+     * independent, so that the cache misses of one walk overlap those
+     * of the others instead of being waited for one after the other.
+     */
+    static constexpr std::size_t groupSize = 16;
+
+    /**
+     * Make some walks, the threads taking groups of walks.
+     * 
+     * @param first The first walk
+     * @param last Past the last walk
+     * @param length The number of vertices of a walk
+     * @param buffer The rows of the walks, starting at the walk first
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    void walkRange(std::size_t first, std::size_t last, std::size_t length, VertexId* buffer, unsigned int threadCount) const {
+        if( length==0 || snapshot_.order()==0 ) {
+            return;
+        }
+        const std::size_t groupCount = (last - first + groupSize - 1) / groupSize;
+        parallelDynamic(groupCount, threadCount, [&](unsigned int, std::size_t g) {
+            const std::size_t begin = first + g * groupSize;
+            walkGroup(begin, std::min(last, begin + groupSize) - begin, length, buffer + g * groupSize * length);
+        }, 16);
+    }
+
+    /**
+     * Make up to groupSize walks, step by step.
+     * 
+     * @param first The number of the first walk
+     * @param count The number of walks
+     * @param length The number of vertices of a walk
+     * @param rows The rows of the walks
+     */
+    void walkGroup(std::size_t first, std::size_t count, std::size_t length, VertexId* rows) const {
+        VertexId current[groupSize];
+        VertexId previous[groupSize];
+        std::uint64_t draw[groupSize];
+        for(std::size_t j=0; j<count; j++) {
+            current[j] = static_cast<VertexId>((first + j) % snapshot_.order());
+            previous[j] = noVertex;
+            draw[j] = 0;
+            rows[j * length] = current[j];
+        }
+        for(std::size_t s=1; s<length; s++) {
+            for(std::size_t j=0; j<count; j++) {
+                if( current[j]!=noVertex ) {
+                    const VertexId next = step(first + j, current[j], previous[j], draw[j]);
+                    previous[j] = current[j];
+                    current[j] = next;
+                }
+                rows[j * length + s] = current[j];
+            }
+        }
+    }
+
+    /**
+     * Draw the next vertex of a walk.
+     * 
+     * @param w The number of the walk
+     * @param u The current vertex
+     * @param previous The previous vertex, noVertex at the start
+     * @param draw The number of the next draw of the walk, advanced
+     * @return the next vertex, noVertex if u has no arc
+     */
+    VertexId step(std::size_t w, VertexId u, VertexId previous, std::uint64_t& draw) const {
+        const std::size_t begin = snapshot_.offsetVector_[u];
+        const std::uint64_t d = snapshot_.offsetVector_[u + 1] - begin;
+        if( d==0 ) {
+            return noVertex;
+        }
+        const bool biased = returnWeight_!=1.0 || outWeight_!=1.0;
+        for(;;) {
+            // High bits pick the slot, low bits toss its coin
+            const std::uint64_t r = counterRandom(seed_, w, draw++);
+            std::size_t i = static_cast<std::size_t>(((r >> 32) * d) >> 32);
+            if constexpr( !std::is_void_v<W> ) {
+                if( static_cast<float>(static_cast<std::uint32_t>(r) * 0x1.0p-32)>=probabilityVector_[begin + i] ) {
+                    i = aliasVector_[begin + i];
+                }
+            }
+            const VertexId next = snapshot_.targetVector_[begin + i];
+            if( !biased || previous==noVertex ) {
+                return next;
+            }
+            const double weight = next==previous ? returnWeight_ : (hasArc(previous, next) ? 1.0 : outWeight_);
+            if( counterUniform(seed_, w, draw++) * maxWeight_<weight ) {
+                return next;
+            }
+        }
+    }
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * The seed of the walks.
+     */
+    std::uint64_t
+    seed_;
+
+    /**
+     * Weight of the arc back to the previous vertex, 1 / p.
+     */
+    double
+    returnWeight_;
+
+    /**
+     * Weight of the arcs away from the previous vertex, 1 / q.
+     */
+    double
+    outWeight_;
+
+    /**
+     * Largest of the node2vec weights, to accept the draws.
+     */
+    double
+    maxWeight_;
+
+    /**
+     * Probability of each slot to keep its own arc, by arc index.
+     */
+    std::vector<float>
+    probabilityVector_;
+
+    /**
+     * Arc of each slot otherwise, as an index among the arcs of its vertex.
+     */
+    std::vector<std::uint32_t>
+    aliasVector_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_RANDOM_WALK_HPP_
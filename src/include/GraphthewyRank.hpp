@@ -0,0 +1,421 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_RANK_HPP_
+#define _GRAPH_MODEL_RANK_HPP_
+
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyParallel.hpp"
+#include "GraphthewyIntersection.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Sum of values picked by index, with 4 independent accumulators so that
+ * the additions do not wait for each other.
+ * 
+ * @param values The values
+ * @param index The indices of the values to add
+ * @param count The number of indices
+ * @return the sum
+ */
+template<class R>
+inline R gatherSum(const R* values, const VertexId* index, std::size_t count) {
+    R s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    std::size_t i = 0;
+    for(; i + 4<=count; i+=4) {
+        s0 += values[index[i]];
+        s1 += values[index[i + 1]];
+        s2 += values[index[i + 2]];
+        s3 += values[index[i + 3]];
+    }
+    for(; i<count; i++) {
+        s0 += values[index[i]];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+#ifdef GRAPHTHEWY_X86_SIMD
+
+/**
+ * Sum of doubles picked by index, gathering 8 of them per step into 2
+ * accumulators (AVX2). The indices must fit a signed 32-bit integer.
+ * 
+ * @param values The values
+ * @param index The indices of the values to add
+ * @param count The number of indices
+ * @return the sum
+ */
+__attribute__((target("avx2")))
+inline double gatherSumAvx2(const double* values, const VertexId* index, std::size_t count) {
+    // The masked form, whose source is defined, rather than _mm256_i32gather_pd
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    __m256d s0 = zero, s1 = zero;
+    std::size_t i = 0;
+    for(; i + 8<=count; i+=8) {
+        const __m256i vi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + i));
+        s0 = _mm256_add_pd(s0, _mm256_mask_i32gather_pd(zero, values, _mm256_castsi256_si128(vi), all, 8));
+        s1 = _mm256_add_pd(s1, _mm256_mask_i32gather_pd(zero, values, _mm256_extracti128_si256(vi, 1), all, 8));
+    }
+    const __m256d s = _mm256_add_pd(s0, s1);
+    const __m128d h = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h))) + gatherSum(values, index + i, count - i);
+}
+
+/**
+ * Sum of floats picked by index, gathering 16 of them per step into 2
+ * accumulators (AVX2). The indices must fit a signed 32-bit integer.
+ * 
+ * @param values The values
+ * @param index The indices of the values to add
+ * @param count The number of indices
+ * @return the sum
+ */
+__attribute__((target("avx2")))
+inline float gatherSumAvx2(const float* values, const VertexId* index, std::size_t count) {
+    __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for(; i + 16<=count; i+=16) {
+        const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + i));
+        const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + i + 8));
+        s0 = _mm256_add_ps(s0, _mm256_i32gather_ps(values, v0, 4));
+        s1 = _mm256_add_ps(s1, _mm256_i32gather_ps(values, v1, 4));
+    }
+    const __m256 s = _mm256_add_ps(s0, s1);
+    __m128 h = _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1));
+    h = _mm_add_ps(h, _mm_movehl_ps(h, h));
+    h = _mm_add_ss(h, _mm_shuffle_ps(h, h, 0x55));
+    return _mm_cvtss_f32(h) + gatherSum(values, index + i, count - i);
+}
+
+#endif
+
+/**
+ * Iterative vertex rankings (PageRank, personalized PageRank, Katz) on a
+ * snapshot. Each iteration is a sparse matrix-vector product in pull
+ * form: every vertex sums the contributions of its in-neighbors, so that
+ * the threads write disjoint ranges and only meet at a barrier between
+ * phases. The threads are started once per computation, and the ranges
+ * are balanced by number of in-links, not of vertices. The sums gather
+ * the values with AVX2 when the processor has it. Weights are not used.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ * - R = the type of the scores, float or double (default)
+ */
+template<equality_comparable T, class W = void, class R = double>
+struct GraphRank {
+
+    /**
+     * Constructor, extracting the in-links of the snapshot.
+     * 
+     * @param snapshot The snapshot of the graph
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    GraphRank(const GraphSnapshot<T, W>& snapshot, unsigned int threadCount = 0)
+    : snapshot_(snapshot), iterationCount_(0),
+      gather_(simdLevel()==SimdLevel::Avx2 && snapshot.order()<=static_cast<std::size_t>(INT32_MAX)) {
+        const std::size_t n = snapshot_.order();
+        if( snapshot_.isDirected() ) {
+            const GraphSnapshot<T, W> in = snapshot_.transpose();
+            inOffsetVector_ = in.offsetVector_;
+            inSourceVector_ = in.targetVector_;
+        } else {
+            inOffsetVector_ = snapshot_.offsetVector_;
+            inSourceVector_ = snapshot_.targetVector_;
+        }
+        inverseDegreeVector_.assign(n, R(0));
+        for(VertexId v=0; v<n; v++) {
+            const std::size_t degree = snapshot_.degree(v);
+            inverseDegreeVector_[v] = degree==0 ? R(0) : R(1) / static_cast<R>(degree);
+        }
+        balance(threadCount==0 ? defaultThreadCount() : threadCount);
+    }
+
+    /**
+     * PageRank: the stationary distribution of a walk following a random
+     * out-link with probability damping, and jumping to a random vertex
+     * otherwise. The mass of the vertices without out-link is spread
+     * over all the vertices.
+     * 
+     * @param damping The probability of following a link
+     * @param tolerance The L1 change between two iterations to stop at
+     * @param maxIterations The maximal number of iterations
+     */
+    void pageRank(R damping = R(0.85), R tolerance = R(1e-9), std::size_t maxIterations = 100) {
+        const std::size_t n = snapshot_.order();
+        iterate(std::vector<R>(n, n==0 ? R(0) : R(1) / static_cast<R>(n)), damping, tolerance, maxIterations);
+    }
+
+    /**
+     * Personalized PageRank: as pageRank(), but the jumps (and the mass
+     * of the vertices without out-link) go to the seed vertices only.
+     * 
+     * @param seeds The labels of the seed vertices
+     * @param damping The probability of following a link
+     * @param tolerance The L1 change between two iterations to stop at
+     * @param maxIterations The maximal number of iterations
+     */
+    void personalizedPageRank(const std::vector<T>& seeds, R damping = R(0.85), R tolerance = R(1e-9), std::size_t maxIterations = 100) {
+        std::vector<R> teleportVector(snapshot_.order(), R(0));
+        for(const T& seed : seeds) {
+            teleportVector[snapshot_.idOf(seed)] += R(1) / static_cast<R>(seeds.size());
+        }
+        iterate(teleportVector, damping, tolerance, maxIterations);
+    }
+
+    /**
+     * Katz centrality: x = alpha.Aᵀx + beta, the number of walks ending at
+     * each vertex, those of length k weighted by alpha^k. The scores are
+     * not normalized. It converges when alpha is lower than the inverse
+     * of the largest eigenvalue of the adjacency matrix.
+     * 
+     * @param alpha The attenuation factor
+     * @param beta The score given to every vertex
+     * @param tolerance The L1 change between two iterations to stop at
+     * @param maxIterations The maximal number of iterations
+     */
+    void katz(R alpha = R(0.1), R beta = R(1), R tolerance = R(1e-9), std::size_t maxIterations = 100) {
+        GRAPHTHEWY_STATS_TIMER(timer, "katz");
+        const std::size_t n = snapshot_.order();
+        const std::size_t rangeCount = boundVector_.size() - 1;
+        std::vector<R> firstVector(n, beta), secondVector(n);
+        // By iteration parity, so that a thread never overwrites a partial
+        // result another one is still adding up
+        std::vector<R> partialVector[2] = {std::vector<R>(rangeCount), std::vector<R>(rangeCount)};
+        parallelTeam(static_cast<unsigned int>(rangeCount), [&](unsigned int c, ThreadBarrier& barrier) {
+            std::vector<R>* current = &firstVector;
+            std::vector<R>* next = &secondVector;
+            std::size_t i = 0;
+            while( i<maxIterations ) {
+                std::vector<R>& partials = partialVector[i % 2];
+                R change = 0;
+                for(std::size_t v=boundVector_[c]; v<boundVector_[c + 1]; v++) {
+                    (*next)[v] = alpha * pull(*current, v) + beta;
+                    change += std::abs((*next)[v] - (*current)[v]);
+                }
+                partials[c] = change;
+                barrier.wait();
+                i++;
+                std::swap(current, next);
+                if( sum(partials) < tolerance ) {
+                    break;
+                }
+            }
+            if( c==0 ) {
+                iterationCount_ = i;
+            }
+        });
+        GRAPHTHEWY_STATS_VISIT(timer, n * iterationCount_, inSourceVector_.size() * iterationCount_);
+        scoreVector_ = std::move(iterationCount_ % 2==0 ? firstVector : secondVector);
+    }
+
+    /**
+     * Score of a vertex, after pageRank(), personalizedPageRank() or katz().
+     * 
+     * @param label the vertex's label
+     * @return the score
+     */
+    R score(const T& label) const
+    { return scoreVector_[snapshot_.idOf(label)]; }
+
+    /**
+     * Scores, by vertex identifier.
+     * 
+     * @return the vector of scores
+     */
+    const std::vector<R>& scoreVector() const
+    { return scoreVector_; }
+
+    /**
+     * Number of iterations run by the last computation.
+     * 
+     * @return the number of iterations
+     */
+    std::size_t iterationCount() const
+    { return iterationCount_; }
+
+
+protected:
+
+    /**
+     * Power iteration of the (personalized) PageRank.
+     * 
+     * @param teleportVector The jump probability of each vertex
+     * @param damping The probability of following a link
+     * @param tolerance The L1 change between two iterations to stop at
+     * @param maxIterations The maximal number of iterations
+     */
+    void iterate(const std::vector<R>& teleportVector, R damping, R tolerance, std::size_t maxIterations) {
+        GRAPHTHEWY_STATS_TIMER(timer, "pageRank");
+        const std::size_t n = snapshot_.order();
+        const std::size_t rangeCount = boundVector_.size() - 1;
+        std::vector<R> firstVector(teleportVector), secondVector(n), contributionVector(n);
+        // Each is written before a barrier and read between it and the next
+        std::vector<R> danglingVector(rangeCount), changeVector(rangeCount);
+        parallelTeam(static_cast<unsigned int>(rangeCount), [&](unsigned int c, ThreadBarrier& barrier) {
+            std::vector<R>* current = &firstVector;
+            std::vector<R>* next = &secondVector;
+            const std::size_t begin = boundVector_[c];
+            const std::size_t end = boundVector_[c + 1];
+            std::size_t i = 0;
+            while( i<maxIterations ) {
+                R dangling = 0;
+                for(std::size_t v=begin; v<end; v++) {
+                    contributionVector[v] = (*current)[v] * inverseDegreeVector_[v];
+                    dangling += inverseDegreeVector_[v]==R(0) ? (*current)[v] : R(0);
+                }
+                danglingVector[c] = dangling;
+                barrier.wait();
+                const R jump = R(1) - damping + damping * sum(danglingVector);
+                R change = 0;
+                for(std::size_t v=begin; v<end; v++) {
+                    (*next)[v] = damping * pull(contributionVector, v) + jump * teleportVector[v];
+                    change += std::abs((*next)[v] - (*current)[v]);
+                }
+                changeVector[c] = change;
+                barrier.wait();
+                i++;
+                std::swap(current, next);
+                if( sum(changeVector) < tolerance ) {
+                    break;
+                }
+            }
+            if( c==0 ) {
+                iterationCount_ = i;
+            }
+        });
+        GRAPHTHEWY_STATS_VISIT(timer, n * iterationCount_, inSourceVector_.size() * iterationCount_);
+        scoreVector_ = std::move(iterationCount_ % 2==0 ? firstVector : secondVector);
+    }
+
+    /**
+     * Sum of the values of the in-neighbors of a vertex.
+     * 
+     * @param valueVector The values, by vertex identifier
+     * @param v the vertex identifier
+     * @return the sum
+     */
+    R pull(const std::vector<R>& valueVector, std::size_t v) const {
+        const VertexId* index = inSourceVector_.data() + inOffsetVector_[v];
+        const std::size_t count = inOffsetVector_[v + 1] - inOffsetVector_[v];
+#ifdef GRAPHTHEWY_X86_SIMD
+        if constexpr( std::is_same_v<R, double> || std::is_same_v<R, float> ) {
+            if( gather_ ) {
+                return gatherSumAvx2(valueVector.data(), index, count);
+            }
+        }
+#endif
+        return gatherSum(valueVector.data(), index, count);
+    }
+
+    /**
+     * Sum of the per-range partial results.
+     * 
+     * @param partialVector The partial results
+     * @return the sum
+     */
+    static R sum(const std::vector<R>& partialVector) {
+        R s = 0;
+        for(const R p : partialVector) {
+            s += p;
+        }
+        return s;
+    }
+
+    /**
+     * Split the vertices in ranges of about the same number of in-links
+     * plus vertices.
+     * 
+     * @param rangeCount The number of ranges
+     */
+    void balance(std::size_t rangeCount) {
+        const std::size_t n = snapshot_.order();
+        rangeCount = std::max<std::size_t>(1, std::min(rangeCount, n));
+        const std::size_t total = inSourceVector_.size() + n;
+        boundVector_.assign(rangeCount + 1, n);
+        boundVector_[0] = 0;
+        std::size_t v = 0;
+        for(std::size_t c=1; c<rangeCount; c++) {
+            const std::size_t target = total * c / rangeCount;
+            while( v<n && inOffsetVector_[v] + v<target ) {
+                v++;
+            }
+            boundVector_[c] = v;
+        }
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * Index of the first in-link of each vertex, plus the total.
+     */
+    std::vector<std::size_t>
+    inOffsetVector_;
+
+    /**
+     * Source of each in-link.
+     */
+    std::vector<VertexId>
+    inSourceVector_;
+
+    /**
+     * Inverse of the out-degree of each vertex, 0 without out-link.
+     */
+    std::vector<R>
+    inverseDegreeVector_;
+
+    /**
+     * First vertex of each range, plus the order.
+     */
+    std::vector<std::size_t>
+    boundVector_;
+
+    /**
+     * Score of each vertex, by vertex identifier.
+     */
+    std::vector<R>
+    scoreVector_;
+
+    /**
+     * Number of iterations run by the last computation.
+     */
+    std::size_t
+    iterationCount_;
+
+    /**
+     * Whether the in-neighbor values are summed with AVX2 gathers.
+     */
+    bool
+    gather_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_RANK_HPP_
@@ -0,0 +1,451 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_REACHABILITY_HPP_
+#define _GRAPH_MODEL_REACHABILITY_HPP_
+
+#include "GraphthewyModel.hpp"
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Reachability in a directed snapshot: ancestors, descendants,
+ * transitive closure and transitive reduction.
+ * 
+ * The strongly connected components are contracted first (Tarjan's
+ * algorithm), which leaves a DAG whose components are numbered in
+ * reverse topological order. The closure and the reduction compute the
+ * set of the components reached by each one, as bitsets of 64-bit words,
+ * in that order. To bound the memory, the target components are split in
+ * slices of a few words, processed independently by the threads.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct GraphReachability {
+
+    /**
+     * Constructor, contracting the strongly connected components.
+     * 
+     * @param snapshot The snapshot of the graph
+     */
+    GraphReachability(const GraphSnapshot<T, W>& snapshot)
+    : snapshot_(snapshot), in_(snapshot.transpose()) {
+        strongComponents();
+        condense();
+    }
+
+    /**
+     * Number of strongly connected components.
+     * 
+     * @return the number of components
+     */
+    std::size_t componentCount() const
+    { return memberOffsetVector_.size() - 1; }
+
+    /**
+     * Vertices from which a vertex can be reached, itself included only
+     * if it is on a cycle.
+     * 
+     * @param label the vertex's label
+     * @return the labels of the ancestors, in label order
+     */
+    std::vector<T> ancestors(const T& label) const
+    { return reached(in_, snapshot_.idOf(label)); }
+
+    /**
+     * Vertices reachable from a vertex, itself included only if it is on
+     * a cycle.
+     * 
+     * @param label the vertex's label
+     * @return the labels of the descendants, in label order
+     */
+    std::vector<T> descendants(const T& label) const
+    { return reached(snapshot_, snapshot_.idOf(label)); }
+
+    /**
+     * Transitive closure: an arc from each vertex to each vertex it
+     * reaches.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the closure, with all the vertices of the graph
+     */
+    DirectedGraph<T> transitiveClosure(unsigned int threadCount = 0) const {
+        GRAPHTHEWY_STATS_TIMER(timer, "transitiveClosure");
+        GRAPHTHEWY_STATS_VISIT(timer, componentCount(), successorVector_.size());
+        std::vector<std::vector<std::pair<VertexId, VertexId>>> arcVector(threadCount==0 ? defaultThreadCount() : threadCount);
+        forEachSlice(threadCount, [&](unsigned int t, std::size_t begin, const std::vector<std::uint64_t>& reach, std::size_t, VertexId c) {
+            forEachBit(reach, c, [&](std::size_t bit) {
+                arcVector[t].emplace_back(c, static_cast<VertexId>(begin + bit));
+            });
+        });
+        DirectedGraph<T> result = emptyCopy();
+        std::vector<std::pair<T, T>> edgePairList;
+        for(const auto& arcs : arcVector) {
+            for(const auto& a : arcs) {
+                for(std::size_t i=memberOffsetVector_[a.first]; i<memberOffsetVector_[a.first + 1]; i++) {
+                    for(std::size_t j=memberOffsetVector_[a.second]; j<memberOffsetVector_[a.second + 1]; j++) {
+                        edgePairList.emplace_back(snapshot_.label(memberVector_[i]), snapshot_.label(memberVector_[j]));
+                    }
+                }
+            }
+        }
+        for(VertexId c=0; c<componentCount(); c++) {
+            if( isCyclic(c) ) {
+                for(std::size_t i=memberOffsetVector_[c]; i<memberOffsetVector_[c + 1]; i++) {
+                    for(std::size_t j=memberOffsetVector_[c]; j<memberOffsetVector_[c + 1]; j++) {
+                        edgePairList.emplace_back(snapshot_.label(memberVector_[i]), snapshot_.label(memberVector_[j]));
+                    }
+                }
+            }
+        }
+        result.addEdgeList(edgePairList);
+        return result;
+    }
+
+    /**
+     * Transitive reduction: the fewest arcs with the same reachability.
+     * Between components, an arc is kept only if its target is not
+     * reached through another successor; the kept arc is one of the
+     * original arcs. Inside a component of several vertices, the arcs are
+     * replaced by a cycle through its vertices in label order.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the reduction, with all the vertices of the graph
+     */
+    DirectedGraph<T> transitiveReduction(unsigned int threadCount = 0) const {
+        GRAPHTHEWY_STATS_TIMER(timer, "transitiveReduction");
+        GRAPHTHEWY_STATS_VISIT(timer, componentCount(), successorVector_.size());
+        std::vector<std::vector<std::size_t>> keptVector(threadCount==0 ? defaultThreadCount() : threadCount);
+        forEachSlice(threadCount, [&](unsigned int t, std::size_t begin, const std::vector<std::uint64_t>& reach, std::size_t end, VertexId c) {
+            const std::size_t sliceWords = (end - begin + 63) / 64;
+            for(std::size_t a=successorOffsetVector_[c]; a<successorOffsetVector_[c + 1]; a++) {
+                const VertexId d = successorVector_[a];
+                if( d<begin || d>=end ) {
+                    continue;
+                }
+                // d is redundant if another successor already reaches it
+                bool redundant = false;
+                for(std::size_t b=successorOffsetVector_[c]; b<successorOffsetVector_[c + 1] && !redundant; b++) {
+                    const std::uint64_t* r = reach.data() + successorVector_[b] * sliceWords;
+                    redundant = (r[(d - begin) / 64] >> ((d - begin) % 64)) & 1;
+                }
+                if( !redundant ) {
+                    keptVector[t].push_back(a);
+                }
+            }
+        });
+        DirectedGraph<T> result = emptyCopy();
+        std::vector<std::pair<T, T>> edgePairList;
+        for(const auto& kept : keptVector) {
+            for(const std::size_t a : kept) {
+                edgePairList.emplace_back(snapshot_.label(representativeVector_[a].first), snapshot_.label(representativeVector_[a].second));
+            }
+        }
+        for(VertexId c=0; c<componentCount(); c++) {
+            const std::size_t first = memberOffsetVector_[c], last = memberOffsetVector_[c + 1];
+            if( last - first>1 ) {
+                for(std::size_t i=first; i<last; i++) {
+                    edgePairList.emplace_back(snapshot_.label(memberVector_[i]), snapshot_.label(memberVector_[i + 1<last ? i + 1 : first]));
+                }
+            } else if( isCyclic(c) ) {
+                edgePairList.emplace_back(snapshot_.label(memberVector_[first]), snapshot_.label(memberVector_[first]));
+            }
+        }
+        result.addEdgeList(edgePairList);
+        return result;
+    }
+
+
+protected:
+
+    /**
+     * Iterative Tarjan's algorithm: componentVector_ gets the component
+     * of each vertex, numbered in reverse topological order.
+     */
+    void strongComponents() {
+        const std::size_t n = snapshot_.order();
+        const VertexId none = std::numeric_limits<VertexId>::max();
+        std::vector<VertexId> indexVector(n, none), lowVector(n, 0), stack;
+        std::vector<char> onStack(n, 0);
+        std::vector<std::pair<VertexId, std::size_t>> callStack;
+        componentVector_.assign(n, none);
+        VertexId index = 0, componentCount = 0;
+        for(VertexId root=0; root<n; root++) {
+            if( indexVector[root]!=none ) {
+                continue;
+            }
+            callStack.emplace_back(root, snapshot_.offsetVector_[root]);
+            indexVector[root] = lowVector[root] = index++;
+            stack.push_back(root);
+            onStack[root] = 1;
+            while( !callStack.empty() ) {
+                const VertexId u = callStack.back().first;
+                std::size_t& a = callStack.back().second;
+                if( a<snapshot_.offsetVector_[u + 1] ) {
+                    const VertexId v = snapshot_.targetVector_[a++];
+                    if( indexVector[v]==none ) {
+                        indexVector[v] = lowVector[v] = index++;
+                        stack.push_back(v);
+                        onStack[v] = 1;
+                        callStack.emplace_back(v, snapshot_.offsetVector_[v]);
+                    } else if( onStack[v] ) {
+                        lowVector[u] = std::min(lowVector[u], indexVector[v]);
+                    }
+                    continue;
+                }
+                callStack.pop_back();
+                if( !callStack.empty() ) {
+                    const VertexId parent = callStack.back().first;
+                    lowVector[parent] = std::min(lowVector[parent], lowVector[u]);
+                }
+                if( lowVector[u]==indexVector[u] ) {
+                    VertexId v;
+                    do {
+                        v = stack.back();
+                        stack.pop_back();
+                        onStack[v] = 0;
+                        componentVector_[v] = componentCount;
+                    } while( v!=u );
+                    componentCount++;
+                }
+            }
+        }
+        memberOffsetVector_.assign(componentCount + 1, 0);
+    }
+
+    /**
+     * Build the members of each component and the arcs of the
+     * condensation, without duplicates, each with an original arc.
+     */
+    void condense() {
+        const std::size_t n = snapshot_.order();
+        const std::size_t componentCount = memberOffsetVector_.size() - 1;
+        for(VertexId v=0; v<n; v++) {
+            memberOffsetVector_[componentVector_[v] + 1]++;
+        }
+        for(std::size_t c=0; c<componentCount; c++) {
+            memberOffsetVector_[c + 1] += memberOffsetVector_[c];
+        }
+        memberVector_.resize(n);
+        std::vector<std::size_t> fill(memberOffsetVector_.begin(), memberOffsetVector_.end() - 1);
+        for(VertexId v=0; v<n; v++) {
+            memberVector_[fill[componentVector_[v]]++] = v;
+        }
+        const VertexId none = std::numeric_limits<VertexId>::max();
+        std::vector<VertexId> lastSource(componentCount, none);
+        selfLoopVector_.assign(componentCount, 0);
+        successorOffsetVector_.assign(componentCount + 1, 0);
+        for(VertexId c=0; c<componentCount; c++) {
+            for(std::size_t i=memberOffsetVector_[c]; i<memberOffsetVector_[c + 1]; i++) {
+                const VertexId u = memberVector_[i];
+                for(const VertexId v : snapshot_.neighbors(u)) {
+                    const VertexId d = componentVector_[v];
+                    if( d==c ) {
+                        selfLoopVector_[c] = 1;
+                    } else if( lastSource[d]!=c ) {
+                        lastSource[d] = c;
+                        successorVector_.push_back(d);
+                        representativeVector_.emplace_back(u, v);
+                    }
+                }
+            }
+            successorOffsetVector_[c + 1] = successorVector_.size();
+        }
+    }
+
+    /**
+     * Whether a component reaches itself: several vertices, or a self-loop.
+     * 
+     * @param c the component
+     * @return true or false
+     */
+    bool isCyclic(VertexId c) const
+    { return selfLoopVector_[c]!=0; }
+
+    /**
+     * For each slice of target components, compute the components of the
+     * slice reached by each component, then call
+     * f(threadIndex, sliceBegin, reach, sliceEnd, c) on each component c.
+     * reach holds the bitsets of all the components of the slice, the
+     * successors of c having lower numbers and being complete.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @param f The function to call on each component
+     */
+    template<class F>
+    void forEachSlice(unsigned int threadCount, F&& f) const {
+        const std::size_t componentCount = this->componentCount();
+        const std::size_t sliceBits = 64 * sliceWordCount;
+        const std::size_t sliceCount = (componentCount + sliceBits - 1) / sliceBits;
+        parallelDynamic(sliceCount, threadCount, [&](unsigned int t, std::size_t s) {
+            const std::size_t begin = s * sliceBits;
+            const std::size_t end = std::min(componentCount, begin + sliceBits);
+            const std::size_t words = (end - begin + 63) / 64;
+            // Components before the slice cannot reach it, being topologically after
+            std::vector<std::uint64_t> reach(componentCount * words, 0);
+            for(VertexId c=static_cast<VertexId>(begin); c<componentCount; c++) {
+                std::uint64_t* r = reach.data() + c * words;
+                for(std::size_t a=successorOffsetVector_[c]; a<successorOffsetVector_[c + 1]; a++) {
+                    const VertexId d = successorVector_[a];
+                    if( d<begin ) {
+                        continue;
+                    }
+                    const std::uint64_t* rd = reach.data() + d * words;
+                    for(std::size_t w=0; w<words; w++) {
+                        r[w] |= rd[w];
+                    }
+                    if( d<end ) {
+                        r[(d - begin) / 64] |= std::uint64_t(1) << ((d - begin) % 64);
+                    }
+                }
+                f(t, begin, reach, end, c);
+            }
+        }, 1);
+    }
+
+    /**
+     * Call f(bit) for each bit set in the bitset of a component.
+     * 
+     * @param reach The bitsets of the slice
+     * @param c the component
+     * @param f The function to call
+     */
+    template<class F>
+    void forEachBit(const std::vector<std::uint64_t>& reach, VertexId c, F&& f) const {
+        const std::size_t words = reach.size() / componentCount();
+        for(std::size_t w=0; w<words; w++) {
+            std::uint64_t bits = reach[c * words + w];
+            while( bits!=0 ) {
+                f(w * 64 + static_cast<std::size_t>(__builtin_ctzll(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    /**
+     * Breadth-first search from a vertex, the vertex itself being marked
+     * only if reached again.
+     * 
+     * @param adjacency The arcs to follow
+     * @param source the vertex identifier
+     * @return the labels of the reached vertices, in label order
+     */
+    std::vector<T> reached(const GraphSnapshot<T, W>& adjacency, VertexId source) const {
+        std::vector<char> visited(adjacency.order(), 0);
+        std::vector<VertexId> queue(1, source);
+        for(std::size_t head=0; head<queue.size(); head++) {
+            for(const VertexId v : adjacency.neighbors(queue[head])) {
+                if( !visited[v] ) {
+                    visited[v] = 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+        std::vector<T> labelVector;
+        for(VertexId v=0; v<adjacency.order(); v++) {
+            if( visited[v] ) {
+                labelVector.push_back(adjacency.label(v));
+            }
+        }
+        return labelVector;
+    }
+
+    /**
+     * @return a graph with the vertices of the snapshot and no link
+     */
+    DirectedGraph<T> emptyCopy() const {
+        DirectedGraph<T> result;
+        for(VertexId v=0; v<snapshot_.order(); v++) {
+            result << snapshot_.label(v);
+        }
+        return result;
+    }
+
+
+protected:
+
+    /**
+     * Number of 64-bit words of the bitsets of a slice.
+     */
+    static constexpr std::size_t sliceWordCount = 4;
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * The reversed graph.
+     */
+    GraphSnapshot<T, W>
+    in_;
+
+    /**
+     * Component of each vertex, by vertex identifier.
+     */
+    std::vector<VertexId>
+    componentVector_;
+
+    /**
+     * Index of the first member of each component, plus the order.
+     */
+    std::vector<std::size_t>
+    memberOffsetVector_;
+
+    /**
+     * Vertices grouped by component, in label order inside a component.
+     */
+    std::vector<VertexId>
+    memberVector_;
+
+    /**
+     * Whether each component has an arc to itself.
+     */
+    std::vector<char>
+    selfLoopVector_;
+
+    /**
+     * Index of the first successor of each component, plus the total.
+     */
+    std::vector<std::size_t>
+    successorOffsetVector_;
+
+    /**
+     * Successor components, without duplicates.
+     */
+    std::vector<VertexId>
+    successorVector_;
+
+    /**
+     * An original arc for each arc of the condensation.
+     */
+    std::vector<std::pair<VertexId, VertexId>>
+    representativeVector_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_REACHABILITY_HPP_
@@ -0,0 +1,252 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_REORDER_HPP_
+#define _GRAPH_MODEL_REORDER_HPP_
+
+#include "GraphthewySnapshot.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Vertex orderings improving the memory locality of the traversals.
+ * 
+ * Each method returns a permutation, the new identifier of each vertex
+ * by current identifier, to give to GraphSnapshot::permute().
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct GraphReorder {
+
+    /**
+     * Constructor
+     * 
+     * @param snapshot The snapshot of the graph
+     */
+    GraphReorder(const GraphSnapshot<T, W>& snapshot)
+    : snapshot_(snapshot) { }
+
+    /**
+     * Vertices by decreasing degree, so that the hubs share the first
+     * cache lines.
+     * 
+     * @return the permutation
+     */
+    std::vector<VertexId> degreeSort() const {
+        std::vector<VertexId> orderVector(snapshot_.order());
+        std::iota(orderVector.begin(), orderVector.end(), VertexId(0));
+        std::stable_sort(orderVector.begin(), orderVector.end(), [&](VertexId a, VertexId b) {
+            return snapshot_.degree(a) > snapshot_.degree(b);
+        });
+        return toPermutation(orderVector);
+    }
+
+    /**
+     * Reverse Cuthill-McKee: breadth-first numbering of each component
+     * from a vertex of minimal degree, visiting the neighbors by
+     * increasing degree, then reversed. It reduces the bandwidth of the
+     * adjacency matrix, so that neighbors have close identifiers.
+     * 
+     * @return the permutation
+     */
+    std::vector<VertexId> reverseCuthillMcKee() const {
+        const std::size_t n = snapshot_.order();
+        std::vector<VertexId> byDegree(n);
+        std::iota(byDegree.begin(), byDegree.end(), VertexId(0));
+        std::stable_sort(byDegree.begin(), byDegree.end(), [&](VertexId a, VertexId b) {
+            return snapshot_.degree(a) < snapshot_.degree(b);
+        });
+        std::vector<char> visited(n, 0);
+        std::vector<VertexId> orderVector, neighborVector;
+        orderVector.reserve(n);
+        for(const VertexId root : byDegree) {
+            if( visited[root] ) {
+                continue;
+            }
+            visited[root] = 1;
+            std::size_t head = orderVector.size();
+            orderVector.push_back(root);
+            while( head<orderVector.size() ) {
+                const VertexId u = orderVector[head++];
+                neighborVector.clear();
+                for(const VertexId v : snapshot_.neighbors(u)) {
+                    if( !visited[v] ) {
+                        visited[v] = 1;
+                        neighborVector.push_back(v);
+                    }
+                }
+                std::stable_sort(neighborVector.begin(), neighborVector.end(), [&](VertexId a, VertexId b) {
+                    return snapshot_.degree(a) < snapshot_.degree(b);
+                });
+                orderVector.insert(orderVector.end(), neighborVector.begin(), neighborVector.end());
+            }
+        }
+        std::reverse(orderVector.begin(), orderVector.end());
+        return toPermutation(orderVector);
+    }
+
+    /**
+     * Gorder: greedy numbering where the next vertex is the one sharing
+     * the most links and common in-neighbors with the last window
+     * placed vertices. In-neighbors with a degree above the square
+     * root of the order are ignored, as they would share with everyone.
+     * When no vertex scores, the numbering goes on from the oldest placed
+     * vertex having an unplaced neighbor.
+     * 
+     * @param window The number of previously placed vertices considered
+     * @return the permutation
+     */
+    std::vector<VertexId> gorder(std::size_t window = 5) const {
+        const std::size_t n = snapshot_.order();
+        const GraphSnapshot<T, W> inSnapshot = snapshot_.isDirected() ? snapshot_.transpose() : GraphSnapshot<T, W>();
+        const GraphSnapshot<T, W>& in = snapshot_.isDirected() ? inSnapshot : snapshot_;
+        const std::size_t hubDegree = static_cast<std::size_t>(std::sqrt(static_cast<double>(n))) + 1;
+        std::vector<long> scoreVector(n, 0);
+        std::vector<char> placed(n, 0);
+        std::priority_queue<std::pair<long, VertexId>> heap;
+        std::vector<VertexId> orderVector;
+        orderVector.reserve(n);
+
+        const auto update = [&](VertexId u, long delta) {
+            const auto touch = [&](VertexId v) {
+                if( !placed[v] ) {
+                    scoreVector[v] += delta;
+                    heap.emplace(scoreVector[v], v);
+                }
+            };
+            for(const VertexId v : snapshot_.neighbors(u)) {
+                touch(v);
+            }
+            for(const VertexId w : in.neighbors(u)) {
+                if( snapshot_.isDirected() ) {
+                    touch(w);
+                }
+                if( snapshot_.degree(w)<=hubDegree ) {
+                    for(const VertexId v : snapshot_.neighbors(w)) {
+                        if( v!=u ) {
+                            touch(v);
+                        }
+                    }
+                }
+            }
+        };
+
+        std::vector<VertexId> byDegree(n);
+        std::iota(byDegree.begin(), byDegree.end(), VertexId(0));
+        std::stable_sort(byDegree.begin(), byDegree.end(), [&](VertexId a, VertexId b) {
+            return snapshot_.degree(a) > snapshot_.degree(b);
+        });
+        std::size_t nextSeed = 0, nextScan = 0;
+        while( orderVector.size()<n ) {
+            VertexId u = 0;
+            bool found = false;
+            while( !heap.empty() ) {
+                const auto top = heap.top();
+                heap.pop();
+                // Skip the stale entries, pushed before a later score update
+                if( !placed[top.second] && top.first==scoreVector[top.second] && top.first>0 ) {
+                    u = top.second;
+                    found = true;
+                    break;
+                }
+            }
+            // Boxed in: continue from the oldest placed vertex with a free neighbor
+            while( !found && nextScan<orderVector.size() ) {
+                for(const VertexId v : snapshot_.neighbors(orderVector[nextScan])) {
+                    if( !placed[v] ) {
+                        u = v;
+                        found = true;
+                        break;
+                    }
+                }
+                if( !found ) {
+                    nextScan++;
+                }
+            }
+            if( !found ) {
+                while( placed[byDegree[nextSeed]] ) {
+                    nextSeed++;
+                }
+                u = byDegree[nextSeed];
+            }
+            placed[u] = 1;
+            orderVector.push_back(u);
+            update(u, 1);
+            if( orderVector.size()>window ) {
+                update(orderVector[orderVector.size() - window - 1], -1);
+            }
+        }
+        return toPermutation(orderVector);
+    }
+
+    /**
+     * Average distance between the identifiers of linked vertices, a
+     * simple measure of the locality of a numbering.
+     * 
+     * @param snapshot The snapshot to measure
+     * @return the average gap
+     */
+    static double averageGap(const GraphSnapshot<T, W>& snapshot) {
+        if( snapshot.arcCount()==0 ) {
+            return 0;
+        }
+        double sum = 0;
+        for(VertexId u=0; u<snapshot.order(); u++) {
+            for(const VertexId v : snapshot.neighbors(u)) {
+                sum += u<v ? v - u : u - v;
+            }
+        }
+        return sum / static_cast<double>(snapshot.arcCount());
+    }
+
+
+protected:
+
+    /**
+     * Turn a visit order into a permutation.
+     * 
+     * @param orderVector The vertices in their new order
+     * @return the new identifier of each vertex
+     */
+    static std::vector<VertexId> toPermutation(const std::vector<VertexId>& orderVector) {
+        std::vector<VertexId> permutation(orderVector.size());
+        for(std::size_t i=0; i<orderVector.size(); i++) {
+            permutation[orderVector[i]] = static_cast<VertexId>(i);
+        }
+        return permutation;
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_REORDER_HPP_
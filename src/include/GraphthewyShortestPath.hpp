@@ -0,0 +1,615 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_SHORTEST_PATH_HPP_
+#define _GRAPH_MODEL_SHORTEST_PATH_HPP_
+
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Indexed d-ary min-heap of vertex identifiers, keyed by an external
+ * vector, with decrease-key. Each vertex is at most once in the heap,
+ * and a 4-ary layout keeps the children of a node in the same cache line.
+ * 
+ * Template arguments:
+ * - K = the type of the keys
+ * - D = the arity of the heap
+ */
+template<class K, unsigned int D = 4>
+class DaryHeap {
+
+public:
+
+    /**
+     * Constructor
+     * 
+     * @param keyVector The keys, by vertex identifier
+     */
+    DaryHeap(const std::vector<K>& keyVector)
+    : keyVector_(keyVector), positionVector_(keyVector.size(), npos) { }
+
+    /**
+     * @return true if the heap is empty
+     */
+    bool empty() const { return heap_.empty(); }
+
+    /**
+     * Insert a vertex, or move it up if its key has decreased.
+     * 
+     * @param v the vertex identifier
+     */
+    void push(VertexId v) {
+        if( positionVector_[v]==npos ) {
+            positionVector_[v] = heap_.size();
+            heap_.push_back(v);
+        }
+        siftUp(positionVector_[v]);
+    }
+
+    /**
+     * Remove the vertex with the smallest key.
+     * 
+     * @return the vertex identifier
+     */
+    VertexId pop() {
+        const VertexId top = heap_.front();
+        positionVector_[top] = npos;
+        const VertexId last = heap_.back();
+        heap_.pop_back();
+        if( !heap_.empty() ) {
+            heap_[0] = last;
+            positionVector_[last] = 0;
+            siftDown(0);
+        }
+        return top;
+    }
+
+
+protected:
+
+    /**
+     * Move a vertex up to its place.
+     * 
+     * @param i the position of the vertex in the heap
+     */
+    void siftUp(std::size_t i) {
+        const VertexId v = heap_[i];
+        while( i>0 ) {
+            const std::size_t parent = (i - 1) / D;
+            if( !(keyVector_[v] < keyVector_[heap_[parent]]) ) {
+                break;
+            }
+            heap_[i] = heap_[parent];
+            positionVector_[heap_[i]] = i;
+            i = parent;
+        }
+        heap_[i] = v;
+        positionVector_[v] = i;
+    }
+
+    /**
+     * Move a vertex down to its place.
+     * 
+     * @param i the position of the vertex in the heap
+     */
+    void siftDown(std::size_t i) {
+        const VertexId v = heap_[i];
+        while( true ) {
+            const std::size_t first = i * D + 1;
+            if( first>=heap_.size() ) {
+                break;
+            }
+            std::size_t best = first;
+            const std::size_t last = std::min(first + D, heap_.size());
+            for(std::size_t c=first + 1; c<last; c++) {
+                if( keyVector_[heap_[c]] < keyVector_[heap_[best]] ) {
+                    best = c;
+                }
+            }
+            if( !(keyVector_[heap_[best]] < keyVector_[v]) ) {
+                break;
+            }
+            heap_[i] = heap_[best];
+            positionVector_[heap_[i]] = i;
+            i = best;
+        }
+        heap_[i] = v;
+        positionVector_[v] = i;
+    }
+
+
+protected:
+
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * The keys, by vertex identifier.
+     */
+    const std::vector<K>&
+    keyVector_;
+
+    /**
+     * Position of each vertex in the heap, npos if absent.
+     */
+    std::vector<std::size_t>
+    positionVector_;
+
+    /**
+     * The heap itself.
+     */
+    std::vector<VertexId>
+    heap_;
+
+};
+
+
+/**
+ * Single-source shortest paths on a snapshot, with non-negative weights.
+ * An unweighted graph has all its weights equal to 1.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct ShortestPath {
+
+    /**
+     * Type of the distances.
+     */
+    using WeightType = typename GraphSnapshot<T, W>::WeightType;
+
+    /**
+     * Constructor
+     * 
+     * @param snapshot The snapshot of the graph
+     */
+    ShortestPath(const GraphSnapshot<T, W>& snapshot)
+    : snapshot_(snapshot) { }
+
+    /**
+     * Distance of the unreachable vertices.
+     * 
+     * @return infinity, or the maximal value of an integral type
+     */
+    static constexpr WeightType infinity() {
+        return std::numeric_limits<WeightType>::has_infinity
+            ? std::numeric_limits<WeightType>::infinity()
+            : std::numeric_limits<WeightType>::max();
+    }
+
+    /**
+     * Dijkstra's algorithm, with a 4-ary heap.
+     * 
+     * @param source The label of the source vertex
+     */
+    void dijkstra(const T& source) {
+        GRAPHTHEWY_STATS_TIMER(timer, "dijkstra");
+        const VertexId s = reset(source);
+        DaryHeap<WeightType> heap(distanceVector_);
+        heap.push(s);
+        while( !heap.empty() ) {
+            const VertexId u = heap.pop();
+            const WeightType du = distanceVector_[u];
+            GRAPHTHEWY_STATS_VISIT(timer, 1, snapshot_.degree(u));
+            for(std::size_t a=snapshot_.offsetVector_[u]; a<snapshot_.offsetVector_[u + 1]; a++) {
+                const VertexId v = snapshot_.targetVector_[a];
+                const WeightType dv = du + snapshot_.weight(a);
+                if( dv < distanceVector_[v] ) {
+                    distanceVector_[v] = dv;
+                    predecessorVector_[v] = u;
+                    heap.push(v);
+                }
+            }
+        }
+    }
+
+    /**
+     * Delta-stepping algorithm. Vertices are settled by buckets of width
+     * delta; the relaxations of the vertices of a bucket are computed by
+     * several threads, then applied.
+     * 
+     * @param source The label of the source vertex
+     * @param delta The width of the buckets, 0 for the average weight
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    void deltaStepping(const T& source, WeightType delta = 0, unsigned int threadCount = 0) {
+        GRAPHTHEWY_STATS_TIMER(timer, "deltaStepping");
+        const VertexId s = reset(source);
+        if( threadCount==0 ) {
+            threadCount = defaultThreadCount();
+        }
+        if( !(delta > 0) ) {
+            delta = averageWeight();
+        }
+        std::vector<std::vector<VertexId>> bucketVector(1, std::vector<VertexId>(1, s));
+        std::vector<std::vector<Request>> requestVector(threadCount);
+        std::vector<std::size_t> frontierPhase(snapshot_.order(), 0);
+        std::vector<char> isSettled(snapshot_.order(), 0);
+        std::vector<VertexId> frontier, settled;
+        std::size_t phase = 0;
+        const auto bucketOf = [&](WeightType d) { return static_cast<std::size_t>(d / delta); };
+        const auto apply = [&]() {
+            for(auto& requests : requestVector) {
+                for(const Request& r : requests) {
+                    if( r.distance_ < distanceVector_[r.target_] ) {
+                        distanceVector_[r.target_] = r.distance_;
+                        predecessorVector_[r.target_] = r.source_;
+                        const std::size_t b = bucketOf(r.distance_);
+                        if( b>=bucketVector.size() ) {
+                            bucketVector.resize(b + 1);
+                        }
+                        bucketVector[b].push_back(r.target_);
+                    }
+                }
+                requests.clear();
+            }
+        };
+        const auto relax = [&](const std::vector<VertexId>& vertices, bool light) {
+            parallelChunks(vertices.size(), threadCount, [&](unsigned int c, std::size_t begin, std::size_t end) {
+                auto& requests = requestVector[c];
+                for(std::size_t i=begin; i<end; i++) {
+                    const VertexId u = vertices[i];
+                    for(std::size_t a=snapshot_.offsetVector_[u]; a<snapshot_.offsetVector_[u + 1]; a++) {
+                        const WeightType w = snapshot_.weight(a);
+                        if( (w <= delta)==light ) {
+                            const WeightType d = distanceVector_[u] + w;
+                            if( d < distanceVector_[snapshot_.targetVector_[a]] ) {
+                                requests.push_back(Request{snapshot_.targetVector_[a], u, d});
+                            }
+                        }
+                    }
+                }
+            });
+        };
+        for(std::size_t i=0; i<bucketVector.size(); i++) {
+            settled.clear();
+            while( !bucketVector[i].empty() ) {
+                frontier.clear();
+                phase++;
+                for(const VertexId v : bucketVector[i]) {
+                    // Skip the stale entries, whose distance moved to a lower bucket since
+                    if( bucketOf(distanceVector_[v])==i && frontierPhase[v]!=phase ) {
+                        frontierPhase[v] = phase;
+                        frontier.push_back(v);
+                        if( !isSettled[v] ) {
+                            isSettled[v] = 1;
+                            settled.push_back(v);
+                        }
+                    }
+                }
+                bucketVector[i].clear();
+                relax(frontier, true);
+                apply();
+            }
+            for(const VertexId v : settled) {
+                isSettled[v] = 0;
+                GRAPHTHEWY_STATS_VISIT(timer, 1, snapshot_.degree(v));
+            }
+            relax(settled, false);
+            apply();
+        }
+    }
+
+    /**
+     * Distance from the source, after dijkstra() or deltaStepping().
+     * 
+     * @param target The label of the target vertex
+     * @return the distance, infinity() if unreachable
+     */
+    WeightType distance(const T& target) const
+    { return distanceVector_[snapshot_.idOf(target)]; }
+
+    /**
+     * To check whether a vertex is reachable from the source.
+     * 
+     * @param target The label of the target vertex
+     * @return true or false
+     */
+    bool isReachable(const T& target) const
+    { return distance(target)!=infinity(); }
+
+    /**
+     * Shortest path from the source, after dijkstra() or deltaStepping().
+     * 
+     * @param target The label of the target vertex
+     * @return the labels of the path from the source to the target, empty if unreachable
+     */
+    std::vector<T> path(const T& target) const {
+        std::vector<T> labelPath;
+        VertexId v = snapshot_.idOf(target);
+        if( distanceVector_[v]==infinity() ) {
+            return labelPath;
+        }
+        labelPath.push_back(snapshot_.label(v));
+        while( predecessorVector_[v]!=noVertex ) {
+            v = predecessorVector_[v];
+            labelPath.push_back(snapshot_.label(v));
+        }
+        std::reverse(labelPath.begin(), labelPath.end());
+        return labelPath;
+    }
+
+    /**
+     * Distances from the source, by vertex identifier.
+     * 
+     * @return the vector of distances
+     */
+    const std::vector<WeightType>& distanceVector() const
+    { return distanceVector_; }
+
+
+protected:
+
+    /**
+     * Relaxation of an arc, computed by a thread of deltaStepping().
+     */
+    struct Request {
+        VertexId target_;
+        VertexId source_;
+        WeightType distance_;
+    };
+
+    /**
+     * Reset the distances and predecessors for a new source.
+     * 
+     * @param source The label of the source vertex
+     * @return the source identifier
+     */
+    VertexId reset(const T& source) {
+        const VertexId s = snapshot_.idOf(source);
+        distanceVector_.assign(snapshot_.order(), infinity());
+        predecessorVector_.assign(snapshot_.order(), noVertex);
+        distanceVector_[s] = WeightType(0);
+        return s;
+    }
+
+    /**
+     * Average weight of the arcs, used as default bucket width.
+     * 
+     * @return the average weight, at least 1 for an integral weight
+     */
+    WeightType averageWeight() const {
+        if( snapshot_.arcCount()==0 ) {
+            return WeightType(1);
+        }
+        double sum = 0;
+        for(std::size_t a=0; a<snapshot_.arcCount(); a++) {
+            sum += static_cast<double>(snapshot_.weight(a));
+        }
+        const WeightType average = static_cast<WeightType>(sum / static_cast<double>(snapshot_.arcCount()));
+        return average > WeightType(0) ? average : WeightType(1);
+    }
+
+
+protected:
+
+    static constexpr VertexId noVertex = std::numeric_limits<VertexId>::max();
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * Distance from the source, by vertex identifier.
+     */
+    std::vector<WeightType>
+    distanceVector_;
+
+    /**
+     * Predecessor on the shortest path, by vertex identifier.
+     */
+    std::vector<VertexId>
+    predecessorVector_;
+
+};
+
+
+/**
+ * Point-to-point hop paths (ignoring the weights) by bidirectional
+ * breadth-first search: a search from each end, expanding level by
+ * level the smaller frontier, until they meet. On small-world graphs,
+ * it visits a tiny part of what a search from the source alone would.
+ * The backward search of a directed snapshot follows its transpose,
+ * built once by the constructor.
+ * 
+ * The visited sets are bitmaps over the identifiers, allocated once and
+ * reset after each query by walking the vertices it visited, so that a
+ * query costs what it visits.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct HopPath {
+
+    /**
+     * Constructor
+     * 
+     * @param snapshot The snapshot of the graph
+     */
+    HopPath(const GraphSnapshot<T, W>& snapshot)
+    : snapshot_(snapshot), visitedCount_(0) {
+        if( snapshot_.isDirected() ) {
+            in_ = snapshot_.transpose();
+        }
+        for(int side=0; side<2; side++) {
+            visitedVector_[side].assign((snapshot_.order() + 63) / 64, 0);
+            parentVector_[side].assign(snapshot_.order(), noVertex);
+        }
+    }
+
+    /**
+     * Shortest path in number of links from a vertex to another.
+     * 
+     * @param source The label of the source vertex
+     * @param target The label of the target vertex
+     * @return the labels of the path from the source to the target, empty if unreachable
+     */
+    std::vector<T> path(const T& source, const T& target) {
+        GRAPHTHEWY_STATS_TIMER(timer, "hopPath");
+        const VertexId s = snapshot_.idOf(source);
+        const VertexId t = snapshot_.idOf(target);
+        std::vector<T> labelPath;
+        std::vector<VertexId> frontier[2] = {{s}, {t}};
+        std::vector<VertexId> next;
+        visit(0, s, noVertex);
+        visit(1, t, noVertex);
+        VertexId meeting = s==t ? s : noVertex;
+        while( meeting==noVertex && !frontier[0].empty() && !frontier[1].empty() ) {
+            const int side = frontier[0].size()<=frontier[1].size() ? 0 : 1;
+            const GraphSnapshot<T, W>& adjacency = side==0 || !snapshot_.isDirected() ? snapshot_ : in_;
+            next.clear();
+            for(std::size_t i=0; i<frontier[side].size() && meeting==noVertex; i++) {
+                const VertexId u = frontier[side][i];
+                GRAPHTHEWY_STATS_VISIT(timer, 1, adjacency.degree(u));
+                for(const VertexId v : adjacency.neighbors(u)) {
+                    if( isVisited(side, v) ) {
+                        continue;
+                    }
+                    visit(side, v, u);
+                    // Every level is expanded whole, so the first meeting is a shortest path
+                    if( isVisited(1 - side, v) ) {
+                        meeting = v;
+                        break;
+                    }
+                    next.push_back(v);
+                }
+            }
+            frontier[side].swap(next);
+        }
+        if( meeting!=noVertex ) {
+            for(VertexId v=meeting; v!=noVertex; v=parentVector_[0][v]) {
+                labelPath.push_back(snapshot_.label(v));
+            }
+            std::reverse(labelPath.begin(), labelPath.end());
+            for(VertexId v=parentVector_[1][meeting]; v!=noVertex; v=parentVector_[1][v]) {
+                labelPath.push_back(snapshot_.label(v));
+            }
+        }
+        visitedCount_ = touchedVector_.size();
+        for(const auto& e : touchedVector_) {
+            visitedVector_[e.first][e.second / 64] = 0;
+            parentVector_[e.first][e.second] = noVertex;
+        }
+        touchedVector_.clear();
+        return labelPath;
+    }
+
+    /**
+     * Number of links of the shortest path.
+     * 
+     * @param source The label of the source vertex
+     * @param target The label of the target vertex
+     * @return the number of links, -1 if unreachable
+     */
+    long distance(const T& source, const T& target) {
+        return static_cast<long>(path(source, target).size()) - 1;
+    }
+
+    /**
+     * Number of vertices visited by the last query, counted once per
+     * search that visited them.
+     * 
+     * @return the number of vertices
+     */
+    std::size_t visitedCount() const
+    { return visitedCount_; }
+
+
+protected:
+
+    /**
+     * Marks a vertex without parent.
+     */
+    static constexpr VertexId noVertex = std::numeric_limits<VertexId>::max();
+
+    /**
+     * Whether a search has visited a vertex.
+     * 
+     * @param side 0 for the forward search, 1 for the backward one
+     * @param v the vertex identifier
+     * @return true if the search has visited the vertex
+     */
+    bool isVisited(int side, VertexId v) const
+    { return (visitedVector_[side][v / 64] >> (v % 64)) & 1; }
+
+    /**
+     * Mark a vertex as visited by a search.
+     * 
+     * @param side 0 for the forward search, 1 for the backward one
+     * @param v the vertex identifier
+     * @param parent The vertex it has been reached from
+     */
+    void visit(int side, VertexId v, VertexId parent) {
+        visitedVector_[side][v / 64] |= std::uint64_t(1) << (v % 64);
+        parentVector_[side][v] = parent;
+        touchedVector_.emplace_back(side, v);
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * The transposed snapshot, for the backward search of a directed graph.
+     */
+    GraphSnapshot<T, W>
+    in_;
+
+    /**
+     * The visited bitmap of each search.
+     */
+    std::vector<std::uint64_t>
+    visitedVector_[2];
+
+    /**
+     * The vertex each vertex has been reached from, in each search.
+     */
+    std::vector<VertexId>
+    parentVector_[2];
+
+    /**
+     * Vertices visited by the current query, with their search.
+     */
+    std::vector<std::pair<int, VertexId>>
+    touchedVector_;
+
+    /**
+     * Number of vertices visited by the last query.
+     */
+    std::size_t
+    visitedCount_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_SHORTEST_PATH_HPP_
@@ -0,0 +1,510 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_SNAPSHOT_HPP_
+#define _GRAPH_MODEL_SNAPSHOT_HPP_
+
+#include "GraphthewyModel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Dense identifier of a vertex in a snapshot, from 0 to order() - 1.
+ */
+using VertexId = std::uint32_t;
+
+/**
+ * Range of neighbor identifiers.
+ */
+struct NeighborRange {
+
+    /**
+     * @return the first neighbor
+     */
+    const VertexId* begin() const { return begin_; }
+
+    /**
+     * @return past the last neighbor
+     */
+    const VertexId* end() const { return end_; }
+
+    /**
+     * @return the number of neighbors
+     */
+    std::size_t size() const { return static_cast<std::size_t>(end_ - begin_); }
+
+    /**
+     * @return true if there is no neighbor
+     */
+    bool empty() const { return begin_==end_; }
+
+    /**
+     * The first neighbor.
+     */
+    const VertexId*
+    begin_;
+
+    /**
+     * Past the last neighbor.
+     */
+    const VertexId*
+    end_;
+
+};
+
+
+/**
+ * Labels of the vertices of a snapshot, by dense identifier.
+ * 
+ * Template argument:
+ * - T = the type of the vertex's label
+ */
+template<equality_comparable T>
+struct VertexLabels {
+
+    /**
+     * Label of a vertex.
+     * 
+     * @param v the vertex identifier
+     * @return the label
+     */
+    const T& label(VertexId v) const
+    { return labelVector_[v]; }
+
+    /**
+     * To check whether the label represents a vertex of the snapshot.
+     * 
+     * @param label the vertex's label
+     * @return true or false
+     */
+    bool contains(const T& label) const
+    { return find(label)!=labelVector_.size(); }
+
+    /**
+     * Identifier of a vertex.
+     * 
+     * @param label the vertex's label
+     * @return the identifier, std::out_of_range is thrown if there is no such vertex
+     */
+    VertexId idOf(const T& label) const {
+        const std::size_t id = find(label);
+        if( id==labelVector_.size() ) {
+            throw std::out_of_range("graphthewy: no such vertex");
+        }
+        return static_cast<VertexId>(id);
+    }
+
+
+protected:
+
+    /**
+     * Binary search of a label.
+     * 
+     * @param label the vertex's label
+     * @return the identifier, or the number of vertices if there is no such vertex
+     */
+    std::size_t find(const T& label) const {
+        if( labelIndexVector_.empty() ) {
+            const auto it = std::lower_bound(labelVector_.begin(), labelVector_.end(), label);
+            if( it==labelVector_.end() || !(*it==label) ) {
+                return labelVector_.size();
+            }
+            return static_cast<std::size_t>(it - labelVector_.begin());
+        }
+        const auto it = std::lower_bound(labelIndexVector_.begin(), labelIndexVector_.end(), label, [&](VertexId id, const T& l) {
+            return labelVector_[id] < l;
+        });
+        if( it==labelIndexVector_.end() || !(labelVector_[*it]==label) ) {
+            return labelVector_.size();
+        }
+        return *it;
+    }
+
+
+public:
+
+    /**
+     * Label of each vertex, by identifier.
+     */
+    std::vector<T>
+    labelVector_;
+
+    /**
+     * Identifiers sorted by label, empty while the identifiers follow
+     * the label order.
+     */
+    std::vector<VertexId>
+    labelIndexVector_;
+
+};
+
+
+/**
+ * Frozen, compact copy of a graph for the algorithms.
+ * 
+ * Vertices are given dense identifiers following the label order of
+ * the vertex registry, and the links are stored in compressed sparse
+ * row form: the neighbors of the vertex v are the targets of the arcs
+ * offsetVector_[v] to offsetVector_[v + 1] - 1, sorted by identifier.
+ * An undirected link is stored as two arcs, as in the graph.
+ * 
+ * The snapshot does not follow the later modifications of the graph.
+ * 
+ * Template argument:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct GraphSnapshot : public VertexLabels<T>, public WeightVector<W> {
+
+    using VertexLabels<T>::labelVector_;
+    using VertexLabels<T>::labelIndexVector_;
+    using VertexLabels<T>::label;
+    using VertexLabels<T>::idOf;
+
+    /**
+     * Type of the weights returned by weight(), std::size_t (all weights 1)
+     * for an unweighted graph.
+     */
+    using WeightType = std::conditional_t<std::is_void_v<W>, std::size_t, W>;
+
+    /**
+     * Constructor of an empty snapshot.
+     */
+    GraphSnapshot() : directed_(false), offsetVector_(1, 0) { }
+
+    /**
+     * Constructor
+     * 
+     * @param graph The undirected graph to freeze
+     */
+    explicit GraphSnapshot(const UndirectedGraph<T, W>& graph) : directed_(false)
+    { build(graph); }
+
+    /**
+     * Constructor
+     * 
+     * @param graph The directed graph to freeze
+     */
+    explicit GraphSnapshot(const DirectedGraph<T, W>& graph) : directed_(true)
+    { build(graph); }
+
+    /**
+     * Snapshot built straight from an edge list, without the vertices
+     * and links of a graph: the same as the snapshot of a graph filled
+     * by addEdgeList(edgeList), without its memory and time. The labels
+     * are resolved and the adjacency lists sorted in parallel.
+     * 
+     * @param edgeList vector of pairs or tuples (e1, e2[, weight]) corresponding to edge
+     * @param directed true for the snapshot of a directed graph
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the snapshot
+     */
+    template<class E>
+    static GraphSnapshot<T, W> fromEdgeList(const std::vector<E>& edgeList, bool directed, unsigned int threadCount = 0) {
+        GRAPHTHEWY_STATS_TIMER(timer, "snapshotFromEdgeList");
+        GraphSnapshot<T, W> s;
+        s.directed_ = directed;
+        s.labelVector_.reserve(2 * edgeList.size());
+        for(const auto& e : edgeList) {
+            s.labelVector_.push_back(std::get<0>(e));
+            s.labelVector_.push_back(std::get<1>(e));
+        }
+        std::sort(s.labelVector_.begin(), s.labelVector_.end());
+        s.labelVector_.erase(std::unique(s.labelVector_.begin(), s.labelVector_.end()), s.labelVector_.end());
+        s.labelVector_.shrink_to_fit();
+        std::vector<VertexId> endVector(2 * edgeList.size());
+        parallelChunks(edgeList.size(), threadCount, [&](unsigned int, std::size_t begin, std::size_t end) {
+            for(std::size_t i=begin; i<end; i++) {
+                endVector[2 * i] = static_cast<VertexId>(s.find(std::get<0>(edgeList[i])));
+                endVector[2 * i + 1] = static_cast<VertexId>(s.find(std::get<1>(edgeList[i])));
+            }
+        });
+        s.offsetVector_.assign(s.order() + 1, 0);
+        for(std::size_t i=0; i<edgeList.size(); i++) {
+            s.offsetVector_[endVector[2 * i] + 1]++;
+            if( !directed ) {
+                s.offsetVector_[endVector[2 * i + 1] + 1]++;
+            }
+        }
+        std::partial_sum(s.offsetVector_.begin(), s.offsetVector_.end(), s.offsetVector_.begin());
+        std::vector<std::size_t> cursor(s.offsetVector_.begin(), s.offsetVector_.end() - 1);
+        // Position of each arc in the edge list, so that repeated links keep
+        // the weights in the order a graph would have stored them
+        std::vector<std::size_t> edgeIndexVector(std::is_void_v<W> ? 0 : s.offsetVector_.back());
+        s.targetVector_.resize(s.offsetVector_.back());
+        for(std::size_t i=0; i<edgeList.size(); i++) {
+            const VertexId u = endVector[2 * i];
+            const VertexId v = endVector[2 * i + 1];
+            if constexpr( !std::is_void_v<W> ) {
+                edgeIndexVector[cursor[u]] = i;
+            }
+            s.targetVector_[cursor[u]++] = v;
+            if( !directed ) {
+                if constexpr( !std::is_void_v<W> ) {
+                    edgeIndexVector[cursor[v]] = i;
+                }
+                s.targetVector_[cursor[v]++] = u;
+            }
+        }
+        if constexpr( std::is_void_v<W> ) {
+            // Without weights, repeated links need no particular order
+            parallelDynamic(s.order(), threadCount, [&](unsigned int, std::size_t v) {
+                std::sort(s.targetVector_.begin() + s.offsetVector_[v], s.targetVector_.begin() + s.offsetVector_[v + 1]);
+            });
+        } else {
+            s.weightVector_.resize(s.arcCount());
+            std::vector<std::vector<std::pair<VertexId, std::size_t>>> bufferVector(threadCount==0 ? defaultThreadCount() : threadCount);
+            parallelDynamic(s.order(), threadCount, [&](unsigned int c, std::size_t v) {
+                std::vector<std::pair<VertexId, std::size_t>>& arcVector = bufferVector[c];
+                arcVector.clear();
+                for(std::size_t a=s.offsetVector_[v]; a<s.offsetVector_[v + 1]; a++) {
+                    arcVector.emplace_back(s.targetVector_[a], edgeIndexVector[a]);
+                }
+                std::sort(arcVector.begin(), arcVector.end());
+                for(std::size_t i=0; i<arcVector.size(); i++) {
+                    const std::size_t a = s.offsetVector_[v] + i;
+                    s.targetVector_[a] = arcVector[i].first;
+                    if constexpr( std::tuple_size_v<E> == 3 ) {
+                        s.weightVector_[a] = std::get<2>(edgeList[arcVector[i].second]);
+                    } else {
+                        s.weightVector_[a] = W(1);
+                    }
+                }
+            });
+        }
+        GRAPHTHEWY_STATS_VISIT(timer, s.order(), s.arcCount());
+        return s;
+    }
+
+    /**
+     * Order of the graph (number of vertices)
+     * 
+     * @return the order of the graph
+     */
+    std::size_t order() const
+    { return labelVector_.size(); }
+
+    /**
+     * Number of stored arcs (twice the number of edges for an undirected graph).
+     * 
+     * @return the number of arcs
+     */
+    std::size_t arcCount() const
+    { return targetVector_.size(); }
+
+    /**
+     * Whether the snapshot has been taken from a directed graph.
+     * 
+     * @return true or false
+     */
+    bool isDirected() const
+    { return directed_; }
+
+    /**
+     * Out-degree of a vertex.
+     * 
+     * @param v the vertex identifier
+     * @return the number of arcs starting from v
+     */
+    std::size_t degree(VertexId v) const
+    { return offsetVector_[v + 1] - offsetVector_[v]; }
+
+    /**
+     * Neighbors of a vertex, sorted by identifier.
+     * 
+     * @param v the vertex identifier
+     * @return the range of neighbor identifiers
+     */
+    NeighborRange neighbors(VertexId v) const {
+        const VertexId* base = targetVector_.data();
+        return NeighborRange{base + offsetVector_[v], base + offsetVector_[v + 1]};
+    }
+
+    /**
+     * Weight of an arc, 1 for an unweighted graph.
+     * 
+     * @param arc the arc index, between offsetVector_[v] and offsetVector_[v + 1] - 1
+     * @return the weight
+     */
+    WeightType weight(std::size_t arc) const {
+        if constexpr( std::is_void_v<W> ) {
+            (void) arc;
+            return 1;
+        } else {
+            return this->weightVector_[arc];
+        }
+    }
+
+    /**
+     * Snapshot with all the arcs reversed, giving the in-neighbors of each
+     * vertex. For an undirected snapshot, this is a copy.
+     * 
+     * @return the transposed snapshot
+     */
+    GraphSnapshot<T, W> transpose() const {
+        if( !directed_ ) {
+            return *this;
+        }
+        GraphSnapshot<T, W> t;
+        t.directed_ = true;
+        t.labelVector_ = labelVector_;
+        t.labelIndexVector_ = labelIndexVector_;
+        t.offsetVector_.assign(order() + 1, 0);
+        for(const VertexId target : targetVector_) {
+            t.offsetVector_[target + 1]++;
+        }
+        std::partial_sum(t.offsetVector_.begin(), t.offsetVector_.end(), t.offsetVector_.begin());
+        std::vector<std::size_t> cursor(t.offsetVector_.begin(), t.offsetVector_.end() - 1);
+        t.targetVector_.resize(arcCount());
+        if constexpr( !std::is_void_v<W> ) {
+            t.weightVector_.resize(arcCount());
+        }
+        // Sources are visited in increasing order, so each in-list is sorted
+        for(VertexId v=0; v<order(); v++) {
+            for(std::size_t a=offsetVector_[v]; a<offsetVector_[v + 1]; a++) {
+                const std::size_t slot = cursor[targetVector_[a]]++;
+                t.targetVector_[slot] = v;
+                if constexpr( !std::is_void_v<W> ) {
+                    t.weightVector_[slot] = this->weightVector_[a];
+                }
+            }
+        }
+        return t;
+    }
+
+    /**
+     * Snapshot with the vertices renumbered, for instance to improve the
+     * memory locality of the traversals. Labels follow their vertex, so
+     * label() and idOf() still map identifiers to labels.
+     * 
+     * @param permutation The new identifier of each vertex, by current identifier
+     * @return the renumbered snapshot
+     */
+    GraphSnapshot<T, W> permute(const std::vector<VertexId>& permutation) const {
+        GraphSnapshot<T, W> p;
+        p.directed_ = directed_;
+        p.labelVector_.resize(order());
+        p.offsetVector_.assign(order() + 1, 0);
+        for(VertexId v=0; v<order(); v++) {
+            p.labelVector_[permutation[v]] = labelVector_[v];
+            p.offsetVector_[permutation[v] + 1] = degree(v);
+        }
+        std::partial_sum(p.offsetVector_.begin(), p.offsetVector_.end(), p.offsetVector_.begin());
+        p.targetVector_.resize(arcCount());
+        if constexpr( !std::is_void_v<W> ) {
+            p.weightVector_.resize(arcCount());
+        }
+        std::vector<std::pair<VertexId, std::size_t>> arcVector;
+        for(VertexId v=0; v<order(); v++) {
+            arcVector.clear();
+            for(std::size_t a=offsetVector_[v]; a<offsetVector_[v + 1]; a++) {
+                arcVector.emplace_back(permutation[targetVector_[a]], a);
+            }
+            std::sort(arcVector.begin(), arcVector.end());
+            const std::size_t base = p.offsetVector_[permutation[v]];
+            for(std::size_t i=0; i<arcVector.size(); i++) {
+                p.targetVector_[base + i] = arcVector[i].first;
+                if constexpr( !std::is_void_v<W> ) {
+                    p.weightVector_[base + i] = this->weightVector_[arcVector[i].second];
+                }
+            }
+        }
+        p.labelIndexVector_.resize(order());
+        std::iota(p.labelIndexVector_.begin(), p.labelIndexVector_.end(), VertexId(0));
+        std::sort(p.labelIndexVector_.begin(), p.labelIndexVector_.end(), [&](VertexId a, VertexId b) {
+            return p.labelVector_[a] < p.labelVector_[b];
+        });
+        return p;
+    }
+
+
+protected:
+
+    /**
+     * Fill the snapshot from a graph.
+     * 
+     * @param graph The graph to freeze
+     */
+    void build(const UndirectedGraph<T, W>& graph) {
+        GRAPHTHEWY_STATS_TIMER(timer, "snapshot");
+        std::unordered_map<const Vertex<T, W>*, VertexId> idMap;
+        idMap.reserve(graph.vertexPtrMap_.size());
+        labelVector_.reserve(graph.vertexPtrMap_.size());
+        offsetVector_.reserve(graph.vertexPtrMap_.size() + 1);
+        offsetVector_.push_back(0);
+        for(const auto& e : graph.vertexPtrMap_) {
+            idMap.emplace(e.second.get(), static_cast<VertexId>(labelVector_.size()));
+            labelVector_.push_back(e.first);
+            offsetVector_.push_back(offsetVector_.back() + e.second->linkVectorPtr_.size());
+        }
+        targetVector_.resize(offsetVector_.back());
+        if constexpr( !std::is_void_v<W> ) {
+            this->weightVector_.resize(offsetVector_.back());
+        }
+        std::vector<std::pair<VertexId, std::size_t>> arcVector;
+        VertexId v = 0;
+        for(const auto& e : graph.vertexPtrMap_) {
+            const auto& linkVectorPtr = e.second->linkVectorPtr_;
+            arcVector.clear();
+            for(std::size_t i=0; i<linkVectorPtr.size(); i++) {
+                arcVector.emplace_back(idMap.at(linkVectorPtr[i].lock().get()), i);
+            }
+            std::sort(arcVector.begin(), arcVector.end());
+            const std::size_t base = offsetVector_[v];
+            for(std::size_t i=0; i<arcVector.size(); i++) {
+                targetVector_[base + i] = arcVector[i].first;
+                if constexpr( !std::is_void_v<W> ) {
+                    this->weightVector_[base + i] = e.second->weightVector_[arcVector[i].second];
+                }
+            }
+            v++;
+        }
+        GRAPHTHEWY_STATS_VISIT(timer, labelVector_.size(), targetVector_.size());
+    }
+
+public:
+
+    /**
+     * Whether the snapshot has been taken from a directed graph.
+     */
+    bool
+    directed_;
+
+    /**
+     * Index of the first arc of each vertex, plus the total number of arcs.
+     */
+    std::vector<std::size_t>
+    offsetVector_;
+
+    /**
+     * Target of each arc.
+     */
+    std::vector<VertexId>
+    targetVector_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_SNAPSHOT_HPP_
@@ -0,0 +1,279 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_SPANNING_TREE_HPP_
+#define _GRAPH_MODEL_SPANNING_TREE_HPP_
+
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyComponents.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Minimum spanning forest of an undirected snapshot: a spanning tree of
+ * each connected component, of least total weight (each link weighing 1
+ * in an unweighted graph). Self-loops are ignored; of repeated links,
+ * the lightest may be taken.
+ * 
+ * The links are handled as arc indices of the snapshot, in flat
+ * vectors, without any allocation per link.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct SpanningForest {
+
+    using WeightType = typename GraphSnapshot<T, W>::WeightType;
+
+    /**
+     * Constructor
+     * 
+     * @param snapshot The snapshot of an undirected graph
+     */
+    SpanningForest(const GraphSnapshot<T, W>& snapshot)
+    : snapshot_(snapshot), totalWeight_(0) {
+        if( snapshot_.isDirected() ) {
+            throw std::runtime_error("graphthewy: spanning trees need an undirected snapshot");
+        }
+    }
+
+    /**
+     * Kruskal's algorithm: the links are sorted by weight in parallel,
+     * then taken in that order when they join two different trees of a
+     * union-find. Stops as soon as the forest is complete.
+     * 
+     * @param threadCount The number of threads of the sort, 0 for the hardware concurrency
+     * @return the total weight of the forest
+     */
+    WeightType kruskal(unsigned int threadCount = 0) {
+        GRAPHTHEWY_STATS_TIMER(timer, "kruskal");
+        const std::size_t n = snapshot_.order();
+        // Each link once, by its arc from the lower identifier, next to its
+        // weight so that the sort does not chase the weights
+        std::vector<std::pair<WeightType, std::size_t>> arcVector;
+        arcVector.reserve(snapshot_.arcCount() / 2);
+        for(VertexId u=0; u<n; u++) {
+            for(std::size_t a=snapshot_.offsetVector_[u]; a<snapshot_.offsetVector_[u + 1]; a++) {
+                if( u<snapshot_.targetVector_[a] ) {
+                    arcVector.emplace_back(snapshot_.weight(a), a);
+                }
+            }
+        }
+        parallelSort(arcVector.begin(), arcVector.end(), [](const std::pair<WeightType, std::size_t>& a, const std::pair<WeightType, std::size_t>& b) {
+            return a.first<b.first || (!(b.first<a.first) && a.second<b.second);
+        }, threadCount);
+        clear();
+        DisjointSet ds(n);
+        for(std::size_t i=0; i<arcVector.size() && treeVector_.size() + 1<n; i++) {
+            const std::size_t a = arcVector[i].second;
+            const VertexId u = sourceOf(a);
+            if( ds.unite(u, snapshot_.targetVector_[a]) ) {
+                add(u, a);
+            }
+            GRAPHTHEWY_STATS_VISIT(timer, 0, 1);
+        }
+        return totalWeight_;
+    }
+
+    /**
+     * Borůvka's algorithm: in each round, every tree picks its lightest
+     * link to another tree, the vertices being scanned in parallel, and
+     * all the picked links are added at once. The number of trees at
+     * least halves each round. Ties are broken by the identifiers of the
+     * ends, so that the picked links never close a cycle.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the total weight of the forest
+     */
+    WeightType boruvka(unsigned int threadCount = 0) {
+        GRAPHTHEWY_STATS_TIMER(timer, "boruvka");
+        const std::size_t n = snapshot_.order();
+        clear();
+        DisjointSet ds(n);
+        std::vector<VertexId> componentVector(n);
+        std::vector<std::size_t> bestVector(n);
+        std::vector<VertexId> bestSourceVector(n);
+        const auto lighter = [&](VertexId u, std::size_t a, VertexId x, std::size_t b) {
+            const WeightType wa = snapshot_.weight(a);
+            const WeightType wb = snapshot_.weight(b);
+            if( wa<wb || wb<wa ) {
+                return wa<wb;
+            }
+            const VertexId v = snapshot_.targetVector_[a];
+            const VertexId y = snapshot_.targetVector_[b];
+            return std::make_pair(std::min(u, v), std::max(u, v))<std::make_pair(std::min(x, y), std::max(x, y));
+        };
+        for(bool merged=true; merged; ) {
+            merged = false;
+            for(VertexId v=0; v<n; v++) {
+                componentVector[v] = ds.find(v);
+            }
+            // The lightest link of each vertex toward another tree
+            parallelDynamic(n, threadCount, [&](unsigned int, std::size_t u) {
+                std::size_t best = noArc;
+                for(std::size_t a=snapshot_.offsetVector_[u]; a<snapshot_.offsetVector_[u + 1]; a++) {
+                    if( componentVector[snapshot_.targetVector_[a]]!=componentVector[u]
+                        && (best==noArc || lighter(static_cast<VertexId>(u), a, static_cast<VertexId>(u), best)) ) {
+                        best = a;
+                    }
+                }
+                bestVector[u] = best;
+            }, 1024);
+            GRAPHTHEWY_STATS_VISIT(timer, n, snapshot_.arcCount());
+            // The lightest of each tree, kept at its representative
+            std::fill(bestSourceVector.begin(), bestSourceVector.end(), noVertex);
+            for(VertexId u=0; u<n; u++) {
+                const std::size_t a = bestVector[u];
+                if( a==noArc ) {
+                    continue;
+                }
+                const VertexId c = componentVector[u];
+                const VertexId x = bestSourceVector[c];
+                if( x==noVertex || lighter(u, a, x, bestVector[x]) ) {
+                    bestSourceVector[c] = u;
+                }
+            }
+            for(VertexId c=0; c<n; c++) {
+                const VertexId u = bestSourceVector[c];
+                if( u!=noVertex && ds.unite(u, snapshot_.targetVector_[bestVector[u]]) ) {
+                    add(u, bestVector[u]);
+                    merged = true;
+                }
+            }
+        }
+        return totalWeight_;
+    }
+
+    /**
+     * @return the total weight of the forest
+     */
+    WeightType totalWeight() const
+    { return totalWeight_; }
+
+    /**
+     * @return the number of links of the forest, the order minus the number of components
+     */
+    std::size_t edgeCount() const
+    { return treeVector_.size(); }
+
+    /**
+     * Links of the forest, as given to addEdgeList(): one pair per link,
+     * where getEdgePairList() gives both directions of each link of an
+     * undirected graph.
+     * 
+     * @return vector of pairs of label corresponding to edge
+     */
+    std::vector<std::pair<T, T>> edgePairList() const {
+        std::vector<std::pair<T, T>> edgePairList;
+        edgePairList.reserve(treeVector_.size());
+        for(const auto& e : treeVector_) {
+            edgePairList.emplace_back(snapshot_.label(e.first), snapshot_.label(snapshot_.targetVector_[e.second]));
+        }
+        return edgePairList;
+    }
+
+    /**
+     * Weighted links of the forest, as given to the weighted addEdgeList().
+     * 
+     * @return vector of tuples corresponding to weighted edge
+     */
+    template<class U = W, class = std::enable_if_t<!std::is_void_v<U>>>
+    std::vector<std::tuple<T, T, U>> edgeList() const {
+        std::vector<std::tuple<T, T, U>> edgeList;
+        edgeList.reserve(treeVector_.size());
+        for(const auto& e : treeVector_) {
+            edgeList.emplace_back(snapshot_.label(e.first), snapshot_.label(snapshot_.targetVector_[e.second]), snapshot_.weight(e.second));
+        }
+        return edgeList;
+    }
+
+
+protected:
+
+    /**
+     * Marks a vertex without a link toward another tree.
+     */
+    static constexpr std::size_t noArc = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * Marks a tree without a link toward another tree.
+     */
+    static constexpr VertexId noVertex = std::numeric_limits<VertexId>::max();
+
+    /**
+     * Source of an arc, by binary search of the offsets.
+     * 
+     * @param a the arc index
+     * @return the vertex identifier
+     */
+    VertexId sourceOf(std::size_t a) const {
+        const auto it = std::upper_bound(snapshot_.offsetVector_.begin(), snapshot_.offsetVector_.end(), a);
+        return static_cast<VertexId>(it - snapshot_.offsetVector_.begin() - 1);
+    }
+
+    /**
+     * Empty the forest.
+     */
+    void clear() {
+        treeVector_.clear();
+        totalWeight_ = 0;
+    }
+
+    /**
+     * Add a link to the forest.
+     * 
+     * @param u the source
+     * @param a the arc index
+     */
+    void add(VertexId u, std::size_t a) {
+        treeVector_.emplace_back(u, a);
+        totalWeight_ += snapshot_.weight(a);
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * Links of the forest, as their source and their arc index.
+     */
+    std::vector<std::pair<VertexId, std::size_t>>
+    treeVector_;
+
+    /**
+     * Total weight of the forest.
+     */
+    WeightType
+    totalWeight_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_SPANNING_TREE_HPP_
@@ -0,0 +1,429 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_STATS_HPP_
+#define _GRAPH_MODEL_STATS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Counters of an algorithm.
+ */
+struct AlgorithmStats {
+
+    /**
+     * Number of runs.
+     */
+    std::uint64_t
+    callCount_;
+
+    /**
+     * Total wall time, in nanoseconds.
+     */
+    std::uint64_t
+    nanoseconds_;
+
+    /**
+     * Total number of vertices visited.
+     */
+    std::uint64_t
+    vertexCount_;
+
+    /**
+     * Total number of edges (arcs) visited.
+     */
+    std::uint64_t
+    edgeCount_;
+
+};
+
+/**
+ * Copy of the counters of the library, as returned by stats().
+ * 
+ * The counters are only maintained when GRAPHTHEWY_STATS is defined
+ * before including the headers; otherwise they stay at 0 and cost
+ * nothing.
+ */
+struct GraphStats {
+
+    /**
+     * Average number of links scanned by Vertex::contains().
+     * 
+     * @return the average scan length
+     */
+    double averageScanLength() const {
+        return containsCount_==0 ? 0 : static_cast<double>(containsScanCount_) / static_cast<double>(containsCount_);
+    }
+
+    /**
+     * JSON form of the counters.
+     * 
+     * @return the JSON object
+     */
+    std::string toJson() const {
+        std::ostringstream out;
+        out << "{\"enabled\": " << (enabled_ ? "true" : "false")
+            << ", \"vertexLookups\": " << vertexLookupCount_
+            << ", \"linkLookups\": " << linkLookupCount_
+            << ", \"containsCalls\": " << containsCount_
+            << ", \"containsScanned\": " << containsScanCount_
+            << ", \"averageScanLength\": " << averageScanLength()
+            << ", \"links\": " << linkCount_
+            << ", \"copies\": " << copyCount_
+            << ", \"allocations\": " << allocationCount_
+            << ", \"bytesInUse\": " << bytesInUse_
+            << ", \"algorithms\": {";
+        const char* separator = "";
+        for(const auto& a : algorithmMap_) {
+            out << separator << "\"" << a.first << "\": {\"calls\": " << a.second.callCount_
+                << ", \"seconds\": " << static_cast<double>(a.second.nanoseconds_) * 1e-9
+                << ", \"vertices\": " << a.second.vertexCount_
+                << ", \"edges\": " << a.second.edgeCount_ << "}";
+            separator = ", ";
+        }
+        out << "}}";
+        return out.str();
+    }
+
+    /**
+     * Whether the library has been compiled with GRAPHTHEWY_STATS.
+     */
+    bool
+    enabled_;
+
+    /**
+     * Lookups of a vertex by label in a graph.
+     */
+    std::uint64_t
+    vertexLookupCount_;
+
+    /**
+     * Calls to isLinked().
+     */
+    std::uint64_t
+    linkLookupCount_;
+
+    /**
+     * Calls to Vertex::contains().
+     */
+    std::uint64_t
+    containsCount_;
+
+    /**
+     * Links scanned by Vertex::contains().
+     */
+    std::uint64_t
+    containsScanCount_;
+
+    /**
+     * Links created.
+     */
+    std::uint64_t
+    linkCount_;
+
+    /**
+     * Graph copies.
+     */
+    std::uint64_t
+    copyCount_;
+
+    /**
+     * Allocations of vertices and of adjacency vectors.
+     */
+    std::uint64_t
+    allocationCount_;
+
+    /**
+     * Bytes held by the vertices and their adjacency vectors.
+     */
+    std::int64_t
+    bytesInUse_;
+
+    /**
+     * Counters of each instrumented algorithm, by name.
+     */
+    std::map<std::string, AlgorithmStats>
+    algorithmMap_;
+
+};
+
+
+/**
+ * Live counters, shared by all the graphs of the process.
+ */
+struct StatsRegistry {
+
+    /**
+     * Lookups of a vertex by label in a graph.
+     */
+    std::atomic<std::uint64_t>
+    vertexLookupCount_{0};
+
+    /**
+     * Calls to isLinked().
+     */
+    std::atomic<std::uint64_t>
+    linkLookupCount_{0};
+
+    /**
+     * Calls to Vertex::contains().
+     */
+    std::atomic<std::uint64_t>
+    containsCount_{0};
+
+    /**
+     * Links scanned by Vertex::contains().
+     */
+    std::atomic<std::uint64_t>
+    containsScanCount_{0};
+
+    /**
+     * Links created.
+     */
+    std::atomic<std::uint64_t>
+    linkCount_{0};
+
+    /**
+     * Graph copies.
+     */
+    std::atomic<std::uint64_t>
+    copyCount_{0};
+
+    /**
+     * Allocations of vertices and of adjacency vectors.
+     */
+    std::atomic<std::uint64_t>
+    allocationCount_{0};
+
+    /**
+     * Bytes held by the vertices and their adjacency vectors.
+     */
+    std::atomic<std::int64_t>
+    bytesInUse_{0};
+
+    /**
+     * Protects the algorithm map.
+     */
+    std::mutex
+    mutex_;
+
+    /**
+     * Counters of each instrumented algorithm, by name.
+     */
+    std::map<std::string, AlgorithmStats>
+    algorithmMap_;
+
+};
+
+/**
+ * @return the live counters
+ */
+inline StatsRegistry& statsRegistry() {
+    // Never destroyed, as graphs with static storage may outlive it
+    static StatsRegistry* registry = new StatsRegistry();
+    return *registry;
+}
+
+/**
+ * Copy of the counters.
+ * 
+ * @return the counters
+ */
+inline GraphStats stats() {
+    StatsRegistry& r = statsRegistry();
+    GraphStats s;
+#ifdef GRAPHTHEWY_STATS
+    s.enabled_ = true;
+#else
+    s.enabled_ = false;
+#endif
+    s.vertexLookupCount_ = r.vertexLookupCount_.load();
+    s.linkLookupCount_ = r.linkLookupCount_.load();
+    s.containsCount_ = r.containsCount_.load();
+    s.containsScanCount_ = r.containsScanCount_.load();
+    s.linkCount_ = r.linkCount_.load();
+    s.copyCount_ = r.copyCount_.load();
+    s.allocationCount_ = r.allocationCount_.load();
+    s.bytesInUse_ = r.bytesInUse_.load();
+    std::lock_guard<std::mutex> lock(r.mutex_);
+    s.algorithmMap_ = r.algorithmMap_;
+    return s;
+}
+
+/**
+ * Reset the counters, except the bytes in use which follow the live
+ * vertices.
+ */
+inline void resetStats() {
+    StatsRegistry& r = statsRegistry();
+    r.vertexLookupCount_ = 0;
+    r.linkLookupCount_ = 0;
+    r.containsCount_ = 0;
+    r.containsScanCount_ = 0;
+    r.linkCount_ = 0;
+    r.copyCount_ = 0;
+    r.allocationCount_ = 0;
+    std::lock_guard<std::mutex> lock(r.mutex_);
+    r.algorithmMap_.clear();
+}
+
+/**
+ * Scoped measure of an algorithm run, recorded when destroyed.
+ */
+class StatsTimer {
+
+public:
+
+    /**
+     * Constructor, starting the clock.
+     * 
+     * @param name The name of the algorithm
+     */
+    StatsTimer(const char* name)
+    : name_(name), start_(std::chrono::steady_clock::now()), vertexCount_(0), edgeCount_(0) { }
+
+    StatsTimer(const StatsTimer&) = delete;
+
+    StatsTimer& operator=(const StatsTimer&) = delete;
+
+    /**
+     * Count visited vertices and edges.
+     * 
+     * @param vertexCount The number of vertices
+     * @param edgeCount The number of edges
+     */
+    void visit(std::uint64_t vertexCount, std::uint64_t edgeCount) {
+        vertexCount_ += vertexCount;
+        edgeCount_ += edgeCount;
+    }
+
+    ~StatsTimer() {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+        StatsRegistry& r = statsRegistry();
+        std::lock_guard<std::mutex> lock(r.mutex_);
+        AlgorithmStats& a = r.algorithmMap_[name_];
+        a.callCount_++;
+        a.nanoseconds_ += static_cast<std::uint64_t>(elapsed.count());
+        a.vertexCount_ += vertexCount_;
+        a.edgeCount_ += edgeCount_;
+    }
+
+
+protected:
+
+    /**
+     * The name of the algorithm.
+     */
+    const char*
+    name_;
+
+    /**
+     * The start time.
+     */
+    std::chrono::steady_clock::time_point
+    start_;
+
+    /**
+     * Vertices visited.
+     */
+    std::uint64_t
+    vertexCount_;
+
+    /**
+     * Edges visited.
+     */
+    std::uint64_t
+    edgeCount_;
+
+};
+
+/**
+ * Append to a vector, counting the reallocation if any.
+ * 
+ * @param vector The vector
+ * @param x The element
+ */
+template<class V, class X>
+inline void trackedPushBack(std::vector<V>& vector, X&& x) {
+#ifdef GRAPHTHEWY_STATS
+    const std::size_t capacity = vector.capacity();
+    vector.push_back(std::forward<X>(x));
+    if( vector.capacity()!=capacity ) {
+        statsRegistry().allocationCount_.fetch_add(1, std::memory_order_relaxed);
+        statsRegistry().bytesInUse_.fetch_add(static_cast<std::int64_t>((vector.capacity() - capacity) * sizeof(V)), std::memory_order_relaxed);
+    }
+#else
+    vector.push_back(std::forward<X>(x));
+#endif
+}
+
+/**
+ * Reserve room in a vector, counting the reallocation if any.
+ * 
+ * @param vector The vector
+ * @param size The size to reserve
+ */
+template<class V>
+inline void trackedReserve(std::vector<V>& vector, std::size_t size) {
+#ifdef GRAPHTHEWY_STATS
+    const std::size_t capacity = vector.capacity();
+    vector.reserve(size);
+    if( vector.capacity()!=capacity ) {
+        statsRegistry().allocationCount_.fetch_add(1, std::memory_order_relaxed);
+        statsRegistry().bytesInUse_.fetch_add(static_cast<std::int64_t>((vector.capacity() - capacity) * sizeof(V)), std::memory_order_relaxed);
+    }
+#else
+    vector.reserve(size);
+#endif
+}
+
+/**
+ * Release the unused capacity of a vector, counting the released bytes.
+ * 
+ * @param vector The vector
+ */
+template<class V>
+inline void trackedShrinkToFit(std::vector<V>& vector) {
+#ifdef GRAPHTHEWY_STATS
+    const std::size_t capacity = vector.capacity();
+    vector.shrink_to_fit();
+    statsRegistry().bytesInUse_.fetch_sub(static_cast<std::int64_t>((capacity - vector.capacity()) * sizeof(V)), std::memory_order_relaxed);
+#else
+    vector.shrink_to_fit();
+#endif
+}
+
+}
+
+
+#ifdef GRAPHTHEWY_STATS
+#define GRAPHTHEWY_STATS_ADD(counter, n) ::graphthewy::statsRegistry().counter.fetch_add((n), std::memory_order_relaxed)
+#define GRAPHTHEWY_STATS_TIMER(timer, name) ::graphthewy::StatsTimer timer(name)
+#define GRAPHTHEWY_STATS_VISIT(timer, vertexCount, edgeCount) timer.visit((vertexCount), (edgeCount))
+#else
+#define GRAPHTHEWY_STATS_ADD(counter, n) ((void)0)
+#define GRAPHTHEWY_STATS_TIMER(timer, name) ((void)0)
+#define GRAPHTHEWY_STATS_VISIT(timer, vertexCount, edgeCount) ((void)0)
+#endif
+
+
+#endif // _GRAPH_MODEL_STATS_HPP_
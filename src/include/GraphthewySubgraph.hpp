@@ -0,0 +1,464 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_SUBGRAPH_HPP_
+#define _GRAPH_MODEL_SUBGRAPH_HPP_
+
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+template<equality_comparable T, class W>
+class SubgraphView;
+
+/**
+ * Iterator over the neighbors of a vertex in a subgraph view, skipping
+ * the filtered ones.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight
+ */
+template<equality_comparable T, class W>
+class FilteredNeighborIterator {
+
+public:
+
+    /**
+     * Constructor, moving to the first kept neighbor.
+     * 
+     * @param view The view
+     * @param arc The first arc
+     * @param end Past the last arc
+     * @param source The vertex whose neighbors are iterated
+     */
+    FilteredNeighborIterator(const SubgraphView<T, W>* view, std::size_t arc, std::size_t end, VertexId source)
+    : view_(view), arc_(arc), end_(end), source_(source)
+    { skip(); }
+
+    /**
+     * @return the current neighbor
+     */
+    VertexId operator*() const
+    { return view_->snapshot_.targetVector_[arc_]; }
+
+    /**
+     * Move to the next kept neighbor.
+     * 
+     * @return the iterator
+     */
+    FilteredNeighborIterator& operator++() {
+        arc_++;
+        skip();
+        return *this;
+    }
+
+    /**
+     * @return the index of the current arc in the snapshot
+     */
+    std::size_t arc() const
+    { return arc_; }
+
+    bool operator==(const FilteredNeighborIterator& o) const
+    { return arc_==o.arc_; }
+
+    bool operator!=(const FilteredNeighborIterator& o) const
+    { return arc_!=o.arc_; }
+
+
+protected:
+
+    /**
+     * Move to the first kept arc from the current one.
+     */
+    void skip() {
+        while( arc_<end_ && !view_->keepArc(source_, arc_) ) {
+            arc_++;
+        }
+    }
+
+
+protected:
+
+    /**
+     * The view.
+     */
+    const SubgraphView<T, W>*
+    view_;
+
+    /**
+     * The current arc.
+     */
+    std::size_t
+    arc_;
+
+    /**
+     * Past the last arc.
+     */
+    std::size_t
+    end_;
+
+    /**
+     * The vertex whose neighbors are iterated.
+     */
+    VertexId
+    source_;
+
+};
+
+/**
+ * Range of the kept neighbors of a vertex in a subgraph view.
+ */
+template<equality_comparable T, class W>
+struct FilteredNeighborRange {
+
+    /**
+     * @return the first kept neighbor
+     */
+    FilteredNeighborIterator<T, W> begin() const
+    { return FilteredNeighborIterator<T, W>(view_, begin_, end_, source_); }
+
+    /**
+     * @return past the last neighbor
+     */
+    FilteredNeighborIterator<T, W> end() const
+    { return FilteredNeighborIterator<T, W>(view_, end_, end_, source_); }
+
+    /**
+     * The view.
+     */
+    const SubgraphView<T, W>*
+    view_;
+
+    /**
+     * The first arc.
+     */
+    std::size_t
+    begin_;
+
+    /**
+     * Past the last arc.
+     */
+    std::size_t
+    end_;
+
+    /**
+     * The vertex whose neighbors are iterated.
+     */
+    VertexId
+    source_;
+
+};
+
+
+/**
+ * Filtered view of a snapshot, without copy: a bitset tells the kept
+ * vertices, and an optional predicate the kept arcs. The view keeps the
+ * identifiers of the snapshot and has its order(), isDirected() and
+ * neighbors(v), so that the algorithms on adjacencies (AdjacencyCycle,
+ * hasUndirectedCycle) run on it directly; a removed vertex is left
+ * without neighbor. snapshot() and toGraph() materialize the subgraph.
+ * 
+ * The arc predicate of a view of an undirected snapshot must give the
+ * same answer for both arcs of a link.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+class SubgraphView {
+
+public:
+
+    /**
+     * Predicate on the arcs: source, target, and index of the arc in the
+     * snapshot (for its weight).
+     */
+    using ArcFilter = std::function<bool(VertexId, VertexId, std::size_t)>;
+
+    /**
+     * Constructor of a view keeping all the vertices.
+     * 
+     * @param snapshot The snapshot of the graph
+     */
+    SubgraphView(const GraphSnapshot<T, W>& snapshot)
+    : snapshot_(snapshot), maskVector_((snapshot.order() + 63) / 64, ~std::uint64_t(0)) {
+        if( snapshot_.order() % 64!=0 ) {
+            maskVector_.back() = (std::uint64_t(1) << (snapshot_.order() % 64)) - 1;
+        }
+    }
+
+    /**
+     * Constructor of the subgraph induced by some vertices.
+     * 
+     * @param snapshot The snapshot of the graph
+     * @param labelVector The labels of the kept vertices
+     */
+    SubgraphView(const GraphSnapshot<T, W>& snapshot, const std::vector<T>& labelVector)
+    : snapshot_(snapshot), maskVector_((snapshot.order() + 63) / 64, 0) {
+        for(const T& label : labelVector) {
+            include(snapshot_.idOf(label));
+        }
+    }
+
+    /**
+     * Keep only the vertices whose label satisfies a predicate, among
+     * the kept ones.
+     * 
+     * @param keep The predicate on the labels
+     */
+    template<class P>
+    void filterVertices(P&& keep) {
+        for(VertexId v=0; v<snapshot_.order(); v++) {
+            if( contains(v) && !keep(snapshot_.label(v)) ) {
+                exclude(v);
+            }
+        }
+    }
+
+    /**
+     * Keep only the arcs satisfying a predicate.
+     * 
+     * @param filter The predicate, empty to keep all the arcs
+     */
+    void filterArcs(ArcFilter filter)
+    { arcFilter_ = std::move(filter); }
+
+    /**
+     * Keep a vertex.
+     * 
+     * @param v the vertex identifier
+     */
+    void include(VertexId v)
+    { maskVector_[v / 64] |= std::uint64_t(1) << (v % 64); }
+
+    /**
+     * Remove a vertex.
+     * 
+     * @param v the vertex identifier
+     */
+    void exclude(VertexId v)
+    { maskVector_[v / 64] &= ~(std::uint64_t(1) << (v % 64)); }
+
+    /**
+     * @param v the vertex identifier
+     * @return true if the vertex is kept
+     */
+    bool contains(VertexId v) const
+    { return (maskVector_[v / 64] >> (v % 64)) & 1; }
+
+    /**
+     * @return the number of kept vertices
+     */
+    std::size_t vertexCount() const {
+        std::size_t count = 0;
+        for(const std::uint64_t word : maskVector_) {
+            count += static_cast<std::size_t>(__builtin_popcountll(word));
+        }
+        return count;
+    }
+
+    /**
+     * @return the order of the snapshot, kept vertices or not
+     */
+    std::size_t order() const
+    { return snapshot_.order(); }
+
+    /**
+     * @return true if the snapshot is directed
+     */
+    bool isDirected() const
+    { return snapshot_.isDirected(); }
+
+    /**
+     * @param v the vertex identifier
+     * @return the label of the vertex
+     */
+    const T& label(VertexId v) const
+    { return snapshot_.label(v); }
+
+    /**
+     * Kept neighbors of a vertex, sorted by identifier, none if the
+     * vertex is removed.
+     * 
+     * @param v the vertex identifier
+     * @return the range of neighbor identifiers
+     */
+    FilteredNeighborRange<T, W> neighbors(VertexId v) const {
+        const std::size_t begin = snapshot_.offsetVector_[v];
+        return FilteredNeighborRange<T, W>{this, begin, contains(v) ? snapshot_.offsetVector_[v + 1] : begin, v};
+    }
+
+    /**
+     * @param v the vertex identifier
+     * @return the number of kept neighbors
+     */
+    std::size_t degree(VertexId v) const {
+        std::size_t d = 0;
+        for(auto it=neighbors(v).begin(), end=neighbors(v).end(); it!=end; ++it) {
+            d++;
+        }
+        return d;
+    }
+
+    /**
+     * Compact snapshot of the subgraph, its vertices renumbered densely
+     * in the same order, built in one pass over the kept arcs.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the snapshot
+     */
+    GraphSnapshot<T, W> snapshot(unsigned int threadCount = 0) const {
+        GRAPHTHEWY_STATS_TIMER(timer, "subgraph");
+        const std::size_t n = snapshot_.order();
+        std::vector<VertexId> idVector(n, 0);
+        GraphSnapshot<T, W> s;
+        s.directed_ = snapshot_.directed_;
+        s.labelVector_.reserve(vertexCount());
+        for(VertexId v=0; v<n; v++) {
+            if( contains(v) ) {
+                idVector[v] = static_cast<VertexId>(s.labelVector_.size());
+                s.labelVector_.push_back(snapshot_.label(v));
+            }
+        }
+        const std::size_t m = s.labelVector_.size();
+        std::vector<VertexId> sourceVector(m);
+        s.offsetVector_.assign(m + 1, 0);
+        for(VertexId v=0; v<n; v++) {
+            if( contains(v) ) {
+                sourceVector[idVector[v]] = v;
+            }
+        }
+        parallelDynamic(m, threadCount, [&](unsigned int, std::size_t i) {
+            s.offsetVector_[i + 1] = degree(sourceVector[i]);
+        });
+        std::partial_sum(s.offsetVector_.begin(), s.offsetVector_.end(), s.offsetVector_.begin());
+        s.targetVector_.resize(s.offsetVector_.back());
+        if constexpr( !std::is_void_v<W> ) {
+            s.weightVector_.resize(s.offsetVector_.back());
+        }
+        // The renumbering keeps the order, so each list stays sorted
+        parallelDynamic(m, threadCount, [&](unsigned int, std::size_t i) {
+            std::size_t slot = s.offsetVector_[i];
+            const auto range = neighbors(sourceVector[i]);
+            for(auto it=range.begin(), end=range.end(); it!=end; ++it) {
+                s.targetVector_[slot] = idVector[*it];
+                if constexpr( !std::is_void_v<W> ) {
+                    s.weightVector_[slot] = snapshot_.weightVector_[it.arc()];
+                }
+                slot++;
+            }
+        });
+        if( !snapshot_.labelIndexVector_.empty() ) {
+            s.labelIndexVector_.resize(m);
+            std::iota(s.labelIndexVector_.begin(), s.labelIndexVector_.end(), VertexId(0));
+            std::sort(s.labelIndexVector_.begin(), s.labelIndexVector_.end(), [&](VertexId a, VertexId b) {
+                return s.labelVector_[a] < s.labelVector_[b];
+            });
+        }
+        GRAPHTHEWY_STATS_VISIT(timer, m, s.targetVector_.size());
+        return s;
+    }
+
+    /**
+     * Graph of the subgraph: an UndirectedGraph for an undirected
+     * snapshot, a DirectedGraph for a directed one. Each adjacency vector
+     * is allocated once, to its exact size.
+     * 
+     * @return the graph
+     */
+    template<template<class, class> class G>
+    G<T, W> toGraph() const {
+        if( std::is_same_v<G<T, W>, DirectedGraph<T, W>>!=snapshot_.isDirected() ) {
+            throw std::runtime_error("graphthewy: subgraph and graph directions differ");
+        }
+        G<T, W> g;
+        std::vector<const std::shared_ptr<Vertex<T, W>>*> ptrVector(snapshot_.order(), nullptr);
+        for(VertexId v=0; v<snapshot_.order(); v++) {
+            if( contains(v) ) {
+                const T& l = snapshot_.label(v);
+                ptrVector[v] = &g.vertexPtrMap_.emplace(l, std::shared_ptr<Vertex<T, W>>(new Vertex<T, W>(l))).first->second;
+            }
+        }
+        for(VertexId v=0; v<snapshot_.order(); v++) {
+            if( ptrVector[v]==nullptr ) {
+                continue;
+            }
+            Vertex<T, W>& vertex = **ptrVector[v];
+            trackedReserve(vertex.linkVectorPtr_, degree(v));
+            if constexpr( !std::is_void_v<W> ) {
+                trackedReserve(vertex.weightVector_, degree(v));
+            }
+            const auto range = neighbors(v);
+            for(auto it=range.begin(), end=range.end(); it!=end; ++it) {
+                if constexpr( !std::is_void_v<W> ) {
+                    vertex.link(*ptrVector[*it], snapshot_.weightVector_[it.arc()]);
+                } else {
+                    vertex.link(*ptrVector[*it]);
+                }
+            }
+        }
+        return g;
+    }
+
+
+protected:
+
+    /**
+     * @param source The source of the arc
+     * @param arc The index of the arc in the snapshot
+     * @return true if the arc is kept
+     */
+    bool keepArc(VertexId source, std::size_t arc) const {
+        const VertexId target = snapshot_.targetVector_[arc];
+        return contains(target) && (!arcFilter_ || arcFilter_(source, target, arc));
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * Bit v is set if the vertex v is kept.
+     */
+    std::vector<std::uint64_t>
+    maskVector_;
+
+    /**
+     * Predicate on the arcs, empty to keep all of them.
+     */
+    ArcFilter
+    arcFilter_;
+
+    friend class FilteredNeighborIterator<T, W>;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_SUBGRAPH_HPP_
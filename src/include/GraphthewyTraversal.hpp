@@ -0,0 +1,490 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_TRAVERSAL_HPP_
+#define _GRAPH_MODEL_TRAVERSAL_HPP_
+
+#include "GraphthewyModel.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 202002L
+#include <coroutine>
+#endif
+
+
+
+namespace graphthewy {
+
+/**
+ * Order of a traversal.
+ */
+enum class TraversalOrder {
+    /** Level by level, nearest vertices first. */
+    BreadthFirst,
+    /** Each link followed as deep as possible before the next one (preorder). */
+    DepthFirst
+};
+
+/**
+ * Vertex reached by a traversal, with the link it has been reached by.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct TraversalStep {
+
+    /**
+     * @return the label of the vertex
+     */
+    const T& label() const
+    { return vertex_->label_; }
+
+    /**
+     * The vertex reached.
+     */
+    const Vertex<T, W>*
+    vertex_;
+
+    /**
+     * The vertex it has been reached from, nullptr for the start vertex.
+     */
+    const Vertex<T, W>*
+    parent_;
+
+    /**
+     * Number of links between the start vertex and the vertex, along
+     * the traversal tree.
+     */
+    std::size_t
+    depth_;
+
+};
+
+
+/**
+ * Input iterator over the vertices of a traversal, computing the next
+ * vertex only when incremented, so that a traversal stopped early costs
+ * only what it has visited. It holds the frontier (the queue of a
+ * breadth-first traversal, the path of a depth-first one) and the set
+ * of the vertices reached, never a vector over the whole graph.
+ * 
+ * The graph must not be modified during the traversal.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+class TraversalIterator {
+
+public:
+
+    using iterator_category = std::input_iterator_tag;
+    using value_type = TraversalStep<T, W>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const TraversalStep<T, W>*;
+    using reference = const TraversalStep<T, W>&;
+
+    /**
+     * Constructor of the end iterator.
+     */
+    TraversalIterator()
+    : order_(TraversalOrder::BreadthFirst), step_{nullptr, nullptr, 0}, done_(true) { }
+
+    /**
+     * Constructor, positioned on the start vertex.
+     * 
+     * @param start The start vertex
+     * @param order The order of the traversal
+     */
+    TraversalIterator(const Vertex<T, W>* start, TraversalOrder order)
+    : order_(order), step_{start, nullptr, 0}, done_(false) {
+        visitedSet_.insert(start);
+        if( order_==TraversalOrder::DepthFirst ) {
+            stack_.emplace_back(step_, 0);
+        }
+    }
+
+    /**
+     * @return the current vertex
+     */
+    reference operator*() const
+    { return step_; }
+
+    /**
+     * @return the current vertex
+     */
+    pointer operator->() const
+    { return &step_; }
+
+    /**
+     * Move to the next vertex.
+     * 
+     * @return this iterator
+     */
+    TraversalIterator& operator++() {
+        if( order_==TraversalOrder::BreadthFirst ) {
+            nextBreadthFirst();
+        } else {
+            nextDepthFirst();
+        }
+        return *this;
+    }
+
+    /**
+     * @param other Another iterator
+     * @return true if both are at the end, or on the same vertex
+     */
+    bool operator==(const TraversalIterator& other) const
+    { return done_==other.done_ && (done_ || step_.vertex_==other.step_.vertex_); }
+
+    /**
+     * @param other Another iterator
+     * @return false if both are at the end, or on the same vertex
+     */
+    bool operator!=(const TraversalIterator& other) const
+    { return !(*this==other); }
+
+    /**
+     * @return the number of vertices reached so far, the frontier included
+     */
+    std::size_t reachedCount() const
+    { return visitedSet_.size(); }
+
+
+protected:
+
+    /**
+     * Queue the neighbors of the current vertex not reached yet, then
+     * take the first queued vertex.
+     */
+    void nextBreadthFirst() {
+        for(const auto& link : step_.vertex_->linkVectorPtr_) {
+            const Vertex<T, W>* v = link.lock().get();
+            if( visitedSet_.insert(v).second ) {
+                queue_.push_back(TraversalStep<T, W>{v, step_.vertex_, step_.depth_ + 1});
+            }
+        }
+        if( queue_.empty() ) {
+            done_ = true;
+            return;
+        }
+        step_ = queue_.front();
+        queue_.pop_front();
+    }
+
+    /**
+     * Follow the next link of the deepest vertex of the path leading to
+     * a vertex not reached yet, backtracking when there is none.
+     */
+    void nextDepthFirst() {
+        while( !stack_.empty() ) {
+            auto& top = stack_.back();
+            const auto& linkVectorPtr = top.first.vertex_->linkVectorPtr_;
+            while( top.second<linkVectorPtr.size() ) {
+                const Vertex<T, W>* v = linkVectorPtr[top.second++].lock().get();
+                if( visitedSet_.insert(v).second ) {
+                    step_ = TraversalStep<T, W>{v, top.first.vertex_, top.first.depth_ + 1};
+                    stack_.emplace_back(step_, 0);
+                    return;
+                }
+            }
+            stack_.pop_back();
+        }
+        done_ = true;
+    }
+
+
+protected:
+
+    /**
+     * The order of the traversal.
+     */
+    TraversalOrder
+    order_;
+
+    /**
+     * The current vertex.
+     */
+    TraversalStep<T, W>
+    step_;
+
+    /**
+     * Whether the traversal is over.
+     */
+    bool
+    done_;
+
+    /**
+     * Vertices reached and not returned yet, for a breadth-first traversal.
+     */
+    std::deque<TraversalStep<T, W>>
+    queue_;
+
+    /**
+     * Path from the start vertex, with the next link to follow of each
+     * vertex, for a depth-first traversal.
+     */
+    std::vector<std::pair<TraversalStep<T, W>, std::size_t>>
+    stack_;
+
+    /**
+     * Vertices reached.
+     */
+    std::unordered_set<const Vertex<T, W>*>
+    visitedSet_;
+
+};
+
+
+/**
+ * Lazy traversal of a graph from a vertex, to use in a range-based for
+ * loop, which may stop at any time:
+ * 
+ *   for(const auto& step : graphthewy::breadthFirst(g, "a")) { ... }
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct GraphTraversal {
+
+    /**
+     * Constructor
+     * 
+     * @param graph The graph, undirected or directed
+     * @param start The label of the start vertex, std::out_of_range is thrown if there is no such vertex
+     * @param order The order of the traversal
+     */
+    GraphTraversal(const UndirectedGraph<T, W>& graph, const T& start, TraversalOrder order)
+    : start_(graph.vertexPtrMap_.at(start).get()), order_(order) { }
+
+    /**
+     * @return an iterator on the start vertex
+     */
+    TraversalIterator<T, W> begin() const
+    { return TraversalIterator<T, W>(start_, order_); }
+
+    /**
+     * @return the end iterator
+     */
+    TraversalIterator<T, W> end() const
+    { return TraversalIterator<T, W>(); }
+
+
+protected:
+
+    /**
+     * The start vertex.
+     */
+    const Vertex<T, W>*
+    start_;
+
+    /**
+     * The order of the traversal.
+     */
+    TraversalOrder
+    order_;
+
+};
+
+/**
+ * Lazy breadth-first traversal.
+ * 
+ * @param graph The graph, undirected or directed
+ * @param start The label of the start vertex
+ * @return the traversal, to iterate over
+ */
+template<equality_comparable T, class W>
+GraphTraversal<T, W> breadthFirst(const UndirectedGraph<T, W>& graph, const std::common_type_t<T>& start)
+{ return GraphTraversal<T, W>(graph, start, TraversalOrder::BreadthFirst); }
+
+/**
+ * Lazy depth-first traversal, in preorder.
+ * 
+ * @param graph The graph, undirected or directed
+ * @param start The label of the start vertex
+ * @return the traversal, to iterate over
+ */
+template<equality_comparable T, class W>
+GraphTraversal<T, W> depthFirst(const UndirectedGraph<T, W>& graph, const std::common_type_t<T>& start)
+{ return GraphTraversal<T, W>(graph, start, TraversalOrder::DepthFirst); }
+
+
+#if __cplusplus >= 202002L
+
+/**
+ * Coroutine producing values one at a time, resumed by its iterator.
+ * 
+ * Template argument:
+ * - Y = the type of the values
+ */
+template<class Y>
+class Generator {
+
+public:
+
+    /**
+     * State of the coroutine, giving the address of the last value.
+     */
+    struct promise_type {
+
+        Generator get_return_object()
+        { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+        std::suspend_always initial_suspend() noexcept
+        { return {}; }
+
+        std::suspend_always final_suspend() noexcept
+        { return {}; }
+
+        std::suspend_always yield_value(const Y& value) noexcept {
+            value_ = std::addressof(value);
+            return {};
+        }
+
+        void return_void() noexcept { }
+
+        void unhandled_exception()
+        { exception_ = std::current_exception(); }
+
+        /**
+         * The last value, alive in the coroutine until it is resumed.
+         */
+        const Y*
+        value_ = nullptr;
+
+        /**
+         * The exception thrown by the coroutine, if any.
+         */
+        std::exception_ptr
+        exception_;
+
+    };
+
+    /**
+     * Input iterator resuming the coroutine.
+     */
+    class iterator {
+
+    public:
+
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Y;
+        using difference_type = std::ptrdiff_t;
+
+        explicit iterator(std::coroutine_handle<promise_type> handle) : handle_(handle) { }
+
+        const Y& operator*() const
+        { return *handle_.promise().value_; }
+
+        const Y* operator->() const
+        { return handle_.promise().value_; }
+
+        iterator& operator++() {
+            resume(handle_);
+            return *this;
+        }
+
+        void operator++(int)
+        { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const
+        { return handle_.done(); }
+
+    private:
+
+        std::coroutine_handle<promise_type> handle_;
+
+    };
+
+    Generator(Generator&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) { }
+
+    Generator(const Generator&) = delete;
+
+    Generator& operator=(const Generator&) = delete;
+
+    ~Generator() {
+        if( handle_ ) {
+            handle_.destroy();
+        }
+    }
+
+    /**
+     * Run the coroutine up to its first value.
+     * 
+     * @return the iterator on the first value
+     */
+    iterator begin() {
+        resume(handle_);
+        return iterator(handle_);
+    }
+
+    /**
+     * @return the end of the values
+     */
+    std::default_sentinel_t end() const
+    { return std::default_sentinel; }
+
+
+private:
+
+    explicit Generator(std::coroutine_handle<promise_type> handle) : handle_(handle) { }
+
+    /**
+     * Resume a coroutine up to its next value, throwing its exception if any.
+     * 
+     * @param handle The coroutine
+     */
+    static void resume(std::coroutine_handle<promise_type> handle) {
+        handle.resume();
+        if( handle.promise().exception_ ) {
+            std::rethrow_exception(std::exchange(handle.promise().exception_, nullptr));
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+
+};
+
+/**
+ * Lazy traversal as a C++20 coroutine, with the same order and memory
+ * as GraphTraversal. The graph must outlive the generator.
+ * 
+ * @param graph The graph, undirected or directed
+ * @param start The label of the start vertex
+ * @param order The order of the traversal
+ * @return the generator of the vertices reached
+ */
+template<equality_comparable T, class W>
+Generator<TraversalStep<T, W>> traverse(const UndirectedGraph<T, W>& graph, std::common_type_t<T> start, TraversalOrder order) {
+    for(const TraversalStep<T, W>& step : GraphTraversal<T, W>(graph, start, order)) {
+        co_yield step;
+    }
+}
+
+#endif
+
+}
+
+
+#endif // _GRAPH_MODEL_TRAVERSAL_HPP_
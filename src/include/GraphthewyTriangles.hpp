@@ -0,0 +1,245 @@
+/**
+ * Copyright (C) 2020, 2021 Alexis LE GOADEC.
+ * 
+ * This file is part of the Graphthewy project which is licensed under
+ * the European Union Public License v1.2.
+ * 
+ * If a copy of the EUPL v1.2 was not distributed with this software,
+ * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
+ */
+
+#ifndef _GRAPH_MODEL_TRIANGLES_HPP_
+#define _GRAPH_MODEL_TRIANGLES_HPP_
+
+#include "GraphthewySnapshot.hpp"
+#include "GraphthewyIntersection.hpp"
+#include "GraphthewyParallel.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+
+
+namespace graphthewy {
+
+/**
+ * Triangle counting and local clustering coefficients of an undirected
+ * snapshot, with sorted-list intersections. Self-loops and repeated
+ * links are ignored.
+ * 
+ * Template arguments:
+ * - T = the type of the vertex's label
+ * - W = the type of the edge weight, void (default) for an unweighted graph
+ */
+template<equality_comparable T, class W = void>
+struct GraphTriangles {
+
+    /**
+     * Constructor
+     * 
+     * @param snapshot The snapshot of an undirected graph
+     */
+    GraphTriangles(const GraphSnapshot<T, W>& snapshot)
+    : snapshot_(snapshot) {
+        if( snapshot_.isDirected() ) {
+            throw std::runtime_error("graphthewy: triangles need an undirected snapshot");
+        }
+    }
+
+    /**
+     * Number of triangles of the graph. Each link is oriented from its
+     * end of lower degree, so that a triangle is found once, by
+     * intersecting the out-lists of its two lowest vertices, and no
+     * out-list is longer than sqrt(2E).
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     * @return the number of triangles
+     */
+    std::size_t count(unsigned int threadCount = 0) const {
+        GRAPHTHEWY_STATS_TIMER(timer, "triangleCount");
+        GRAPHTHEWY_STATS_VISIT(timer, snapshot_.order(), snapshot_.arcCount());
+        const std::size_t n = snapshot_.order();
+        std::vector<std::size_t> degreeVector(n);
+        for(VertexId v=0; v<n; v++) {
+            degreeVector[v] = simpleDegree(v);
+        }
+        const auto before = [&](VertexId u, VertexId v) {
+            return degreeVector[u]<degreeVector[v] || (degreeVector[u]==degreeVector[v] && u<v);
+        };
+        std::vector<std::size_t> offsetVector(n + 1, 0);
+        std::vector<VertexId> targetVector;
+        for(VertexId u=0; u<n; u++) {
+            appendSimple(u, targetVector, [&](VertexId v) { return before(u, v); });
+            offsetVector[u + 1] = targetVector.size();
+        }
+        std::vector<std::size_t> countVector(threadCount==0 ? defaultThreadCount() : threadCount, 0);
+        parallelDynamic(n, threadCount, [&](unsigned int c, std::size_t u) {
+            for(std::size_t a=offsetVector[u]; a<offsetVector[u + 1]; a++) {
+                const VertexId v = targetVector[a];
+                countVector[c] += intersectionSize(
+                    targetVector.data() + offsetVector[u], offsetVector[u + 1] - offsetVector[u],
+                    targetVector.data() + offsetVector[v], offsetVector[v + 1] - offsetVector[v]);
+            }
+        });
+        std::size_t total = 0;
+        for(const std::size_t c : countVector) {
+            total += c;
+        }
+        return total;
+    }
+
+    /**
+     * Number of triangles through each vertex, half the sum over its
+     * neighbors of their common neighbors, needed by the clustering
+     * coefficients.
+     * 
+     * @param threadCount The number of threads, 0 for the hardware concurrency
+     */
+    void countByVertex(unsigned int threadCount = 0) {
+        GRAPHTHEWY_STATS_TIMER(timer, "triangleCountByVertex");
+        GRAPHTHEWY_STATS_VISIT(timer, snapshot_.order(), snapshot_.arcCount());
+        const std::size_t n = snapshot_.order();
+        std::vector<std::size_t> offsetVector(n + 1, 0);
+        std::vector<VertexId> targetVector;
+        for(VertexId u=0; u<n; u++) {
+            appendSimple(u, targetVector, [](VertexId) { return true; });
+            offsetVector[u + 1] = targetVector.size();
+        }
+        triangleVector_.assign(n, 0);
+        degreeVector_.assign(n, 0);
+        parallelDynamic(n, threadCount, [&](unsigned int, std::size_t u) {
+            std::size_t sum = 0;
+            for(std::size_t a=offsetVector[u]; a<offsetVector[u + 1]; a++) {
+                const VertexId v = targetVector[a];
+                sum += intersectionSize(
+                    targetVector.data() + offsetVector[u], offsetVector[u + 1] - offsetVector[u],
+                    targetVector.data() + offsetVector[v], offsetVector[v + 1] - offsetVector[v]);
+            }
+            triangleVector_[u] = sum / 2;
+            degreeVector_[u] = offsetVector[u + 1] - offsetVector[u];
+        });
+    }
+
+    /**
+     * Number of triangles through a vertex, after countByVertex().
+     * 
+     * @param label the vertex's label
+     * @return the number of triangles
+     */
+    std::size_t triangleCount(const T& label) const
+    { return triangleVector_[snapshot_.idOf(label)]; }
+
+    /**
+     * Local clustering coefficient of a vertex, after countByVertex():
+     * the fraction of the pairs of its neighbors that are linked.
+     * 
+     * @param label the vertex's label
+     * @return the coefficient, 0 for a vertex with less than 2 neighbors
+     */
+    double localClustering(const T& label) const
+    { return clustering(snapshot_.idOf(label)); }
+
+    /**
+     * Average of the local clustering coefficients, after countByVertex().
+     * 
+     * @return the average coefficient, 0 for an empty graph
+     */
+    double averageClustering() const {
+        if( triangleVector_.empty() ) {
+            return 0;
+        }
+        double sum = 0;
+        for(VertexId v=0; v<triangleVector_.size(); v++) {
+            sum += clustering(v);
+        }
+        return sum / static_cast<double>(triangleVector_.size());
+    }
+
+    /**
+     * Triangles through each vertex, by vertex identifier.
+     * 
+     * @return the vector of triangle counts
+     */
+    const std::vector<std::size_t>& triangleVector() const
+    { return triangleVector_; }
+
+
+protected:
+
+    /**
+     * Number of distinct neighbors of a vertex, itself excluded.
+     * 
+     * @param u the vertex identifier
+     * @return the degree in the simple graph
+     */
+    std::size_t simpleDegree(VertexId u) const {
+        std::size_t degree = 0;
+        const VertexId* previous = nullptr;
+        for(const VertexId& v : snapshot_.neighbors(u)) {
+            if( v!=u && (previous==nullptr || *previous!=v) ) {
+                degree++;
+            }
+            previous = &v;
+        }
+        return degree;
+    }
+
+    /**
+     * Append the distinct neighbors of a vertex, itself excluded, that
+     * satisfy a filter. They stay sorted.
+     * 
+     * @param u the vertex identifier
+     * @param targetVector The list to append to
+     * @param keep The filter
+     */
+    template<class F>
+    void appendSimple(VertexId u, std::vector<VertexId>& targetVector, F&& keep) const {
+        const std::size_t first = targetVector.size();
+        for(const VertexId v : snapshot_.neighbors(u)) {
+            if( v!=u && (targetVector.size()==first || targetVector.back()!=v) && keep(v) ) {
+                targetVector.push_back(v);
+            }
+        }
+    }
+
+    /**
+     * Local clustering coefficient of a vertex.
+     * 
+     * @param v the vertex identifier
+     * @return the coefficient
+     */
+    double clustering(VertexId v) const {
+        const std::size_t d = degreeVector_[v];
+        if( d<2 ) {
+            return 0;
+        }
+        return 2.0 * static_cast<double>(triangleVector_[v]) / (static_cast<double>(d) * static_cast<double>(d - 1));
+    }
+
+
+protected:
+
+    /**
+     * The snapshot of the graph.
+     */
+    const GraphSnapshot<T, W>&
+    snapshot_;
+
+    /**
+     * Triangles through each vertex, by vertex identifier.
+     */
+    std::vector<std::size_t>
+    triangleVector_;
+
+    /**
+     * Distinct neighbors of each vertex, by vertex identifier.
+     */
+    std::vector<std::size_t>
+    degreeVector_;
+
+};
+
+}
+
+
+#endif // _GRAPH_MODEL_TRIANGLES_HPP_
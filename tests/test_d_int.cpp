@@ -10,8 +10,29 @@
 
 #include "../src/include/GraphthewyModel.hpp"
 #include "../src/include/GraphthewyCycle.hpp"
+#include "../src/include/GraphthewyParser.hpp"
+#include "../src/include/GraphthewyShortestPath.hpp"
+#include "../src/include/GraphthewyComponents.hpp"
+#include "../src/include/GraphthewyReorder.hpp"
+#include "../src/include/GraphthewyCompressed.hpp"
+#include "../src/include/GraphthewyRank.hpp"
+#include "../src/include/GraphthewyDense.hpp"
+#include "../src/include/GraphthewyReachability.hpp"
+#include "../src/include/GraphthewyDelta.hpp"
+#include "../src/include/GraphthewySubgraph.hpp"
+#include "../src/include/GraphthewyGenerator.hpp"
+#include "../src/include/GraphthewyColoring.hpp"
+#include "../src/include/GraphthewyCores.hpp"
+#include "../src/include/GraphthewyFlow.hpp"
+#include "../src/include/GraphthewyTraversal.hpp"
+#include "../src/include/GraphthewyRandomWalk.hpp"
+#include "../src/include/GraphthewyCentrality.hpp"
 
+#include <algorithm>
+#include <random>
+#include <sstream>
 #include <string>
+#include <vector>
 #include <CppUTest/TestHarness.h>
 #include <CppUTest/CommandLineTestRunner.h>
 
@@ -138,6 +159,612 @@ TEST(Test_Directed_Int, graphCopy) {
     CHECK_TRUE(g.getVertex(4)==h.getVertex(4));
 }
 
+TEST(Test_Directed_Int, addEdgeList) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {2, 3}});
+    CHECK_TRUE(g.order() == 3);
+    CHECK_TRUE(g.size() == 2);
+    CHECK_TRUE(g.isLinked(1, 2) == true);
+    CHECK_TRUE(g.isLinked(2, 1) == false);
+}
+
+TEST(Test_Directed_Int, parseDimacs) {
+    std::istringstream in("c comment\np sp 3 3\na 1 2 7\na 2 3 1\na 3 1 4\n");
+    graphthewy::GraphParser<GRAPH_TEMPTYPE> parser(graphthewy::GraphFormat::Dimacs);
+    GRAPH_CREATE(g)
+    g.addEdgeList(parser.parse(in));
+    CHECK_TRUE(g.size() == 3);
+    CHECK_TRUE(g.isLinked(3, 1) == true);
+    GRAPH_CYCLE(gc, g)
+    CHECK_TRUE(gc.hasCycle() == true);
+
+    // A max flow file designates its source and sink with 'n' lines
+    GRAPH_CREATE(flow)
+    flow.addEdgeList(parser.parseString("p max 3 2\nn 1 s\nn 3 t\na 1 2 5\na 2 3 4\n"));
+    CHECK_TRUE(flow.size() == 2);
+    CHECK_TRUE(flow.isLinked(2, 3) == true);
+}
+
+TEST(Test_Directed_Int, parseMatrixMarket) {
+    std::istringstream in("%%MatrixMarket matrix coordinate pattern general\n% comment\n3 3 2\n1 2\n2 3\n");
+    graphthewy::GraphParser<GRAPH_TEMPTYPE> parser(graphthewy::GraphFormat::MatrixMarket);
+    GRAPH_CREATE(g)
+    g.addEdgeList(parser.parse(in));
+    CHECK_TRUE(g.order() == 3);
+    CHECK_TRUE(g.size() == 2);
+    GRAPH_CYCLE(gc, g)
+    CHECK_TRUE(gc.hasCycle() == false);
+
+    // Only the lower triangle of a symmetric matrix is stored
+    GRAPH_CREATE(h)
+    h.addEdgeList(parser.parseString("%%MatrixMarket matrix coordinate pattern symmetric\n3 3 3\n2 1\n3 2\n3 3\n"));
+    CHECK_TRUE(h.size() == 5);
+    CHECK_TRUE(h.isLinked(1, 2) == true);
+    CHECK_TRUE(h.isLinked(2, 1) == true);
+    CHECK_TRUE(h.isLinked(3, 3) == true);
+
+    graphthewy::GraphParser<GRAPH_TEMPTYPE, double> weighted(graphthewy::GraphFormat::MatrixMarket);
+    graphthewy::DirectedGraph<GRAPH_TEMPTYPE, double> k;
+    k.addEdgeList(weighted.parseString("%%MatrixMarket matrix coordinate real skew-symmetric\n2 2 1\n2 1 1.5\n"));
+    DOUBLES_EQUAL(1.5, k.getWeight(2, 1), 1e-12);
+    DOUBLES_EQUAL(-1.5, k.getWeight(1, 2), 1e-12);
+    CHECK_THROWS(std::runtime_error, parser.parseString("%%MatrixMarket matrix array real general\n2 2\n1\n0\n0\n1\n"));
+}
+
+
+TEST(Test_Directed_Int, deltaStepping) {
+    graphthewy::DirectedGraph<GRAPH_TEMPTYPE, unsigned int> g;
+    const int limit_node_cr = 2000;
+    std::vector<std::tuple<GRAPH_TEMPTYPE, GRAPH_TEMPTYPE, unsigned int>> edgeList;
+    for(int i=1; i<limit_node_cr; i++) {
+        edgeList.emplace_back(i - 1, i, 1 + (i * 7) % 13);
+        edgeList.emplace_back(i, (i * 31) % limit_node_cr, 1 + (i * 11) % 17);
+    }
+    g.addEdgeList(edgeList);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE, unsigned int> snapshot(g);
+    graphthewy::ShortestPath<GRAPH_TEMPTYPE, unsigned int> sp(snapshot), dp(snapshot);
+    sp.dijkstra(0);
+    dp.deltaStepping(0, 5, 4);
+    CHECK_TRUE(sp.distanceVector() == dp.distanceVector());
+    CHECK_TRUE(dp.path(1).size() == 2);
+}
+
+TEST(Test_Directed_Int, unweightedShortestPath) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {2, 3}, {3, 4}, {1, 4}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::ShortestPath<GRAPH_TEMPTYPE> sp(snapshot);
+    sp.deltaStepping(2);
+    CHECK_TRUE(sp.distance(4) == 2);
+    CHECK_TRUE(sp.isReachable(1) == false);
+}
+
+
+TEST(Test_Directed_Int, parseWeightedDimacs) {
+    graphthewy::GraphParser<GRAPH_TEMPTYPE, long> parser(graphthewy::GraphFormat::Dimacs);
+    graphthewy::DirectedGraph<GRAPH_TEMPTYPE, long> g;
+    g.addEdgeList(parser.parseString("p sp 3 3\na 1 2 7\na 2 3 1\na 1 3 9\n"));
+    CHECK_TRUE(g.getWeight(1, 2) == 7);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE, long> snapshot(g);
+    graphthewy::ShortestPath<GRAPH_TEMPTYPE, long> sp(snapshot);
+    sp.dijkstra(1);
+    CHECK_TRUE(sp.distance(3) == 8);
+}
+
+TEST(Test_Directed_Int, weakComponents) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {3, 2}, {4, 5}, {6, 4}, {6, 7}, {8, 7}});
+    g << 9;
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::GraphComponents<GRAPH_TEMPTYPE> gcs(snapshot), gca(snapshot);
+    gcs.unionFind();
+    gca.afforest(3);
+    CHECK_TRUE(gcs.componentCount() == 3);
+    CHECK_TRUE(gcs.isConnected(5, 8) == true);
+    CHECK_TRUE(gcs.isConnected(1, 9) == false);
+    CHECK_TRUE(gca.componentVector() == gcs.componentVector());
+
+    // The root of the sampled largest component has more out-arcs than the sample
+    GRAPH_CREATE(h)
+    for(GRAPH_TEMPTYPE v=0; v<=10; v++) {
+        h << v;
+    }
+    h.addEdgeList({{1, 2}, {1, 3}, {1, 5}, {2, 4}, {2, 10}, {0, 7}, {0, 8}, {9, 7}, {9, 8}, {9, 10}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> hSnapshot(h);
+    graphthewy::GraphComponents<GRAPH_TEMPTYPE> hcs(hSnapshot), hca(hSnapshot);
+    hcs.unionFind();
+    hca.afforest(1);
+    CHECK_TRUE(hcs.componentCount() == 2);
+    CHECK_TRUE(hca.isConnected(1, 5) == true);
+    CHECK_TRUE(hca.componentVector() == hcs.componentVector());
+}
+
+
+TEST(Test_Directed_Int, reorder) {
+    graphthewy::DirectedGraph<GRAPH_TEMPTYPE, int> g;
+    g.addEdgeList({{10, 20, 1}, {20, 30, 2}, {30, 10, 3}, {30, 40, 4}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE, int> snapshot(g);
+    graphthewy::GraphReorder<GRAPH_TEMPTYPE, int> reorder(snapshot);
+    const auto p = snapshot.permute(reorder.gorder(2));
+    const auto t = p.transpose();
+    CHECK_TRUE(t.neighbors(t.idOf(10)).size() == 1);
+    CHECK_TRUE(t.label(*t.neighbors(t.idOf(10)).begin()) == 30);
+    graphthewy::ShortestPath<GRAPH_TEMPTYPE, int> sp(p);
+    sp.dijkstra(10);
+    CHECK_TRUE(sp.distance(40) == 7);
+}
+
+
+TEST(Test_Directed_Int, compressed) {
+    GRAPH_CREATE(g)
+    for(int i=0; i<100; i++) {
+        g << i;
+    }
+    for(int i=0; i<99; i++) {
+        g.link(i, i + 1);
+        if( i%7==0 && i + 30<100 ) {
+            g.link(i, i + 30);
+        }
+    }
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::CompressedSnapshot<GRAPH_TEMPTYPE> compressed(snapshot, 3);
+    CHECK_TRUE(compressed.isDirected());
+    for(graphthewy::VertexId v=0; v<snapshot.order(); v++) {
+        const std::vector<graphthewy::VertexId> decoded(compressed.neighbors(v).begin(), compressed.neighbors(v).end());
+        CHECK_TRUE(decoded == std::vector<graphthewy::VertexId>(snapshot.neighbors(v).begin(), snapshot.neighbors(v).end()));
+    }
+    typedef graphthewy::AdjacencyCycle<graphthewy::CompressedSnapshot<GRAPH_TEMPTYPE>> Cycle;
+    CHECK_FALSE(Cycle(compressed).hasCycle());
+    g.link(99, 50);
+    CHECK_TRUE(Cycle(graphthewy::CompressedSnapshot<GRAPH_TEMPTYPE>(graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>(g))).hasCycle());
+    GRAPH_CYCLE(gc, g)
+    CHECK_TRUE(gc.hasCycle());
+}
+
+
+TEST(Test_Directed_Int, pageRank) {
+    GRAPH_CREATE(g)
+    g << 1 << 2 << 3 << 4 << 5;
+    g.link(1, 2); g.link(2, 3); g.link(3, 1);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> cycle(g);
+    graphthewy::GraphRank<GRAPH_TEMPTYPE> rank(cycle, 2);
+    rank.pageRank();
+    // 4 and 5 only receive the jumps, and their own mass spread to all
+    DOUBLES_EQUAL(0.15 / 3.3, rank.score(4), 1e-6);
+    DOUBLES_EQUAL(rank.score(1), rank.score(2), 1e-9);
+    double sum = 0;
+    for(const double s : rank.scoreVector()) {
+        sum += s;
+    }
+    DOUBLES_EQUAL(1.0, sum, 1e-9);
+
+    for(int i=6; i<300; i++) {
+        g << i;
+        g.link(i, i % 7 + 1);
+        g.link(i % 5 + 1, i);
+    }
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::GraphRank<GRAPH_TEMPTYPE> sequential(snapshot, 1), parallel(snapshot, 4);
+    sequential.pageRank();
+    parallel.pageRank();
+    for(std::size_t v=0; v<snapshot.order(); v++) {
+        DOUBLES_EQUAL(sequential.scoreVector()[v], parallel.scoreVector()[v], 1e-12);
+    }
+    CHECK_TRUE(sequential.iterationCount() < 100);
+
+    parallel.personalizedPageRank({1});
+    CHECK_TRUE(parallel.score(1) > parallel.score(2));
+    CHECK_TRUE(parallel.score(1) > parallel.score(6));
+}
+
+TEST(Test_Directed_Int, katz) {
+    GRAPH_CREATE(g)
+    g << 1 << 2 << 3;
+    g.link(1, 2);
+    g.link(2, 3);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::GraphRank<GRAPH_TEMPTYPE, void, float> rank(snapshot);
+    rank.katz(0.5f, 1.0f);
+    DOUBLES_EQUAL(1.0, rank.score(1), 1e-6);
+    DOUBLES_EQUAL(1.5, rank.score(2), 1e-6);
+    DOUBLES_EQUAL(1.75, rank.score(3), 1e-6);
+    CHECK_TRUE(rank.iterationCount() == 3);
+
+    // A hub with enough in-links for the gathered sums and their tail
+    GRAPH_CREATE(star)
+    star << 0;
+    for(int i=1; i<=37; i++) {
+        star << i;
+        star.link(i, 0);
+    }
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> starSnapshot(star);
+    graphthewy::GraphRank<GRAPH_TEMPTYPE> hub(starSnapshot, 3);
+    graphthewy::GraphRank<GRAPH_TEMPTYPE, void, float> hubFloat(starSnapshot, 3);
+    hub.katz(0.1, 1.0);
+    hubFloat.katz(0.1f, 1.0f);
+    DOUBLES_EQUAL(4.7, hub.score(0), 1e-12);
+    DOUBLES_EQUAL(4.7, hubFloat.score(0), 1e-5);
+    DOUBLES_EQUAL(1.0, hub.score(37), 1e-12);
+}
+
+
+TEST(Test_Directed_Int, denseBitGraph) {
+    GRAPH_CREATE(g)
+    for(int i=0; i<150; i++) {
+        g << i;
+    }
+    for(int i=0; i<149; i++) {
+        g.link(i, i + 1);
+    }
+    g.link(3, 100);
+    graphthewy::DenseBitGraph<GRAPH_TEMPTYPE> dense(g);
+    CHECK_TRUE(dense.isLinked(3, 100));
+    CHECK_FALSE(dense.isLinked(100, 3));
+    CHECK_FALSE(dense.isLinked(3, 1000));
+    CHECK_TRUE(dense.degree(dense.idOf(3)) == 2);
+    const std::vector<graphthewy::VertexId> neighbors(dense.neighbors(dense.idOf(3)).begin(), dense.neighbors(dense.idOf(3)).end());
+    CHECK_TRUE(neighbors == std::vector<graphthewy::VertexId>({dense.idOf(4), dense.idOf(100)}));
+    CHECK_FALSE(dense.hasCycle());
+    const auto closure = dense.transitiveClosure(4);
+    CHECK_TRUE(closure.isLinked(0, 149));
+    CHECK_TRUE(closure.isLinked(70, 149));
+    CHECK_FALSE(closure.isLinked(149, 0));
+    CHECK_FALSE(closure.isLinked(5, 5));
+    CHECK_TRUE(closure.degree(closure.idOf(0)) == 149);
+
+    g.link(149, 50);
+    graphthewy::DenseBitGraph<GRAPH_TEMPTYPE> cyclic(g);
+    CHECK_TRUE(cyclic.hasCycle());
+    const auto cyclicClosure = cyclic.transitiveClosure();
+    CHECK_TRUE(cyclicClosure.isLinked(60, 60));
+    CHECK_TRUE(cyclicClosure.isLinked(149, 55));
+    CHECK_FALSE(cyclicClosure.isLinked(49, 49));
+}
+
+
+TEST(Test_Directed_Int, transitiveReduction) {
+    GRAPH_CREATE(g)
+    g << 1 << 2 << 3 << 4 << 5 << 6 << 7;
+    // 1 -> 2 -> 3 -> 4 with a shortcut 1 -> 4, and a cycle 5 -> 6 -> 7 -> 5 after 4
+    g.link(1, 2); g.link(2, 3); g.link(3, 4); g.link(1, 4); g.link(1, 3);
+    g.link(4, 5); g.link(5, 6); g.link(6, 7); g.link(7, 5); g.link(6, 5); g.link(3, 6);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::GraphReachability<GRAPH_TEMPTYPE> reachability(snapshot);
+    CHECK_TRUE(reachability.componentCount() == 5);
+    CHECK_TRUE(reachability.ancestors(4) == std::vector<GRAPH_TEMPTYPE>({1, 2, 3}));
+    CHECK_TRUE(reachability.descendants(6) == std::vector<GRAPH_TEMPTYPE>({5, 6, 7}));
+
+    const auto reduction = reachability.transitiveReduction(2);
+    CHECK_TRUE(reduction.order() == 7);
+    CHECK_TRUE(reduction.isLinked(1, 2));
+    CHECK_FALSE(reduction.isLinked(1, 3));
+    CHECK_FALSE(reduction.isLinked(1, 4));
+    CHECK_FALSE(reduction.isLinked(3, 6));
+    CHECK_TRUE(reduction.isLinked(4, 5));
+    CHECK_TRUE(reduction.isLinked(5, 6) && reduction.isLinked(6, 7) && reduction.isLinked(7, 5));
+    CHECK_TRUE(reduction.size() == 7);
+
+    const auto closure = reachability.transitiveClosure(3);
+    CHECK_TRUE(closure.isLinked(1, 7));
+    CHECK_TRUE(closure.isLinked(6, 6));
+    CHECK_FALSE(closure.isLinked(1, 1));
+    CHECK_FALSE(closure.isLinked(5, 4));
+    CHECK_TRUE(closure.size() == 6 + 5 + 4 + 3 + 3 * 3);
+}
+
+TEST(Test_Directed_Int, transitiveClosure_slices) {
+    GRAPH_CREATE(g)
+    const int n = 700;
+    for(int i=0; i<n; i++) {
+        g << i;
+    }
+    std::mt19937 rng(3);
+    for(int i=0; i<2000; i++) {
+        const int u = rng() % n, v = rng() % n;
+        if( u<v ) {
+            g.link(u, v);
+        }
+    }
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::GraphReachability<GRAPH_TEMPTYPE> reachability(snapshot);
+    const auto closure = reachability.transitiveClosure(4);
+    const auto reduction = reachability.transitiveReduction(4);
+    const graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> reduced(reduction);
+    graphthewy::GraphReachability<GRAPH_TEMPTYPE> reducedReachability(reduced);
+    std::size_t total = 0;
+    for(int v=0; v<n; v += 7) {
+        const auto descendants = reachability.descendants(v);
+        total += descendants.size();
+        CHECK_TRUE(reducedReachability.descendants(v) == descendants);
+        for(const int d : descendants) {
+            CHECK_TRUE(closure.isLinked(v, d));
+        }
+    }
+    CHECK_TRUE(total > 0);
+    CHECK_TRUE(reduction.size() < g.size());
+}
+
+
+TEST(Test_Directed_Int, edgePolicy) {
+    graphthewy::DirectedGraph<GRAPH_TEMPTYPE> g(graphthewy::EdgePolicy::NoParallelEdges);
+    g << 1 << 2;
+    CHECK_TRUE(g.link(1, 2) == true);
+    CHECK_TRUE(g.link(1, 2) == false);
+    CHECK_TRUE(g.link(2, 1) == true);
+    CHECK_TRUE(g.link(2, 2) == true);
+    g.addEdgeList({{2, 2}, {2, 3}, {2, 3}});
+    CHECK_TRUE(g.size() == 4);
+    CHECK_TRUE(g.isLinked(2, 3) == true);
+    CHECK_TRUE(g.isLinked(3, 2) == false);
+}
+
+TEST(Test_Directed_Int, deduplicate) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {1, 3}, {1, 2}, {3, 3}, {3, 3}, {2, 1}});
+    CHECK_TRUE(g.size() == 6);
+    g.deduplicate();
+    CHECK_TRUE(g.size() == 4);
+    CHECK_TRUE(g.getEdgePairList()[1] == std::make_pair(1, 3));
+    g.setEdgePolicy(graphthewy::EdgePolicy::Simple, 1);
+    CHECK_TRUE(g.size() == 3);
+    CHECK_TRUE(g.link(1, 3) == false);
+
+    // Back to a multigraph, the repeated arcs are kept
+    GRAPH_CREATE(h)
+    h.addEdgeList({{1, 2}, {1, 2}, {2, 3}});
+    h.setEdgePolicy(graphthewy::EdgePolicy::Multigraph);
+    CHECK_TRUE(h.size() == 3);
+    h.setEdgePolicy(graphthewy::EdgePolicy::NoParallelEdges);
+    CHECK_TRUE(h.size() == 2);
+    h.setEdgePolicy(graphthewy::EdgePolicy::Multigraph);
+    CHECK_TRUE(h.link(2, 3) == true);
+    CHECK_TRUE(h.link(2, 3) == true);
+    CHECK_TRUE(h.size() == 4);
+}
+
+
+TEST(Test_Directed_Int, graphDelta) {
+    graphthewy::DirectedGraph<GRAPH_TEMPTYPE> g(graphthewy::EdgePolicy::NoParallelEdges);
+    g.addEdgeList({{1, 2}, {2, 3}, {3, 1}, {3, 3}, {4, 3}});
+    auto before = g.getEdgePairList();
+
+    graphthewy::GraphDelta<GRAPH_TEMPTYPE> delta;
+    delta.removeVertex(3);
+    delta.link(1, 2);
+    delta.link(2, 1);
+    delta.unlink(1, 2);
+    graphthewy::GraphDelta<GRAPH_TEMPTYPE> inverse = delta.apply(g, 1);
+    CHECK_TRUE(g.order() == 3);
+    CHECK_TRUE(g.size() == 2);
+    CHECK_TRUE(g.isLinked(1, 2) == true);
+    CHECK_TRUE(g.isLinked(2, 1) == true);
+    CHECK_TRUE(inverse.size() == 8);
+
+    inverse.apply(g);
+    auto after = g.getEdgePairList();
+    std::sort(before.begin(), before.end());
+    std::sort(after.begin(), after.end());
+    CHECK_TRUE(before == after);
+    CHECK_TRUE(g.link(3, 3) == false);
+}
+
+TEST(Test_Directed_Int, removeVertex) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {2, 3}, {3, 2}, {2, 2}});
+    CHECK_TRUE(g.unlink(2, 3) == true);
+    CHECK_TRUE(g.unlink(2, 3) == false);
+    CHECK_TRUE(g.removeVertex(2) == true);
+    CHECK_TRUE(g.removeVertex(2) == false);
+    CHECK_TRUE(g.order() == 2);
+    CHECK_TRUE(g.size() == 0);
+}
+
+
+TEST(Test_Directed_Int, subgraphView) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {2, 3}, {3, 1}, {3, 4}, {4, 5}, {5, 4}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::SubgraphView<GRAPH_TEMPTYPE> view(snapshot, {1, 2, 3, 4});
+    CHECK_TRUE(view.vertexCount() == 4);
+    CHECK_TRUE(graphthewy::AdjacencyCycle<decltype(view)>(view).hasCycle() == true);
+    CHECK_TRUE(view.degree(snapshot.idOf(3)) == 2);
+    CHECK_TRUE(view.degree(snapshot.idOf(4)) == 0);
+
+    view.filterVertices([](int label) { return label!=2; });
+    CHECK_TRUE(graphthewy::AdjacencyCycle<decltype(view)>(view).hasCycle() == false);
+
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> s = view.snapshot(2);
+    CHECK_TRUE(s.order() == 3);
+    CHECK_TRUE(s.arcCount() == 2);
+    CHECK_TRUE(s.label(s.neighbors(s.idOf(3)).begin()[1]) == 4);
+
+    graphthewy::DirectedGraph<GRAPH_TEMPTYPE> h = view.toGraph<graphthewy::DirectedGraph>();
+    CHECK_TRUE(h.order() == 3);
+    CHECK_TRUE(h.isLinked(3, 1) == true);
+    CHECK_TRUE(h.isLinked(1, 2) == false);
+    GRAPH_CYCLE(gc, h)
+    CHECK_TRUE(gc.hasCycle() == false);
+    CHECK_THROWS(std::runtime_error, view.toGraph<graphthewy::UndirectedGraph>());
+}
+
+
+TEST(Test_Directed_Int, hopPath) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {2, 3}, {3, 4}, {4, 1}, {1, 5}, {5, 4}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::HopPath<GRAPH_TEMPTYPE> hop(snapshot);
+    CHECK_TRUE(hop.path(1, 4) == std::vector<GRAPH_TEMPTYPE>({1, 5, 4}));
+    CHECK_TRUE(hop.path(4, 3) == std::vector<GRAPH_TEMPTYPE>({4, 1, 2, 3}));
+    CHECK_TRUE(hop.distance(5, 2) == 3);
+    g.addVertex(6);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> s2(g);
+    graphthewy::HopPath<GRAPH_TEMPTYPE> hop2(s2);
+    CHECK_TRUE(hop2.path(6, 1).empty());
+    CHECK_TRUE(hop2.path(1, 6).empty());
+}
+
+
+TEST(Test_Directed_Int, generators) {
+    graphthewy::GraphGenerator<GRAPH_TEMPTYPE> generator(7);
+    const auto rmat = generator.rmat(10, 8000);
+    CHECK_TRUE(rmat == graphthewy::GraphGenerator<GRAPH_TEMPTYPE>(7, 1).rmat(10, 8000));
+    std::size_t low = 0;
+    for(const auto& e : rmat) {
+        CHECK_TRUE(e.first >= 0 && e.first < 1024 && e.second >= 0 && e.second < 1024);
+        low += e.first < 512 ? 1 : 0;
+    }
+    // The top half of the matrix gets a + b = 76% of the edges
+    CHECK_TRUE(low > 5600 && low < 6600);
+
+    GRAPH_CREATE(dag)
+    dag.addEdgeList(generator.randomDag(500, 2000));
+    GRAPH_CYCLE(gcDag, dag)
+    CHECK_FALSE(gcDag.hasCycle());
+
+    const auto cyclic = generator.randomDag(500, 2000, 1, 4);
+    CHECK_TRUE(cyclic.size() == 2004);
+    CHECK_TRUE(cyclic.back().second < cyclic.back().first);
+    GRAPH_CREATE(g)
+    g.addEdgeList(cyclic);
+    GRAPH_CYCLE(gc, g)
+    CHECK_TRUE(gc.hasCycle());
+
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    const auto direct = graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>::fromEdgeList(cyclic, true);
+    CHECK_TRUE(direct.isDirected());
+    CHECK_TRUE(direct.labelVector_ == snapshot.labelVector_);
+    CHECK_TRUE(direct.offsetVector_ == snapshot.offsetVector_);
+    CHECK_TRUE(direct.targetVector_ == snapshot.targetVector_);
+}
+
+
+TEST(Test_Directed_Int, coloringNeedsUndirected) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    CHECK_THROWS(std::runtime_error, graphthewy::GraphColoring<GRAPH_TEMPTYPE>{snapshot});
+}
+
+
+TEST(Test_Directed_Int, degrees) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {1, 3}, {1, 4}, {2, 3}, {4, 3}, {3, 3}});
+    CHECK_TRUE(g.degree(1) == 3);
+    CHECK_TRUE(g.degree(3) == 1);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::GraphDegrees<GRAPH_TEMPTYPE> degrees(snapshot, 3);
+    CHECK_TRUE(degrees.outDegree(1) == 3);
+    CHECK_TRUE(degrees.inDegree(1) == 0);
+    CHECK_TRUE(degrees.inDegree(3) == 4);
+    CHECK_TRUE(degrees.outHistogram().countVector_ == std::vector<std::size_t>({0, 3, 0, 1}));
+    CHECK_TRUE(degrees.inHistogram().countVector_ == std::vector<std::size_t>({1, 2, 0, 0, 1}));
+    DOUBLES_EQUAL(1.5, degrees.inHistogram().averageDegree(), 1e-9);
+    CHECK_TRUE(degrees.inHistogram().count(2) == 0);
+    CHECK_TRUE(degrees.inHistogram().count(9) == 0);
+    CHECK_THROWS(std::runtime_error, graphthewy::GraphCores<GRAPH_TEMPTYPE>{snapshot});
+}
+
+
+TEST(Test_Directed_Int, maxFlow) {
+    // The classic network of CLRS, of maximum flow 23
+    graphthewy::DirectedGraph<GRAPH_TEMPTYPE, int> g;
+    g.addEdgeList({{0, 1, 16}, {0, 2, 13}, {1, 3, 12}, {2, 1, 4}, {2, 4, 14}, {3, 2, 9}, {3, 5, 20}, {4, 3, 7}, {4, 5, 4}});
+    g.addVertex(6);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE, int> snapshot(g);
+    graphthewy::MaxFlow<GRAPH_TEMPTYPE, int> mf(snapshot);
+    CHECK_TRUE(mf.maxFlow(0, 5) == 23);
+    CHECK_TRUE(mf.sourceSide() == std::vector<GRAPH_TEMPTYPE>({0, 1, 2, 4}));
+    CHECK_TRUE(mf.isSourceSide(4));
+    CHECK_FALSE(mf.isSourceSide(3));
+    int cut = 0;
+    for(const auto& e : mf.cutEdgePairList()) {
+        cut += g.getWeight(e.first, e.second);
+    }
+    CHECK_TRUE(cut == 23);
+    // Conservation at every inner vertex
+    for(graphthewy::VertexId v=0; v<snapshot.order(); v++) {
+        if( snapshot.label(v) == 0 || snapshot.label(v) == 5 ) {
+            continue;
+        }
+        int balance = 0;
+        for(graphthewy::VertexId u=0; u<snapshot.order(); u++) {
+            for(std::size_t a=snapshot.offsetVector_[u]; a<snapshot.offsetVector_[u + 1]; a++) {
+                balance += snapshot.targetVector_[a] == v ? mf.arcFlow(a) : 0;
+                balance -= u == v ? mf.arcFlow(a) : 0;
+            }
+        }
+        CHECK_TRUE(balance == 0);
+    }
+    CHECK_TRUE(mf.maxFlow(5, 0) == 0);
+    CHECK_TRUE(mf.sourceSide() == std::vector<GRAPH_TEMPTYPE>({5}));
+    CHECK_TRUE(mf.maxFlow(0, 6) == 0);
+    CHECK_TRUE(mf.maxFlow(2, 3) == 11);
+
+    // Unweighted: the number of arc-disjoint paths
+    GRAPH_CREATE(u)
+    u.addEdgeList({{1, 2}, {1, 3}, {1, 4}, {2, 5}, {3, 5}, {4, 3}, {5, 6}, {3, 6}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> us(u);
+    graphthewy::MaxFlow<GRAPH_TEMPTYPE> uf(us);
+    CHECK_TRUE(uf.maxFlow(1, 6) == 2);
+    CHECK_TRUE(uf.maxFlow(1, 5) == 2);
+}
+
+
+TEST(Test_Directed_Int, lazyTraversal) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {2, 3}, {3, 1}, {4, 1}, {3, 5}});
+    std::vector<GRAPH_TEMPTYPE> labels;
+    for(const auto& step : graphthewy::breadthFirst(g, 2)) {
+        labels.push_back(step.label());
+    }
+    CHECK_TRUE(labels == std::vector<GRAPH_TEMPTYPE>({2, 3, 1, 5}));
+    labels.clear();
+    for(const auto& step : graphthewy::depthFirst(g, 4)) {
+        labels.push_back(step.label());
+    }
+    CHECK_TRUE(labels == std::vector<GRAPH_TEMPTYPE>({4, 1, 2, 3, 5}));
+}
+
+
+TEST(Test_Directed_Int, randomWalks) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {2, 3}, {3, 4}, {2, 5}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::RandomWalker<GRAPH_TEMPTYPE> walker(snapshot);
+    walker.setBias(1.0, 0.5);
+    const std::vector<graphthewy::VertexId> walks = walker.walk(3, 5);
+    for(std::size_t w=0; w<walker.walkCount(3); w++) {
+        const graphthewy::VertexId* row = walks.data() + w * 5;
+        std::size_t s = 1;
+        for(; s<5 && row[s]!=graphthewy::RandomWalker<GRAPH_TEMPTYPE>::noVertex; s++) {
+            const auto range = snapshot.neighbors(row[s - 1]);
+            CHECK_TRUE(std::find(range.begin(), range.end(), row[s]) != range.end());
+        }
+        // Stopped at a vertex without any arc
+        CHECK_TRUE(s == 5 || snapshot.degree(row[s - 1]) == 0);
+        for(; s<5; s++) {
+            CHECK_TRUE(row[s] == graphthewy::RandomWalker<GRAPH_TEMPTYPE>::noVertex);
+        }
+    }
+}
+
+
+TEST(Test_Directed_Int, centrality) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {2, 3}, {1, 4}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::GraphCentrality<GRAPH_TEMPTYPE> centrality(snapshot);
+    centrality.betweenness();
+    CHECK_TRUE(centrality.scoreVector() == std::vector<double>({0, 1, 0, 0}));
+    centrality.closeness();
+    DOUBLES_EQUAL(0.75, centrality.score(1), 1e-12);
+    DOUBLES_EQUAL(1.0 / 3.0, centrality.score(2), 1e-12);
+    DOUBLES_EQUAL(0.0, centrality.score(3), 1e-12);
+    centrality.harmonic();
+    DOUBLES_EQUAL(2.5, centrality.score(1), 1e-12);
+}
+
+
 int main(int argc, char** arvg)
 {
    return CommandLineTestRunner::RunAllTests(argc, arvg);
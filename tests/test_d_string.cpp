@@ -10,8 +10,15 @@
 
 #include "../src/include/GraphthewyModel.hpp"
 #include "../src/include/GraphthewyCycle.hpp"
+#include "../src/include/GraphthewyJournal.hpp"
+#include "../src/include/GraphthewySnapshot.hpp"
+#include "../src/include/GraphthewyRandomWalk.hpp"
 
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <string>
+#include <vector>
 #include <CppUTest/TestHarness.h>
 #include <CppUTest/CommandLineTestRunner.h>
 
@@ -114,6 +121,54 @@ TEST(Test_Directed_String, graphCopy) {
 }
 
 
+TEST(Test_Directed_String, journal) {
+    // Journal, checkpoint and checkpoint .tmp files, all removed at the end
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "graphthewy_journal_d_string";
+    std::filesystem::remove_all(directory);
+    GRAPH_CREATE(g)
+    {
+        graphthewy::GraphJournal<graphthewy::DirectedGraph, GRAPH_TEMPTYPE> journal(g, directory.string(), 64, 3);
+        journal.recover();
+        journal.addVertex("a");
+        journal.addVertex(std::string(40, 'b'));
+        journal.link("a", std::string(40, 'b'));
+        journal.addVertex("c");
+        journal.link("c", "a");
+    }
+    GRAPH_CREATE(h)
+    {
+        graphthewy::GraphJournal<graphthewy::DirectedGraph, GRAPH_TEMPTYPE> journal(h, directory.string());
+        CHECK_TRUE(journal.recover() == 2);
+    }
+    std::filesystem::remove_all(directory);
+    CHECK_TRUE(std::filesystem::exists(directory) == false);
+    CHECK_TRUE(h.order() == 3);
+    CHECK_TRUE(h.isLinked("a", std::string(40, 'b')) == true);
+    CHECK_TRUE(h.isLinked("c", "a") == true);
+    CHECK_TRUE(h.isLinked("a", "c") == false);
+}
+
+
+TEST(Test_Directed_String, randomWalksFile) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{"a", "b"}, {"b", "c"}, {"c", "a"}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::RandomWalker<GRAPH_TEMPTYPE> walker(snapshot, 3);
+    CHECK_TRUE(walker.writeWalks("walks_d_string.txt", 2, 4) == 6);
+    std::ifstream in("walks_d_string.txt");
+    std::vector<std::string> lines;
+    for(std::string line; std::getline(in, line); ) {
+        lines.push_back(line);
+    }
+    in.close();
+    std::remove("walks_d_string.txt");
+    CHECK_TRUE(lines.size() == 6);
+    CHECK_TRUE(lines[0] == "a b c a");
+    CHECK_TRUE(lines[4] == "b c a b");
+    CHECK_THROWS(std::runtime_error, walker.writeWalks("no_such_directory/walks.txt", 1, 4));
+}
+
+
 int main(int argc, char** arvg)
 {
    return CommandLineTestRunner::RunAllTests(argc, arvg);
@@ -8,9 +8,13 @@
  * you can obtain one at : https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12
  */
 
+// This test program runs with the instrumentation counters enabled
+#define GRAPHTHEWY_STATS
+
 #include "../src/include/GraphthewyModel.hpp"
 #include "../src/include/GraphthewyCycle.hpp"
 
+#include <cstdint>
 #include <string>
 #include <CppUTest/TestHarness.h>
 #include <CppUTest/CommandLineTestRunner.h>
@@ -139,6 +143,35 @@ TEST(Test_Directed_ULLINT, graphCopy) {
 }
 
 
+TEST(Test_Directed_ULLINT, stats) {
+    graphthewy::resetStats();
+    const std::int64_t bytesBefore = graphthewy::stats().bytesInUse_;
+    {
+        GRAPH_CREATE(g)
+        g << 1 << 2 << 3;
+        g.link(1, 2);
+        g.link(1, 3);
+        CHECK_TRUE(g.isLinked(1, 3));
+        CHECK_FALSE(g.isLinked(3, 1));
+        GRAPH_CYCLE(gc, g)
+        CHECK_FALSE(gc.hasCycle());
+        const graphthewy::GraphStats stats = graphthewy::stats();
+        CHECK_TRUE(stats.enabled_);
+        CHECK_TRUE(stats.linkCount_ == 2);
+        CHECK_TRUE(stats.linkLookupCount_ == 2);
+        CHECK_TRUE(stats.containsCount_ == 2);
+        // 2 links scanned to find 3 in the list of 1, none in the list of 3
+        CHECK_TRUE(stats.containsScanCount_ == 2);
+        CHECK_TRUE(stats.allocationCount_ >= 3);
+        CHECK_TRUE(stats.bytesInUse_ > bytesBefore);
+        CHECK_TRUE(stats.algorithmMap_.at("hasCycle").callCount_ == 1);
+        CHECK_TRUE(stats.algorithmMap_.at("hasCycle").edgeCount_ == 2);
+        CHECK_TRUE(stats.toJson().find("\"hasCycle\": {\"calls\": 1") != std::string::npos);
+    }
+    CHECK_TRUE(graphthewy::stats().bytesInUse_ == bytesBefore);
+}
+
+
 int main(int argc, char** arvg)
 {
    return CommandLineTestRunner::RunAllTests(argc, arvg);
@@ -10,8 +10,37 @@
 
 #include "../src/include/GraphthewyModel.hpp"
 #include "../src/include/GraphthewyCycle.hpp"
+#include "../src/include/GraphthewyParser.hpp"
+#include "../src/include/GraphthewyShortestPath.hpp"
+#include "../src/include/GraphthewyComponents.hpp"
+#include "../src/include/GraphthewyReorder.hpp"
+#include "../src/include/GraphthewyCompressed.hpp"
+#include "../src/include/GraphthewyIntersection.hpp"
+#include "../src/include/GraphthewyTriangles.hpp"
+#include "../src/include/GraphthewyDense.hpp"
+#include "../src/include/GraphthewyDelta.hpp"
+#include "../src/include/GraphthewyJournal.hpp"
+#include "../src/include/GraphthewySubgraph.hpp"
+#include "../src/include/GraphthewyGenerator.hpp"
+#include "../src/include/GraphthewyColoring.hpp"
+#include "../src/include/GraphthewyCores.hpp"
+#include "../src/include/GraphthewySpanningTree.hpp"
+#include "../src/include/GraphthewyFlow.hpp"
+#include "../src/include/GraphthewyTraversal.hpp"
+#include "../src/include/GraphthewyExecutor.hpp"
+#include "../src/include/GraphthewyRandomWalk.hpp"
+#include "../src/include/GraphthewyCentrality.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <sstream>
 #include <string>
+#include <vector>
 #include <CppUTest/TestHarness.h>
 #include <CppUTest/CommandLineTestRunner.h>
 
@@ -140,6 +169,842 @@ TEST(Test_UnDirected_Int, graphCopy) {
 }
 
 
+TEST(Test_UnDirected_Int, addEdgeList) {
+    GRAPH_CREATE(g)
+    g.addVertex(1);
+    g.addEdgeList({{1, 2}, {2, 3}, {3, 4}});
+    CHECK_TRUE(g.order() == 4);
+    CHECK_TRUE(g.size() == 3);
+    CHECK_TRUE(g.isLinked(2, 1) == true);
+    CHECK_TRUE(g.isLinked(4, 3) == true);
+}
+
+TEST(Test_UnDirected_Int, parseEdgeList) {
+    std::istringstream in("# comment\n1 2\n2\t3\n\n3 1\n");
+    graphthewy::GraphParser<GRAPH_TEMPTYPE> parser(graphthewy::GraphFormat::Snap, 1, 64);
+    GRAPH_CREATE(g)
+    g.addEdgeList(parser.parse(in));
+    CHECK_TRUE(g.order() == 3);
+    CHECK_TRUE(g.size() == 3);
+    GRAPH_CYCLE(gc, g)
+    CHECK_TRUE(gc.hasCycle() == true);
+}
+
+TEST(Test_UnDirected_Int, parseEdgeList_parallel) {
+    std::string text;
+    const int limit_node_cr = 20000;
+    for(int i=1; i<limit_node_cr; i++) {
+        text += std::to_string(i - 1) + " " + std::to_string(i) + "\n";
+    }
+    graphthewy::GraphParser<GRAPH_TEMPTYPE> parser(graphthewy::GraphFormat::EdgeList, 4);
+    const auto edgePairList = parser.parseString(text);
+    CHECK_TRUE(edgePairList.size() == limit_node_cr - 1);
+    CHECK_TRUE(edgePairList[1234] == std::make_pair(1234, 1235));
+    CHECK_TRUE(edgePairList.back() == std::make_pair(limit_node_cr - 2, limit_node_cr - 1));
+
+    // A malformed line parsed by another thread than the calling one
+    const std::size_t middle = text.find('\n', text.size() * 3 / 4) + 1;
+    text.insert(middle, "12 x\n");
+    CHECK_THROWS(std::runtime_error, parser.parseString(text));
+    CHECK_THROWS(std::runtime_error, graphthewy::parallelDynamic(1000, 4, [](unsigned int, std::size_t i) {
+        if( i==777 ) {
+            throw std::runtime_error("graphthewy: test");
+        }
+    }));
+}
+
+
+TEST(Test_UnDirected_Int, weighted) {
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE, double> g{1, 2, 3};
+    g.link(1, 2, 2.5);
+    g.link(2, 3);
+    CHECK_TRUE(g.getWeight(2, 1) == 2.5);
+    CHECK_TRUE(g.getWeight(3, 2) == 1.0);
+
+    decltype(g) h(g);
+    CHECK_TRUE(h.size() == 2);
+    CHECK_TRUE(h.getWeight(1, 2) == 2.5);
+
+    graphthewy::GraphCycle<graphthewy::UndirectedGraph, GRAPH_TEMPTYPE, double> gc(h);
+    CHECK_TRUE(gc.hasCycle() == false);
+}
+
+TEST(Test_UnDirected_Int, dijkstra) {
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE, int> g;
+    g.addEdgeList({{1, 2, 7}, {1, 3, 9}, {1, 6, 14}, {2, 3, 10}, {2, 4, 15}, {3, 4, 11}, {3, 6, 2}, {4, 5, 6}, {5, 6, 9}});
+    g << 7;
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE, int> snapshot(g);
+    graphthewy::ShortestPath<GRAPH_TEMPTYPE, int> sp(snapshot);
+    sp.dijkstra(1);
+    CHECK_TRUE(sp.distance(5) == 20);
+    CHECK_TRUE(sp.path(5) == std::vector<GRAPH_TEMPTYPE>({1, 3, 6, 5}));
+    CHECK_TRUE(sp.isReachable(7) == false);
+    CHECK_TRUE(sp.path(7).empty());
+}
+
+
+TEST(Test_UnDirected_Int, components) {
+    GRAPH_CREATE(g)
+    const int limit_node_cr = 10000;
+    for(int i=0; i<limit_node_cr; i++) {
+        g.addVertex(i);
+    }
+    for(int i=1; i<limit_node_cr; i++) {
+        if( i % 100 != 0 ) {
+            g.link(i - 1, i);
+        }
+    }
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::GraphComponents<GRAPH_TEMPTYPE> gcs(snapshot), gca(snapshot);
+    gcs.unionFind();
+    gca.afforest(4);
+    CHECK_TRUE(gcs.componentCount() == 100);
+    CHECK_TRUE(gcs.componentSizeVector()[42] == 100);
+    CHECK_TRUE(gcs.isConnected(1234, 1299) == true);
+    CHECK_TRUE(gcs.isConnected(1234, 1300) == false);
+    CHECK_TRUE(gca.componentVector() == gcs.componentVector());
+    CHECK_TRUE(gca.componentSizeVector() == gcs.componentSizeVector());
+}
+
+TEST(Test_UnDirected_Int, cycle_loop) {
+    GRAPH_CREATE(g)
+    g << 1 << 2 << 3;
+    g.link(1, 2);
+    g.link(3, 3);
+    GRAPH_CYCLE(gc, g)
+    CHECK_TRUE(gc.hasCycle() == true);
+
+    GRAPH_CREATE(h)
+    h << 1 << 2 << 3;
+    h.link(1, 2);
+    h.link(2, 3);
+    h.link(2, 3);
+    GRAPH_CYCLE(hc, h)
+    CHECK_TRUE(hc.hasCycle() == true);
+}
+
+
+TEST(Test_UnDirected_Int, reorder) {
+    GRAPH_CREATE(g)
+    const int side = 40;
+    // Grid with shuffled labels
+    std::vector<int> shuffled(side * side);
+    std::iota(shuffled.begin(), shuffled.end(), 0);
+    std::mt19937 rng(42);
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+    const auto label = [&](int r, int c) { return shuffled[r * side + c]; };
+    for(int r=0; r<side; r++) {
+        for(int c=0; c<side; c++) {
+            g << label(r, c);
+            if( r>0 ) { g << label(r - 1, c); g.link(label(r, c), label(r - 1, c)); }
+            if( c>0 ) { g << label(r, c - 1); g.link(label(r, c), label(r, c - 1)); }
+        }
+    }
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::GraphReorder<GRAPH_TEMPTYPE> reorder(snapshot);
+    typedef graphthewy::GraphReorder<GRAPH_TEMPTYPE> Reorder;
+    for(const auto& permutation : {reorder.degreeSort(), reorder.reverseCuthillMcKee(), reorder.gorder()}) {
+        const auto p = snapshot.permute(permutation);
+        CHECK_TRUE(p.order() == snapshot.order());
+        CHECK_TRUE(p.arcCount() == snapshot.arcCount());
+        CHECK_TRUE(p.label(p.idOf(label(3, 4))) == label(3, 4));
+        const auto u = p.idOf(label(3, 4));
+        CHECK_TRUE(std::find(p.neighbors(u).begin(), p.neighbors(u).end(), p.idOf(label(3, 5))) != p.neighbors(u).end());
+    }
+    const double before = Reorder::averageGap(snapshot);
+    CHECK_TRUE(Reorder::averageGap(snapshot.permute(reorder.reverseCuthillMcKee())) < before / 4);
+    CHECK_TRUE(Reorder::averageGap(snapshot.permute(reorder.gorder())) < before / 2);
+}
+
+
+TEST(Test_UnDirected_Int, compressed) {
+    GRAPH_CREATE(g)
+    const int side = 30;
+    for(int r=0; r<side; r++) {
+        for(int c=0; c<side; c++) {
+            g << r * side + c;
+            if( r>0 ) { g.link(r * side + c, (r - 1) * side + c); }
+            if( c>0 ) { g.link(r * side + c, r * side + c - 1); }
+        }
+    }
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    for(unsigned int threadCount : {1u, 4u}) {
+        graphthewy::CompressedSnapshot<GRAPH_TEMPTYPE> compressed(snapshot, threadCount);
+        CHECK_TRUE(compressed.order() == snapshot.order());
+        CHECK_TRUE(compressed.arcCount() == snapshot.arcCount());
+        for(graphthewy::VertexId v=0; v<snapshot.order(); v++) {
+            CHECK_TRUE(compressed.degree(v) == snapshot.degree(v));
+            const std::vector<graphthewy::VertexId> decoded(compressed.neighbors(v).begin(), compressed.neighbors(v).end());
+            CHECK_TRUE(decoded == std::vector<graphthewy::VertexId>(snapshot.neighbors(v).begin(), snapshot.neighbors(v).end()));
+        }
+        CHECK_TRUE(compressed.label(compressed.idOf(42)) == 42);
+        CHECK_TRUE(compressed.bytesPerArc() < 4);
+        CHECK_TRUE(graphthewy::AdjacencyCycle<graphthewy::CompressedSnapshot<GRAPH_TEMPTYPE>>(compressed).hasCycle());
+    }
+    GRAPH_CREATE(tree)
+    tree << 1 << 2 << 3 << 4;
+    tree.link(1, 2);
+    tree.link(1, 3);
+    tree.link(3, 4);
+    const graphthewy::CompressedSnapshot<GRAPH_TEMPTYPE> compressedTree{graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>(tree)};
+    CHECK_FALSE(graphthewy::AdjacencyCycle<graphthewy::CompressedSnapshot<GRAPH_TEMPTYPE>>(compressedTree).hasCycle());
+}
+
+
+TEST(Test_UnDirected_Int, intersection) {
+    std::mt19937 rng(7);
+    for(int round=0; round<50; round++) {
+        std::vector<graphthewy::VertexId> a, b;
+        for(graphthewy::VertexId v=0; v<1000; v++) {
+            if( rng() % 3==0 ) { a.push_back(v); }
+            if( rng() % (round % 2==0 ? 2 : 90)==0 ) { b.push_back(v); }
+        }
+        std::vector<graphthewy::VertexId> common;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(common));
+        for(const auto level : {graphthewy::SimdLevel::Scalar, graphthewy::SimdLevel::Sse4, graphthewy::SimdLevel::Avx2}) {
+            if( level<=graphthewy::simdLevel() ) {
+                CHECK_TRUE(graphthewy::intersectionSize(a.data(), a.size(), b.data(), b.size(), level) == common.size());
+            }
+        }
+        CHECK_TRUE(graphthewy::intersectionSizeGalloping(b.data(), b.size(), a.data(), a.size()) == common.size());
+    }
+}
+
+TEST(Test_UnDirected_Int, triangles) {
+    GRAPH_CREATE(g)
+    std::mt19937 rng(11);
+    const int n = 200;
+    for(int i=0; i<n; i++) {
+        g << i;
+    }
+    std::vector<std::vector<bool>> linked(n, std::vector<bool>(n, false));
+    for(int i=0; i<3000; i++) {
+        const int u = rng() % n, v = rng() % n;
+        g.link(u, v);
+        linked[u][v] = linked[v][u] = true;
+    }
+    std::size_t expected = 0;
+    for(int u=0; u<n; u++) {
+        for(int v=u + 1; v<n; v++) {
+            for(int w=v + 1; w<n; w++) {
+                expected += linked[u][v] && linked[v][w] && linked[u][w];
+            }
+        }
+    }
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::GraphTriangles<GRAPH_TEMPTYPE> triangles(snapshot);
+    CHECK_TRUE(triangles.count(1) == expected);
+    CHECK_TRUE(triangles.count(4) == expected);
+    triangles.countByVertex(3);
+    std::size_t sum = 0;
+    for(const std::size_t t : triangles.triangleVector()) {
+        sum += t;
+    }
+    CHECK_TRUE(sum == 3 * expected);
+
+    GRAPH_CREATE(k)
+    k << 1 << 2 << 3 << 4 << 5;
+    k.link(1, 2); k.link(1, 3); k.link(2, 3); k.link(3, 4); k.link(4, 4);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> ks(k);
+    graphthewy::GraphTriangles<GRAPH_TEMPTYPE> kt(ks);
+    CHECK_TRUE(kt.count() == 1);
+    kt.countByVertex();
+    CHECK_TRUE(kt.triangleCount(3) == 1);
+    DOUBLES_EQUAL(1.0, kt.localClustering(1), 1e-9);
+    DOUBLES_EQUAL(1.0 / 3, kt.localClustering(3), 1e-9);
+    DOUBLES_EQUAL(0.0, kt.localClustering(4), 1e-9);
+    DOUBLES_EQUAL((1.0 + 1.0 + 1.0 / 3) / 5, kt.averageClustering(), 1e-9);
+}
+
+
+TEST(Test_UnDirected_Int, denseBitGraph) {
+    GRAPH_CREATE(g)
+    g << 1 << 2 << 3 << 4 << 5;
+    g.link(1, 2);
+    g.link(2, 3);
+    g.link(4, 5);
+    graphthewy::DenseBitGraph<GRAPH_TEMPTYPE> dense(g);
+    CHECK_TRUE(dense.isLinked(2, 1));
+    CHECK_FALSE(dense.isLinked(1, 3));
+    CHECK_FALSE(dense.hasCycle());
+    CHECK_TRUE(dense.transitiveClosure().isLinked(1, 3));
+    CHECK_FALSE(dense.transitiveClosure().isLinked(1, 4));
+    g.link(3, 1);
+    CHECK_TRUE(graphthewy::DenseBitGraph<GRAPH_TEMPTYPE>(g).hasCycle());
+}
+
+
+TEST(Test_UnDirected_Int, statsDisabled) {
+    GRAPH_CREATE(g)
+    g << 1 << 2;
+    g.link(1, 2);
+    CHECK_TRUE(g.isLinked(1, 2));
+    const graphthewy::GraphStats stats = graphthewy::stats();
+    CHECK_FALSE(stats.enabled_);
+    CHECK_TRUE(stats.linkCount_ == 0);
+    CHECK_TRUE(stats.toJson().find("\"enabled\": false") != std::string::npos);
+}
+
+
+TEST(Test_UnDirected_Int, memoryUsage) {
+    GRAPH_CREATE(g)
+    for(int i=1; i<=6; i++) {
+        g.addVertex(i);
+    }
+    for(int i=2; i<=6; i++) {
+        g.link(1, i);
+    }
+    graphthewy::MemoryUsage usage = g.memoryUsage();
+    CHECK_TRUE(usage.registry_ > 0);
+    CHECK_TRUE(usage.vertices_ > 0);
+    CHECK_TRUE(usage.labels_ == 0);
+    CHECK_TRUE(usage.slack_ > 0);
+    CHECK_TRUE(usage.total() == usage.registry_ + usage.vertices_ + usage.adjacency_);
+    g.shrinkToFit();
+    usage = g.memoryUsage();
+    CHECK_TRUE(usage.slack_ == 0);
+    CHECK_TRUE(usage.adjacency_ == 10 * sizeof(std::weak_ptr<graphthewy::Vertex<int>>));
+    CHECK_TRUE(g.isLinked(1, 6) == true);
+}
+
+
+TEST(Test_UnDirected_Int, edgePolicy) {
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE> g(graphthewy::EdgePolicy::Simple);
+    g << 1 << 2 << 3;
+    CHECK_TRUE(g.link(1, 2) == true);
+    CHECK_TRUE(g.link(2, 1) == false);
+    CHECK_TRUE(g.link(3, 3) == false);
+    g.addEdgeList({{1, 2}, {2, 3}, {3, 2}, {4, 4}});
+    CHECK_TRUE(g.size() == 2);
+    CHECK_TRUE(g.isLinked(3, 2) == true);
+    CHECK_TRUE(g.isLinked(1, 3) == false);
+
+    decltype(g) h(g);
+    CHECK_TRUE(h.edgePolicy() == graphthewy::EdgePolicy::Simple);
+    CHECK_TRUE(h.link(1, 2) == false);
+    CHECK_TRUE(h.link(1, 3) == true);
+}
+
+TEST(Test_UnDirected_Int, deduplicate) {
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE, int> g;
+    g << 1 << 2 << 3;
+    g.link(1, 2, 5);
+    g.link(2, 3);
+    g.link(2, 1, 7);
+    g.link(3, 3);
+    g.link(3, 3);
+    CHECK_TRUE(g.size() == 5);
+    g.deduplicate(2);
+    CHECK_TRUE(g.size() == 3);
+    CHECK_TRUE(g.getWeight(2, 1) == 5);
+    CHECK_TRUE(g.isLinked(3, 3) == true);
+    g.setEdgePolicy(graphthewy::EdgePolicy::Simple);
+    CHECK_TRUE(g.size() == 2);
+    CHECK_TRUE(g.isLinked(3, 3) == false);
+    CHECK_TRUE(g.link(1, 2, 9) == false);
+    CHECK_TRUE(g.getWeight(1, 2) == 5);
+}
+
+
+TEST(Test_UnDirected_Int, graphDelta) {
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE, int> g;
+    g.addEdgeList({{1, 2, 3}, {2, 3, 4}, {3, 3, 5}, {3, 4, 6}, {1, 2, 7}});
+    auto before = g.getEdgePairList();
+    std::sort(before.begin(), before.end());
+
+    graphthewy::GraphDelta<GRAPH_TEMPTYPE, int> delta;
+    delta.link(1, 5, 8);
+    delta.unlink(2, 1);
+    delta.removeVertex(3);
+    delta.addVertex(6);
+    delta.link(4, 4);
+    delta.unlink(1, 4);
+    CHECK_TRUE(delta.size() == 6);
+    graphthewy::GraphDelta<GRAPH_TEMPTYPE, int> inverse = delta.apply(g, 2);
+
+    CHECK_TRUE(g.order() == 5);
+    CHECK_TRUE(g.contains(3) == false);
+    CHECK_TRUE(g.getWeight(2, 1) == 7);
+    CHECK_TRUE(g.getWeight(5, 1) == 8);
+    CHECK_TRUE(g.isLinked(4, 4) == true);
+    CHECK_TRUE(g.size() == 3);
+
+    inverse.apply(g);
+    auto after = g.getEdgePairList();
+    std::sort(after.begin(), after.end());
+    CHECK_TRUE(g.order() == 4);
+    CHECK_TRUE(before == after);
+    CHECK_TRUE(g.getWeight(3, 3) == 5);
+    CHECK_TRUE(g.getWeight(4, 3) == 6);
+
+    CHECK_TRUE(g.unlink(3, 3) == true);
+    CHECK_TRUE(g.removeVertex(3) == true);
+    CHECK_TRUE(g.size() == 2);
+    CHECK_TRUE(g.isLinked(2, 1) == true);
+}
+
+
+TEST(Test_UnDirected_Int, journal) {
+    // Journal, checkpoint and checkpoint .tmp files, all removed at the end
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "graphthewy_journal_int";
+    std::filesystem::remove_all(directory);
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE, double> g;
+    {
+        graphthewy::GraphJournal<graphthewy::UndirectedGraph, GRAPH_TEMPTYPE, double> journal(g, directory.string(), 4);
+        CHECK_TRUE(journal.recover() == 0);
+        journal.addVertex(1);
+        journal.addVertex(2);
+        journal.link(1, 2, 0.5);
+        journal.checkpoint();
+        graphthewy::GraphDelta<GRAPH_TEMPTYPE, double> delta;
+        delta.link(2, 3, 1.5);
+        delta.link(3, 3);
+        journal.apply(delta);
+        journal.unlink(1, 2);
+        journal.link(1, 3);
+        CHECK_TRUE(journal.sequence() == 6);
+    }
+    {
+        std::ofstream torn(directory / "journal", std::ios::binary | std::ios::app);
+        torn << "torn";
+    }
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE, double> h;
+    {
+        graphthewy::GraphJournal<graphthewy::UndirectedGraph, GRAPH_TEMPTYPE, double> journal(h, directory.string());
+        CHECK_TRUE(journal.recover() == 3);
+        CHECK_TRUE(journal.sequence() == 6);
+        CHECK_TRUE(h.getEdgePairList() == g.getEdgePairList());
+        CHECK_TRUE(h.getWeight(3, 2) == 1.5);
+        CHECK_TRUE(h.isLinked(1, 2) == false);
+        journal.removeVertex(3);
+        journal.commit();
+        CHECK_TRUE(h.size() == 0);
+    }
+    std::filesystem::remove_all(directory);
+    CHECK_TRUE(std::filesystem::exists(directory) == false);
+}
+
+
+TEST(Test_UnDirected_Int, subgraphView) {
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE, int> g;
+    g.addEdgeList({{1, 2, 1}, {2, 3, 1}, {3, 1, 9}, {3, 4, 1}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE, int> snapshot(g);
+    graphthewy::SubgraphView<GRAPH_TEMPTYPE, int> view(snapshot);
+    CHECK_TRUE(graphthewy::hasUndirectedCycle(view) == true);
+    view.filterArcs([&](graphthewy::VertexId, graphthewy::VertexId, std::size_t arc) {
+        return snapshot.weight(arc) < 5;
+    });
+    CHECK_TRUE(graphthewy::hasUndirectedCycle(view) == false);
+    CHECK_TRUE(view.snapshot().arcCount() == 6);
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE, int> h = view.toGraph<graphthewy::UndirectedGraph>();
+    CHECK_TRUE(h.size() == 3);
+    CHECK_TRUE(h.isLinked(1, 3) == false);
+    CHECK_TRUE(h.getWeight(4, 3) == 1);
+}
+
+
+TEST(Test_UnDirected_Int, hopPath) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {2, 3}, {3, 4}, {4, 5}, {1, 6}, {6, 5}, {7, 8}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::HopPath<GRAPH_TEMPTYPE> hop(snapshot);
+    CHECK_TRUE(hop.path(1, 5) == std::vector<GRAPH_TEMPTYPE>({1, 6, 5}));
+    CHECK_TRUE(hop.distance(2, 5) == 3);
+    CHECK_TRUE(hop.path(3, 3) == std::vector<GRAPH_TEMPTYPE>({3}));
+    CHECK_TRUE(hop.path(1, 8).empty());
+    CHECK_TRUE(hop.distance(8, 7) == 1);
+    CHECK_TRUE(hop.visitedCount() == 3);
+}
+
+
+TEST(Test_UnDirected_Int, generators) {
+    graphthewy::GraphGenerator<GRAPH_TEMPTYPE> generator(42, 4);
+    const auto edgeList = generator.erdosRenyi(1000, 5000);
+    CHECK_TRUE(edgeList.size() == 5000);
+    CHECK_TRUE(edgeList == graphthewy::GraphGenerator<GRAPH_TEMPTYPE>(42, 1).erdosRenyi(1000, 5000));
+    CHECK_FALSE(edgeList == graphthewy::GraphGenerator<GRAPH_TEMPTYPE>(43, 4).erdosRenyi(1000, 5000));
+    for(const auto& e : edgeList) {
+        CHECK_TRUE(e.first != e.second && e.first >= 0 && e.first < 1000 && e.second >= 0 && e.second < 1000);
+    }
+
+    const auto ba = generator.barabasiAlbert(2000, 3);
+    CHECK_TRUE(ba.size() == 6000);
+    CHECK_TRUE(ba == graphthewy::GraphGenerator<GRAPH_TEMPTYPE>(42, 3).barabasiAlbert(2000, 3));
+    std::vector<std::size_t> degree(2000, 0);
+    for(const auto& e : ba) {
+        CHECK_TRUE(e.second <= e.first);
+        degree[e.first]++;
+        degree[e.second]++;
+    }
+    // Preferential attachment: the first vertices become hubs
+    CHECK_TRUE(*std::max_element(degree.begin(), degree.begin() + 10) > 50);
+
+    const auto grid = generator.grid(3, 4);
+    CHECK_TRUE(grid.size() == 17);
+    GRAPH_CREATE(g)
+    g.addEdgeList(grid);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    const auto direct = graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>::fromEdgeList(grid, false, 2);
+    CHECK_FALSE(direct.isDirected());
+    CHECK_TRUE(direct.labelVector_ == snapshot.labelVector_);
+    CHECK_TRUE(direct.offsetVector_ == snapshot.offsetVector_);
+    CHECK_TRUE(direct.targetVector_ == snapshot.targetVector_);
+    CHECK_TRUE(direct.degree(direct.idOf(5)) == 4);
+    CHECK_TRUE(direct.degree(direct.idOf(11)) == 2);
+
+    const std::vector<std::tuple<GRAPH_TEMPTYPE, GRAPH_TEMPTYPE, int>> weighted = {{1, 2, 5}, {2, 1, 3}, {2, 3, 7}, {3, 3, 1}};
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE, int> wg;
+    wg.addEdgeList(weighted);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE, int> ws(wg);
+    const auto wd = graphthewy::GraphSnapshot<GRAPH_TEMPTYPE, int>::fromEdgeList(weighted, false);
+    CHECK_TRUE(wd.targetVector_ == ws.targetVector_);
+    CHECK_TRUE(wd.weightVector_ == ws.weightVector_);
+}
+
+
+TEST(Test_UnDirected_Int, coloring) {
+    GRAPH_CREATE(g)
+    // A 5-cycle needs 3 colors, and is not bipartite
+    g.addEdgeList({{1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 1}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> cycle(g);
+    graphthewy::GraphColoring<GRAPH_TEMPTYPE> cc(cycle);
+    CHECK_TRUE(cc.greedy() == 3);
+    CHECK_TRUE(cc.isProper());
+    CHECK_FALSE(cc.isBipartite());
+
+    const auto grid = graphthewy::GraphGenerator<GRAPH_TEMPTYPE>(1).grid(20, 30);
+    const auto gs = graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>::fromEdgeList(grid, false);
+    graphthewy::GraphColoring<GRAPH_TEMPTYPE> gc(gs);
+    CHECK_TRUE(gc.isBipartite());
+    CHECK_TRUE(gc.colorCount() == 2);
+    CHECK_TRUE(gc.isProper());
+    CHECK_TRUE(gc.color(0) != gc.color(1) && gc.color(0) == gc.color(31));
+    // A grid is 2-degenerate
+    CHECK_TRUE(gc.greedy(graphthewy::ColoringOrder::SmallestLast) <= 3);
+
+    const auto random = graphthewy::GraphGenerator<GRAPH_TEMPTYPE>(5).erdosRenyi(3000, 30000);
+    const auto rs = graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>::fromEdgeList(random, false);
+    graphthewy::GraphColoring<GRAPH_TEMPTYPE> rc(rs);
+    const std::size_t natural = rc.greedy(graphthewy::ColoringOrder::Natural);
+    CHECK_TRUE(rc.isProper());
+    CHECK_TRUE(rc.greedy(graphthewy::ColoringOrder::LargestFirst) <= natural + 2);
+    CHECK_TRUE(rc.isProper());
+    const std::size_t smallestLast = rc.greedy();
+    CHECK_TRUE(rc.isProper());
+    CHECK_TRUE(smallestLast <= natural);
+    CHECK_TRUE(rc.speculative(4) <= natural + 2);
+    CHECK_TRUE(rc.isProper());
+    CHECK_TRUE(rc.roundCount() >= 1);
+    CHECK_TRUE(rc.speculative(1) == natural);
+    CHECK_TRUE(rc.roundCount() == 1);
+    CHECK_FALSE(rc.isBipartite());
+}
+
+
+TEST(Test_UnDirected_Int, cores) {
+    GRAPH_CREATE(g)
+    // A 4-clique, a triangle hanging from it, and a tail
+    g.addEdgeList({{1, 2}, {1, 3}, {1, 4}, {2, 3}, {2, 4}, {3, 4}, {4, 5}, {5, 6}, {6, 4}, {6, 7}, {7, 7}});
+    CHECK_TRUE(g.degree(4) == 5);
+    CHECK_TRUE(g.degree(7) == 3);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::GraphCores<GRAPH_TEMPTYPE> cores(snapshot);
+    CHECK_TRUE(cores.decompose() == 3);
+    CHECK_TRUE(cores.coreNumber(1) == 3 && cores.coreNumber(4) == 3);
+    CHECK_TRUE(cores.coreNumber(5) == 2 && cores.coreNumber(6) == 2);
+    CHECK_TRUE(cores.coreNumber(7) == 1);
+    CHECK_TRUE(cores.core(2) == std::vector<GRAPH_TEMPTYPE>({1, 2, 3, 4, 5, 6}));
+    const auto sequential = cores.coreVector();
+    CHECK_TRUE(cores.decomposeParallel(3) == 3);
+    CHECK_TRUE(cores.coreVector() == sequential);
+
+    const auto ba = graphthewy::GraphGenerator<GRAPH_TEMPTYPE>(3).barabasiAlbert(5000, 4);
+    const auto bs = graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>::fromEdgeList(ba, false);
+    graphthewy::GraphCores<GRAPH_TEMPTYPE> bc(bs);
+    const std::size_t k = bc.decompose();
+    CHECK_TRUE(k >= 4);
+    const auto expected = bc.coreVector();
+    // Each vertex has at most k neighbors later in the degeneracy order
+    std::vector<std::size_t> rank(bs.order());
+    for(std::size_t i=0; i<bc.orderVector().size(); i++) {
+        rank[bc.orderVector()[i]] = i;
+    }
+    for(graphthewy::VertexId v=0; v<bs.order(); v++) {
+        std::size_t later = 0;
+        for(const graphthewy::VertexId u : bs.neighbors(v)) {
+            later += u != v && rank[u] > rank[v] ? 1 : 0;
+        }
+        CHECK_TRUE(later <= k);
+    }
+    CHECK_TRUE(bc.decomposeParallel(4) == k);
+    CHECK_TRUE(bc.coreVector() == expected);
+
+    graphthewy::GraphDegrees<GRAPH_TEMPTYPE> degrees(snapshot, 2);
+    CHECK_TRUE(degrees.outHistogram().countVector_ == std::vector<std::size_t>({0, 0, 1, 5, 0, 1}));
+    CHECK_TRUE(degrees.inHistogram().countVector_ == degrees.outHistogram().countVector_);
+    CHECK_TRUE(degrees.inDegree(4) == 5);
+    CHECK_TRUE(degrees.outHistogram().maxDegree() == 5);
+}
+
+
+TEST(Test_UnDirected_Int, spanningForest) {
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE, int> g;
+    g.addEdgeList({{1, 2, 4}, {1, 3, 1}, {2, 3, 2}, {2, 4, 5}, {3, 4, 8}, {4, 4, 0}, {4, 5, 3}, {6, 7, 9}, {6, 7, 2}});
+    g.addVertex(8);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE, int> snapshot(g);
+    graphthewy::SpanningForest<GRAPH_TEMPTYPE, int> forest(snapshot);
+    CHECK_TRUE(forest.kruskal(2) == 13);
+    CHECK_TRUE(forest.edgeCount() == 5);
+    auto edges = forest.edgePairList();
+    std::sort(edges.begin(), edges.end());
+    const std::vector<std::pair<GRAPH_TEMPTYPE, GRAPH_TEMPTYPE>> expectedEdges = {{1, 3}, {2, 3}, {2, 4}, {4, 5}, {6, 7}};
+    CHECK_TRUE(edges == expectedEdges);
+    CHECK_TRUE(forest.boruvka(2) == 13);
+    CHECK_TRUE(forest.edgeCount() == 5);
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE, int> tree;
+    tree.addEdgeList(forest.edgeList());
+    CHECK_TRUE(tree.getWeight(6, 7) == 2);
+    graphthewy::GraphCycle<graphthewy::UndirectedGraph, GRAPH_TEMPTYPE, int> gc(tree);
+    CHECK_FALSE(gc.hasCycle());
+
+    // Many equal weights, so that the ties are exercised
+    const auto random = graphthewy::GraphGenerator<GRAPH_TEMPTYPE>(9).erdosRenyi(2000, 12000);
+    std::vector<std::tuple<GRAPH_TEMPTYPE, GRAPH_TEMPTYPE, int>> weighted;
+    for(std::size_t i=0; i<random.size(); i++) {
+        weighted.emplace_back(random[i].first, random[i].second, static_cast<int>(graphthewy::counterBelow(9, i, 7, 20)));
+    }
+    const auto rs = graphthewy::GraphSnapshot<GRAPH_TEMPTYPE, int>::fromEdgeList(weighted, false);
+    graphthewy::SpanningForest<GRAPH_TEMPTYPE, int> rf(rs);
+    const int kruskal = rf.kruskal(4);
+    const std::size_t count = rf.edgeCount();
+    CHECK_TRUE(rf.boruvka(4) == kruskal);
+    CHECK_TRUE(rf.edgeCount() == count);
+    graphthewy::GraphComponents<GRAPH_TEMPTYPE, int> components(rs);
+    components.unionFind();
+    CHECK_TRUE(count == rs.order() - components.componentCount());
+
+    std::vector<std::uint64_t> values(100000);
+    for(std::size_t i=0; i<values.size(); i++) {
+        values[i] = graphthewy::counterRandom(1, i) % 1000;
+    }
+    std::vector<std::uint64_t> expected = values;
+    std::sort(expected.begin(), expected.end());
+    graphthewy::parallelSort(values.begin(), values.end(), std::less<std::uint64_t>(), 3);
+    CHECK_TRUE(values == expected);
+}
+
+
+TEST(Test_UnDirected_Int, maxFlow) {
+    // Two squares sharing vertex 3: one vertex cut, but two link-disjoint paths
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {2, 3}, {1, 4}, {4, 3}, {3, 5}, {5, 6}, {3, 7}, {7, 6}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::MaxFlow<GRAPH_TEMPTYPE> mf(snapshot);
+    CHECK_TRUE(mf.maxFlow(1, 6) == 2);
+    CHECK_TRUE(mf.maxFlow(6, 1) == 2);
+    CHECK_TRUE(mf.maxFlow(2, 4) == 2);
+    CHECK_TRUE(mf.sourceSide() == std::vector<GRAPH_TEMPTYPE>({2}));
+    CHECK_TRUE(mf.cutEdgePairList().size() == 2);
+}
+
+
+TEST(Test_UnDirected_Int, lazyTraversal) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {1, 3}, {2, 4}, {3, 4}, {4, 5}, {6, 7}});
+    std::vector<GRAPH_TEMPTYPE> labels;
+    std::vector<std::size_t> depths;
+    for(const auto& step : graphthewy::breadthFirst(g, 1)) {
+        labels.push_back(step.label());
+        depths.push_back(step.depth_);
+    }
+    CHECK_TRUE(labels == std::vector<GRAPH_TEMPTYPE>({1, 2, 3, 4, 5}));
+    CHECK_TRUE(depths == std::vector<std::size_t>({0, 1, 1, 2, 3}));
+
+    labels.clear();
+    for(const auto& step : graphthewy::depthFirst(g, 1)) {
+        labels.push_back(step.label());
+        if( step.label() == 4 ) {
+            CHECK_TRUE(step.parent_->label_ == 2);
+        }
+    }
+    CHECK_TRUE(labels == std::vector<GRAPH_TEMPTYPE>({1, 2, 4, 3, 5}));
+
+    // Stopping early leaves the rest of a long chain untouched
+    GRAPH_CREATE(chain)
+    std::vector<std::pair<GRAPH_TEMPTYPE, GRAPH_TEMPTYPE>> chainList;
+    for(GRAPH_TEMPTYPE i=0; i<10000; i++) {
+        chainList.emplace_back(i, i + 1);
+    }
+    chain.addEdgeList(chainList);
+    auto traversal = graphthewy::breadthFirst(chain, 0);
+    auto it = traversal.begin();
+    for(int i=0; i<10; i++) {
+        ++it;
+    }
+    CHECK_TRUE(it->label() == 10);
+    CHECK_TRUE(it.reachedCount() == 11);
+    CHECK_TRUE(it != traversal.end());
+    CHECK_THROWS(std::out_of_range, graphthewy::depthFirst(g, 42));
+
+#if __cplusplus >= 202002L
+    labels.clear();
+    for(const auto& step : graphthewy::traverse(g, 1, graphthewy::TraversalOrder::DepthFirst)) {
+        labels.push_back(step.label());
+    }
+    CHECK_TRUE(labels == std::vector<GRAPH_TEMPTYPE>({1, 2, 4, 3, 5}));
+    std::size_t count = 0;
+    for(const auto& step : graphthewy::traverse(chain, 5000, graphthewy::TraversalOrder::BreadthFirst)) {
+        count++;
+        if( step.depth_ == 3 ) {
+            break;
+        }
+    }
+    CHECK_TRUE(count == 6);
+#endif
+}
+
+
+TEST(Test_UnDirected_Int, queryExecutor) {
+    GRAPH_CREATE(g)
+    std::vector<std::pair<GRAPH_TEMPTYPE, GRAPH_TEMPTYPE>> ring;
+    for(GRAPH_TEMPTYPE i=0; i<100; i++) {
+        ring.emplace_back(i, (i + 1) % 100);
+    }
+    g.addEdgeList(ring);
+    auto snapshot = std::make_shared<const graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>>(g);
+    graphthewy::QueryExecutor<GRAPH_TEMPTYPE> executor(snapshot, 3);
+    CHECK_TRUE(executor.threadCount() == 3);
+
+    auto hops = executor.submit([](const graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>& s) {
+        return graphthewy::HopPath<GRAPH_TEMPTYPE>(s).path(0, 30).size();
+    });
+    CHECK_TRUE(hops.get() == 31);
+
+    std::vector<std::pair<GRAPH_TEMPTYPE, GRAPH_TEMPTYPE>> pairs;
+    for(GRAPH_TEMPTYPE i=0; i<100; i++) {
+        pairs.emplace_back(0, i);
+    }
+    auto lengths = executor.submitBatch(pairs, [](const graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>& s, const std::pair<GRAPH_TEMPTYPE, GRAPH_TEMPTYPE>& p) {
+        return graphthewy::HopPath<GRAPH_TEMPTYPE>(s).path(p.first, p.second).size() - 1;
+    }, 8);
+    CHECK_TRUE(lengths.size() == 100);
+    for(GRAPH_TEMPTYPE i=0; i<100; i++) {
+        CHECK_TRUE(lengths[i].get() == static_cast<std::size_t>(std::min(i, 100 - i)));
+    }
+
+    // Tasks submitted from a query, and exceptions
+    std::vector<std::future<std::size_t>> nested(10);
+    executor.submit([&](const graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>&) {
+        for(std::size_t i=0; i<nested.size(); i++) {
+            nested[i] = executor.submit([i](const graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>& s) { return s.degree(i); });
+        }
+    }).get();
+    for(auto& f : nested) {
+        CHECK_TRUE(f.get() == 2);
+    }
+    auto failing = executor.submit([](const graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>& s) { return s.idOf(1000); });
+    CHECK_THROWS(std::out_of_range, failing.get());
+}
+
+
+TEST(Test_UnDirected_Int, randomWalks) {
+    GRAPH_CREATE(g)
+    std::vector<std::pair<GRAPH_TEMPTYPE, GRAPH_TEMPTYPE>> ring;
+    for(GRAPH_TEMPTYPE i=0; i<50; i++) {
+        ring.emplace_back(i, (i + 1) % 50);
+    }
+    g.addEdgeList(ring);
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::RandomWalker<GRAPH_TEMPTYPE> walker(snapshot, 42);
+    const std::vector<graphthewy::VertexId> walks = walker.walk(4, 20, 3);
+    CHECK_TRUE(walks.size() == walker.walkCount(4) * 20);
+    CHECK_TRUE(walker.walkCount(4) == 200);
+    for(std::size_t w=0; w<200; w++) {
+        CHECK_TRUE(walks[w * 20] == w % 50);
+        for(std::size_t s=1; s<20; s++) {
+            const graphthewy::VertexId a = walks[w * 20 + s - 1];
+            const graphthewy::VertexId b = walks[w * 20 + s];
+            CHECK_TRUE((a + 1) % 50 == b || (b + 1) % 50 == a);
+        }
+    }
+    // The same walks whatever the number of threads
+    CHECK_TRUE(walker.walk(4, 20, 1) == walks);
+
+    // A tiny p makes the walks go back and forth
+    walker.setBias(0.001, 1.0);
+    const std::vector<graphthewy::VertexId> back = walker.walk(4, 20, 2);
+    std::size_t returns = 0;
+    for(std::size_t w=0; w<200; w++) {
+        for(std::size_t s=2; s<20; s++) {
+            returns += back[w * 20 + s]==back[w * 20 + s - 2] ? 1 : 0;
+        }
+    }
+    CHECK_TRUE(returns > 200 * 18 * 95 / 100);
+    CHECK_THROWS(std::runtime_error, walker.setBias(0.0, 1.0));
+
+    // Weighted choices follow the alias tables
+    graphthewy::UndirectedGraph<GRAPH_TEMPTYPE, int> h;
+    h.addEdgeList({{0, 1, 1}, {0, 2, 3}, {0, 3, 0}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE, int> weighted(h);
+    graphthewy::RandomWalker<GRAPH_TEMPTYPE, int> weightedWalker(weighted, 7);
+    const std::vector<graphthewy::VertexId> steps = weightedWalker.walk(4000, 2);
+    std::vector<std::size_t> hits(4, 0);
+    for(std::size_t w=0; w<steps.size() / 2; w++) {
+        if( steps[2 * w]==weighted.idOf(0) ) {
+            hits[steps[2 * w + 1]]++;
+        }
+    }
+    CHECK_TRUE(hits[weighted.idOf(3)] == 0);
+    CHECK_TRUE(hits[weighted.idOf(1)] + hits[weighted.idOf(2)] == 4000);
+    CHECK_TRUE(hits[weighted.idOf(2)] > 2800 && hits[weighted.idOf(2)] < 3200);
+}
+
+
+TEST(Test_UnDirected_Int, centrality) {
+    GRAPH_CREATE(g)
+    g.addEdgeList({{1, 2}, {2, 3}, {3, 4}, {4, 5}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> snapshot(g);
+    graphthewy::GraphCentrality<GRAPH_TEMPTYPE> centrality(snapshot, 2);
+    centrality.betweenness();
+    CHECK_TRUE(centrality.scoreVector() == std::vector<double>({0, 3, 4, 3, 0}));
+    centrality.betweenness(true);
+    DOUBLES_EQUAL(0.5, centrality.score(2), 1e-12);
+    DOUBLES_EQUAL(0.0, centrality.errorBound(), 1e-12);
+    centrality.closeness();
+    DOUBLES_EQUAL(4.0 / 6.0, centrality.score(3), 1e-12);
+    DOUBLES_EQUAL(0.4, centrality.score(1), 1e-12);
+    centrality.harmonic();
+    DOUBLES_EQUAL(3.0, centrality.score(3), 1e-12);
+    DOUBLES_EQUAL(1.0 + 1.0 / 2 + 1.0 / 3 + 1.0 / 4, centrality.score(5), 1e-12);
+
+    // Shortest paths split between two routes
+    GRAPH_CREATE(square)
+    square.addEdgeList({{1, 2}, {2, 4}, {1, 3}, {3, 4}});
+    graphthewy::GraphSnapshot<GRAPH_TEMPTYPE> squareSnapshot(square);
+    graphthewy::GraphCentrality<GRAPH_TEMPTYPE> squareCentrality(squareSnapshot);
+    squareCentrality.betweenness();
+    CHECK_TRUE(squareCentrality.scoreVector() == std::vector<double>({0.5, 0.5, 0.5, 0.5}));
+
+    // Sampling stays within its bound
+    graphthewy::GraphGenerator<GRAPH_TEMPTYPE> generator(5);
+    const auto grid = graphthewy::GraphSnapshot<GRAPH_TEMPTYPE>::fromEdgeList(generator.grid(12, 12), false);
+    graphthewy::GraphCentrality<GRAPH_TEMPTYPE> gridCentrality(grid, 3);
+    gridCentrality.betweenness(true);
+    const std::vector<double> exact = gridCentrality.scoreVector();
+    gridCentrality.approximateBetweenness(100, 1, true);
+    const double bound = gridCentrality.errorBound();
+    CHECK_TRUE(bound > 0.0 && bound < 1.0);
+    for(std::size_t v=0; v<exact.size(); v++) {
+        CHECK_TRUE(std::fabs(gridCentrality.scoreVector()[v] - exact[v]) <= bound);
+    }
+    CHECK_TRUE(gridCentrality.sampleCountFor(bound) <= 101);
+    gridCentrality.approximateBetweenness(1000, 1, true);
+    for(std::size_t v=0; v<exact.size(); v++) {
+        DOUBLES_EQUAL(exact[v], gridCentrality.scoreVector()[v], 1e-12);
+    }
+}
+
+
 int main(int argc, char** arvg)
 {
    return CommandLineTestRunner::RunAllTests(argc, arvg);
@@ -10,6 +10,7 @@
 
 #include "../src/include/GraphthewyModel.hpp"
 #include "../src/include/GraphthewyCycle.hpp"
+#include "../src/include/GraphthewyParser.hpp"
 
 #include <string>
 #include <CppUTest/TestHarness.h>
@@ -121,6 +122,24 @@ TEST(Test_UnDirected_String, graphCopy) {
 }
 
 
+TEST(Test_UnDirected_String, parseEdgeList) {
+    graphthewy::GraphParser<GRAPH_TEMPTYPE> parser(graphthewy::GraphFormat::EdgeList);
+    GRAPH_CREATE(g)
+    g.addEdgeList(parser.parseString("a b\r\nb c\r\n"));
+    CHECK_TRUE(g.order() == 3);
+    CHECK_TRUE(g.isLinked("c", "b") == true);
+}
+
+
+TEST(Test_UnDirected_String, memoryUsage) {
+    GRAPH_CREATE(g)
+    g.addVertex("a");
+    CHECK_TRUE(g.memoryUsage().labels_ == 0);
+    g.addVertex(std::string(100, 'b'));
+    CHECK_TRUE(g.memoryUsage().labels_ >= 2 * 101);
+}
+
+
 int main(int argc, char** arvg)
 {
    return CommandLineTestRunner::RunAllTests(argc, arvg);